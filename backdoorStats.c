@@ -0,0 +1,131 @@
+/**
+ * Analyses a file of puzzles, one 81 char puzzle per line, and prints one
+ * line per puzzle with its backdoor (findBackdoor) and the branching profile
+ * of the solver on it (branchProfile), or "invalid" / "unsolvable":
+ *
+ *     size cells nodes guesses depth widths
+ *
+ * `size` is the number of cells in the smallest backdoor, or ">k" if it has
+ * more than the most searched, and `cells` those cells as r1c2,r5c7 (or "-"
+ * if there are none). `nodes`, `guesses` and `depth` are the cells branched
+ * on, the values tried and the deepest node of the search, and `widths` is
+ * the number of nodes that branched on 2, 3, ... 9 candidates, separated by
+ * slashes.
+ *
+ * -k sets the largest backdoor searched for (3 by default; each size up
+ * costs about the number of empty cells times more on the puzzles that get
+ * that far) and -t the number of threads each size is searched over (one
+ * per processor by default).
+ *
+ * Usage: ./backdoorStats [-k most] [-t threads] < puzzles.txt > stats.txt
+ *
+ * Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The buffers could not be allocated
+ * 3 - A backdoor search could not be allocated or its threads started
+ */
+#include <unistd.h>
+#include "./batchIo.h"
+#include "./sudokuBackdoor.h"
+
+#define DEFAULT_MOST 3 //Default largest backdoor searched for
+
+//function prototypes
+static void analyseBoards(const uint8_t *boards, const bool *malformed,
+                          size_t count, int most, int threads);
+
+int main(const int argc, const char *argv[])
+{
+    long most = DEFAULT_MOST;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    bool good = true;
+    for(int i = 1; i < argc && good; i++){
+        char *end = "bad";
+        if(i + 1 < argc && strcmp(argv[i], "-k") == 0){
+            most = strtol(argv[++i], &end, 10);
+            if(most < 0 || most > BACKDOOR_MAX_SIZE){
+                end = "bad";
+            }
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-t") == 0){
+            threads = strtol(argv[++i], &end, 10);
+            if(threads < 1 || threads > BACKDOOR_MAX_THREADS){
+                end = "bad";
+            }
+        }
+        good = *end == '\0';
+    }
+    if(!good){
+        fprintf(stderr, "usage: %s [-k most] [-t threads] < puzzles\n",
+                argv[0]);
+        exit(1);
+    }
+    if(threads < 1){ //sysconf failed
+        threads = 1;
+    }
+    else if(threads > BACKDOOR_MAX_THREADS){
+        threads = BACKDOOR_MAX_THREADS;
+    }
+
+    BatchReader *reader = initBatchReader(stdin);
+    if(reader == NULL){
+        fprintf(stderr, "Unable to allocate the batch buffers\n");
+        exit(2);
+    }
+
+    const uint8_t *boards;
+    const bool *malformed;
+    size_t count;
+    while((count = readBatch(reader, &boards, &malformed)) > 0){
+        analyseBoards(boards, malformed, count, most, threads);
+    }
+    deleteBatchReader(reader);
+    return 0;
+}
+
+/**
+ * Analyses `count` parsed boards and prints the line of each.
+ */
+static void analyseBoards(const uint8_t *boards, const bool *malformed,
+                          size_t count, int most, int threads)
+{
+    for(size_t i = 0; i < count; i++){
+        const uint8_t *board = boards + i * NUMCELLS;
+        Backdoor backdoor;
+        BranchProfile profile;
+        if(malformed[i] || !checkValues(board)){
+            printf("invalid\n");
+            continue;
+        }
+        int found = findBackdoor(board, most, threads, &backdoor);
+        if(found < 0){
+            fflush(stdout);
+            fprintf(stderr, "The backdoor search could not be started\n");
+            exit(3);
+        }
+        if(found == 0 || !branchProfile(board, &profile)){
+            printf("unsolvable\n");
+            continue;
+        }
+
+        if(backdoor.size < 0){
+            printf(">%d -", most);
+        }
+        else{
+            printf("%d ", backdoor.size);
+            for(int c = 0; c < backdoor.size; c++){
+                int cell = backdoor.cells[c];
+                printf("%sr%dc%d", c == 0 ? "" : ",",
+                       cell / BOARDSIZE + 1, cell % BOARDSIZE + 1);
+            }
+            if(backdoor.size == 0){
+                putchar('-');
+            }
+        }
+        printf(" %lu %lu %d ", profile.nodes, profile.guesses,
+               profile.maxDepth);
+        for(int w = 2; w <= BOARDSIZE; w++){
+            printf("%lu%c", profile.widths[w], w < BOARDSIZE ? '/' : '\n');
+        }
+    }
+}
@@ -0,0 +1,322 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements fast reading and writing of puzzle files for batch solving. The
+ * common case of an 81 char line followed by '\n' is parsed straight from the
+ * buffer; anything else goes through a slower path that finds the newline
+ * and checks the length of the line.
+ *
+ * A reader keeps the unparsed end of its block at the front of the buffer
+ * and only reads more once parseRecords has nothing whole left to give, so
+ * at the end of the file it keeps returning boards until the buffer is
+ * empty.
+ */
+#include "./batchIo.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+struct batchReader{
+    FILE *in;
+    char *buf;
+    size_t have;         //Bytes of buf not parsed yet
+    bool atEnd;          //Everything in the file has been read into buf
+    bool skipping;       //Throwing away a line too long for the buffer
+    uint8_t *boards;
+    bool *malformed;
+};
+
+/********* function prototypes *********/
+
+size_t parseRecords(const char *buf, size_t len, bool atEnd, uint8_t *boards,
+                    bool *malformed, size_t maxBoards, size_t *consumed);
+size_t formatRecords(char *out, size_t cap, const uint8_t *puzzles,
+                     const uint8_t *solutions, const uint8_t *status,
+                     size_t count, bool csv, size_t *written);
+BatchReader *initBatchReader(FILE *in);
+size_t readBatch(BatchReader *reader, const uint8_t **boards,
+                 const bool **malformed);
+void deleteBatchReader(BatchReader *reader);
+static bool parseCells(const char *rec, uint8_t *board);
+static bool parseCellsScalar(const char *rec, uint8_t *board, int from);
+static char *formatCells(char *out, const uint8_t *board);
+
+/**
+ * Parses the lines in the first `len` bytes of `buf` into consecutive boards
+ * of NUMCELLS values each, stopping after `maxBoards` boards. For every board
+ * `malformed` records whether its line was not a valid puzzle, in which case
+ * the board is all zeros.
+ *
+ * A last line without a newline is only parsed if `atEnd` is true, otherwise
+ * it is left for the next call. The number of bytes used is written to
+ * `consumed` so the caller can carry the rest over to the next block.
+ *
+ * Returns the number of boards written.
+ */
+size_t parseRecords(const char *buf, size_t len, bool atEnd, uint8_t *boards,
+                    bool *malformed, size_t maxBoards, size_t *consumed)
+{
+    size_t pos = 0;
+    size_t count = 0;
+    if(buf == NULL || boards == NULL || malformed == NULL){
+        if(consumed != NULL){
+            *consumed = 0;
+        }
+        return 0;
+    }
+
+    while(count < maxBoards && pos < len){
+        const char *rec = buf + pos;
+        uint8_t *board = boards + count * NUMCELLS;
+        size_t left = len - pos;
+
+        //Fixed width record, as long as no shorter line ends inside it
+        if(left >= RECORDLEN && rec[NUMCELLS] == '\n' &&
+           memchr(rec, '\n', NUMCELLS) == NULL){
+            malformed[count++] = !parseCells(rec, board);
+            pos += RECORDLEN;
+            continue;
+        }
+
+        const char *newline = memchr(rec, '\n', left);
+        if(newline == NULL && !atEnd){
+            break; //The rest of this line is in the next block
+        }
+        size_t lineLen = newline != NULL ? (size_t)(newline - rec) : left;
+        pos += newline != NULL ? lineLen + 1 : lineLen;
+        if(lineLen > 0 && rec[lineLen - 1] == '\r'){
+            lineLen--;
+        }
+        if(lineLen == NUMCELLS){
+            malformed[count++] = !parseCells(rec, board);
+        }
+        else{
+            memset(board, 0, NUMCELLS);
+            malformed[count++] = true;
+        }
+    }
+
+    if(consumed != NULL){
+        *consumed = pos;
+    }
+    return count;
+}
+
+/**
+ * Formats up to `count` answers into `out`, one line each, without writing
+ * more than `cap` bytes. `puzzles` and `solutions` hold NUMCELLS values per
+ * board and `status` holds a BatchStatus per board. If `csv` is true each
+ * line is "puzzle,solution", otherwise just the solution. `puzzles` is only
+ * read for CSV output and may be NULL otherwise.
+ *
+ * The number of bytes used is written to `written`. Returns the number of
+ * records formatted, which is less than `count` if `out` filled up (a record
+ * never takes more than MAXOUTLEN bytes).
+ */
+size_t formatRecords(char *out, size_t cap, const uint8_t *puzzles,
+                     const uint8_t *solutions, const uint8_t *status,
+                     size_t count, bool csv, size_t *written)
+{
+    static const char *failures[] = {"", "unsolvable", "invalid"};
+    char *end = out;
+    size_t done = 0;
+    if(out == NULL || solutions == NULL || status == NULL ||
+       (csv && puzzles == NULL)){
+        count = 0;
+    }
+
+    for(; done < count && (size_t)(end - out) + MAXOUTLEN <= cap; done++){
+        if(csv){
+            end = formatCells(end, puzzles + done * NUMCELLS);
+            *end++ = ',';
+        }
+        if(status[done] == BATCH_SOLVED){
+            end = formatCells(end, solutions + done * NUMCELLS);
+        }
+        else{
+            const char *failure = failures[status[done] <= BATCH_INVALID ?
+                                           status[done] : BATCH_INVALID];
+            size_t len = strlen(failure);
+            memcpy(end, failure, len);
+            end += len;
+        }
+        *end++ = '\n';
+    }
+
+    if(written != NULL){
+        *written = end - out;
+    }
+    return done;
+}
+
+/**
+ * Makes a reader for the puzzle file `in`. Returns NULL if `in` is NULL or
+ * the buffers could not be allocated. The reader must be freed with
+ * deleteBatchReader, which does not close `in`.
+ */
+BatchReader *initBatchReader(FILE *in)
+{
+    if(in == NULL){
+        return NULL;
+    }
+    BatchReader *reader = calloc(1, sizeof(BatchReader));
+    if(reader == NULL){
+        return NULL;
+    }
+    reader->in = in;
+    reader->buf = malloc(BLOCKSIZE);
+    reader->boards = malloc(MAXBOARDS * NUMCELLS);
+    reader->malformed = malloc(MAXBOARDS * sizeof(bool));
+    if(reader->buf == NULL || reader->boards == NULL ||
+       reader->malformed == NULL){
+        deleteBatchReader(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+/**
+ * Parses the next boards of the reader's file, at most MAXBOARDS of them,
+ * and points `boards` and `malformed` at them as parseRecords fills them in.
+ * They stay valid until the next call. Returns the number of boards, which
+ * is 0 only once every line of the file has been returned.
+ */
+size_t readBatch(BatchReader *reader, const uint8_t **boards,
+                 const bool **malformed)
+{
+    if(reader == NULL || boards == NULL || malformed == NULL){
+        return 0;
+    }
+    *boards = reader->boards;
+    *malformed = reader->malformed;
+    char *buf = reader->buf;
+    while(true){
+        size_t start = 0;
+        if(reader->skipping){
+            char *newline = memchr(buf, '\n', reader->have);
+            if(newline != NULL){
+                start = newline - buf + 1;
+                reader->skipping = false;
+            }
+            else{
+                start = reader->have;
+            }
+        }
+
+        size_t consumed;
+        size_t count = parseRecords(buf + start, reader->have - start,
+                                    reader->atEnd, reader->boards,
+                                    reader->malformed, MAXBOARDS, &consumed);
+        consumed += start;
+        if(count == 0 && consumed == 0 && reader->have == BLOCKSIZE){
+            //A single line fills the whole buffer so it can't be a puzzle
+            memset(reader->boards, 0, NUMCELLS);
+            reader->malformed[0] = true;
+            reader->skipping = true;
+            count = 1;
+            consumed = reader->have;
+        }
+        memmove(buf, buf + consumed, reader->have - consumed);
+        reader->have -= consumed;
+        if(count > 0 || reader->atEnd){
+            return count;
+        }
+
+        size_t want = BLOCKSIZE - reader->have;
+        size_t got = fread(buf + reader->have, 1, want, reader->in);
+        reader->have += got;
+        reader->atEnd = got < want; //End of the file, or an error reading it
+    }
+}
+
+/**
+ * Frees a reader made by initBatchReader.
+ */
+void deleteBatchReader(BatchReader *reader)
+{
+    if(reader == NULL){
+        return;
+    }
+    free(reader->buf);
+    free(reader->boards);
+    free(reader->malformed);
+    free(reader);
+}
+
+/**
+ * Converts the 81 chars at `rec` into cell values. Returns false (and zeros
+ * the board) if any char is not a digit or '.'. Never reads past rec[80].
+ */
+static bool parseCells(const char *rec, uint8_t *board)
+{
+#ifdef __SSE2__
+    const __m128i zeroChar = _mm_set1_epi8('0');
+    const __m128i dotChar = _mm_set1_epi8('.');
+    const __m128i nine = _mm_set1_epi8(9);
+    int bad = 0;
+    for(int i = 0; i + 16 <= NUMCELLS; i += 16){
+        __m128i chars = _mm_loadu_si128((const __m128i *)(rec + i));
+        __m128i digits = _mm_sub_epi8(chars, zeroChar);
+        //A byte is a digit if (byte - '0') is at most 9 when unsigned
+        __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digits, nine), digits);
+        __m128i isDot = _mm_cmpeq_epi8(chars, dotChar);
+        bad |= ~_mm_movemask_epi8(_mm_or_si128(isDigit, isDot)) & 0xFFFF;
+        _mm_storeu_si128((__m128i *)(board + i),
+                         _mm_andnot_si128(isDot, digits));
+    }
+    if(bad != 0 || !parseCellsScalar(rec, board, NUMCELLS - NUMCELLS % 16)){
+        memset(board, 0, NUMCELLS);
+        return false;
+    }
+    return true;
+#else
+    if(!parseCellsScalar(rec, board, 0)){
+        memset(board, 0, NUMCELLS);
+        return false;
+    }
+    return true;
+#endif
+}
+
+/**
+ * Converts the chars of `rec` from index `from` up to the end of the record
+ * one at a time. Returns false if any of them is not a digit or '.'.
+ */
+static bool parseCellsScalar(const char *rec, uint8_t *board, int from)
+{
+    for(int i = from; i < NUMCELLS; i++){
+        char c = rec[i];
+        if(c == '.'){
+            board[i] = 0;
+        }
+        else if(c >= '0' && c <= '9'){
+            board[i] = c - '0';
+        }
+        else{
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Writes the 81 values of a board to `out` as digits and returns the end of
+ * what was written.
+ */
+static char *formatCells(char *out, const uint8_t *board)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128i zeroChar = _mm_set1_epi8('0');
+    for(; i + 16 <= NUMCELLS; i += 16){
+        __m128i values = _mm_loadu_si128((const __m128i *)(board + i));
+        _mm_storeu_si128((__m128i *)(out + i), _mm_add_epi8(values, zeroChar));
+    }
+#endif
+    for(; i < NUMCELLS; i++){
+        out[i] = '0' + board[i];
+    }
+    return out + NUMCELLS;
+}
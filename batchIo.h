@@ -0,0 +1,110 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements fast reading and writing of puzzle files for batch solving. A
+ * puzzle file holds one puzzle per line as 81 chars, where a digit 1 - 9 is a
+ * clue and '0' or '.' is an empty cell, so almost every record is exactly 82
+ * bytes (81 cells and a newline, or 83 with a "\r\n" ending).
+ *
+ * parseRecords turns a block of such a file into boards of 81 cell values
+ * (0 for an empty cell). When SSE2 is available each record is converted 16
+ * cells at a time: '0' is subtracted from every byte, the bytes that are not
+ * between 0 and 9 (and were not a '.') are flagged as malformed with one
+ * compare, and the '.' bytes are masked down to 0. Lines that are not 81
+ * chars long are not rejected silently, they produce a malformed board so
+ * that board i always belongs to line i of the input.
+ *
+ * A BatchReader runs parseRecords over a whole stream: it reads BLOCKSIZE
+ * bytes at a time, carries a line cut off by the end of a block over to the
+ * next one and hands the boards back at most MAXBOARDS at a time. A line too
+ * long to fit in the block is thrown away and gives a single malformed board.
+ *
+ * formatRecords goes the other way, writing solutions straight into a large
+ * output buffer (16 cells at a time with SSE2 by adding '0' to each byte)
+ * instead of printing them cell by cell. Each record is either the solution
+ * alone or "puzzle,solution" for CSV output, and a puzzle that was not
+ * solved gets "invalid" or "unsolvable" in place of its solution.
+ */
+#ifndef BATCH_IO_H
+#define BATCH_IO_H
+
+#include "./sudokuSolver.h"
+
+#define RECORDLEN (NUMCELLS + 1) //One puzzle and its newline
+#define MAXOUTLEN (2 * NUMCELLS + 2) //Longest formatted record (CSV)
+#define BLOCKSIZE (1 << 20) //Bytes of input read at a time
+#define MAXBOARDS (BLOCKSIZE / RECORDLEN + 1) //Most boards from one block
+
+typedef enum batchStatus{
+    BATCH_SOLVED = 0,
+    BATCH_UNSOLVABLE, //The puzzle is legal but has no solution
+    BATCH_INVALID     //The line was malformed or the puzzle is not legal
+}BatchStatus;
+
+typedef struct batchReader BatchReader;
+
+/********* function prototypes *********/
+
+size_t parseRecords(const char *buf, size_t len, bool atEnd, uint8_t *boards,
+                    bool *malformed, size_t maxBoards, size_t *consumed);
+size_t formatRecords(char *out, size_t cap, const uint8_t *puzzles,
+                     const uint8_t *solutions, const uint8_t *status,
+                     size_t count, bool csv, size_t *written);
+BatchReader *initBatchReader(FILE *in);
+size_t readBatch(BatchReader *reader, const uint8_t **boards,
+                 const bool **malformed);
+void deleteBatchReader(BatchReader *reader);
+
+/**
+ * Parses the lines in the first `len` bytes of `buf` into consecutive boards
+ * of NUMCELLS values each, stopping after `maxBoards` boards. For every board
+ * `malformed` records whether its line was not a valid puzzle, in which case
+ * the board is all zeros.
+ *
+ * A last line without a newline is only parsed if `atEnd` is true, otherwise
+ * it is left for the next call. The number of bytes used is written to
+ * `consumed` so the caller can carry the rest over to the next block.
+ *
+ * Returns the number of boards written.
+ */
+size_t parseRecords(const char *buf, size_t len, bool atEnd, uint8_t *boards,
+                    bool *malformed, size_t maxBoards, size_t *consumed);
+
+/**
+ * Formats up to `count` answers into `out`, one line each, without writing
+ * more than `cap` bytes. `puzzles` and `solutions` hold NUMCELLS values per
+ * board and `status` holds a BatchStatus per board. If `csv` is true each
+ * line is "puzzle,solution", otherwise just the solution. `puzzles` is only
+ * read for CSV output and may be NULL otherwise.
+ *
+ * The number of bytes used is written to `written`. Returns the number of
+ * records formatted, which is less than `count` if `out` filled up (a record
+ * never takes more than MAXOUTLEN bytes).
+ */
+size_t formatRecords(char *out, size_t cap, const uint8_t *puzzles,
+                     const uint8_t *solutions, const uint8_t *status,
+                     size_t count, bool csv, size_t *written);
+
+/**
+ * Makes a reader for the puzzle file `in`. Returns NULL if `in` is NULL or
+ * the buffers could not be allocated. The reader must be freed with
+ * deleteBatchReader, which does not close `in`.
+ */
+BatchReader *initBatchReader(FILE *in);
+
+/**
+ * Parses the next boards of the reader's file, at most MAXBOARDS of them,
+ * and points `boards` and `malformed` at them as parseRecords fills them in.
+ * They stay valid until the next call. Returns the number of boards, which
+ * is 0 only once every line of the file has been returned.
+ */
+size_t readBatch(BatchReader *reader, const uint8_t **boards,
+                 const bool **malformed);
+
+/**
+ * Frees a reader made by initBatchReader.
+ */
+void deleteBatchReader(BatchReader *reader);
+
+#endif
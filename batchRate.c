@@ -0,0 +1,71 @@
+/**
+ * Rates a file of puzzles, one 81 char puzzle per line, on the Sudoku
+ * Explainer scale and prints one line per puzzle: the rating and the hardest
+ * technique needed, or "invalid". A puzzle the technique ladder gets stuck
+ * on is printed as "beyond ladder" with no rating, since it needs a
+ * technique the ladder does not have and SE could rate it anywhere from 4.5
+ * up.
+ *
+ * Every puzzle first goes through the classifySingles pre-filter, so only
+ * the puzzles that need more than singles are graded step by step. A puzzle
+ * without exactly one solution is printed as "invalid" rather than graded.
+ *
+ * Usage: ./batchRate < puzzles.txt > ratings.txt
+ *
+ * Exit statuses are as follows
+ * 1 - Improper amount of arguments
+ * 2 - The buffers could not be allocated
+ */
+#include "./batchIo.h"
+#include "./sudokuRater.h"
+
+//function prototypes
+static void rateBoards(const uint8_t *boards, const bool *malformed,
+                       size_t count);
+
+int main(const int argc, const char *argv[])
+{
+    if(argc != 1){
+        fprintf(stderr, "usage: %s < puzzles\n", argv[0]);
+        exit(1);
+    }
+    BatchReader *reader = initBatchReader(stdin);
+    if(reader == NULL){
+        fprintf(stderr, "Unable to allocate the batch buffers\n");
+        exit(2);
+    }
+
+    const uint8_t *boards;
+    const bool *malformed;
+    size_t count;
+    while((count = readBatch(reader, &boards, &malformed)) > 0){
+        rateBoards(boards, malformed, count);
+    }
+    deleteBatchReader(reader);
+    return 0;
+}
+
+/**
+ * Rates `count` parsed boards and prints the rating of each.
+ */
+static void rateBoards(const uint8_t *boards, const bool *malformed,
+                       size_t count)
+{
+    Rating rating;
+    for(size_t i = 0; i < count; i++){
+        const uint8_t *board = boards + i * NUMCELLS;
+        SinglesResult singles = malformed[i] ? SINGLES_INVALID :
+                                classifySingles(board, &rating);
+        if(singles == SINGLES_INVALID ||
+           (singles == SINGLES_STUCK && !rateValues(board, &rating))){
+            printf("invalid\n");
+        }
+        else if(rating.solved){
+            printf("%d.%d %s\n", rating.score / 10, rating.score % 10,
+                   techniqueName(rating.hardest));
+        }
+        else{
+            printf("beyond ladder\n");
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/**
+ * Solves a file of puzzles, one 81 char puzzle per line, and prints one line
+ * per puzzle: the solution, or "invalid" / "unsolvable". With -c each line is
+ * instead "puzzle,solution" (a malformed line shows up as a puzzle of all
+ * zeros). Input is read in large blocks and parsed by a BatchReader, and the
+ * answers are formatted with formatRecords into a large output buffer that is
+ * written with fwrite, so neither reading nor writing holds the solver back.
+ * Each puzzle is solved by the engine ENGINE_AUTO picks for it, under the
+ * thresholds in the engine config file if there is one.
+ *
+ * With -m each line is instead a mid-game state in the 729 char candidate
+ * format, which is solved with solveCandidates from the candidates as given.
+ * Those lines are read one at a time with fgets since they are few and far
+ * between next to the batches of plain puzzles.
+ *
+ * With -p every puzzle is solved with solvePlanned instead of the engines,
+ * through a plan for its clue pattern that is only built again when a puzzle
+ * has a different pattern from the one before it. That is for files from
+ * the generator where long runs of puzzles share one pattern; on puzzles
+ * that all have different patterns it is slower than the engines since each
+ * one pays for building its own plan.
+ *
+ * Usage: ./batchSolve [-c | -m | -p] < puzzles.txt > solutions.txt
+ *
+ * Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The buffers could not be allocated
+ * 3 - The output could not be written
+ * 4 - The engine config could not be loaded
+ */
+#include "./batchIo.h"
+#include "./sudokuEngine.h"
+#include "./sudokuPlan.h"
+
+#define OUTSIZE (1 << 22)   //Bytes of output buffered before writing
+#define MARKSLEN (NUMCELLS * BOARDSIZE) //Chars of a candidate format line
+
+//function prototypes
+static void solveBoards(const uint8_t *boards, const bool *malformed,
+                        uint8_t *solutions, uint8_t *status, size_t count);
+static void writeAnswers(const uint8_t *boards, const uint8_t *solutions,
+                         const uint8_t *status, size_t count, bool csv);
+static void flushOutput(void);
+static void solveMarkLines(void);
+
+static char *out;       //Formatted answers not yet written
+static size_t outLen;
+static bool planned;    //Solving through plans rather than the engines
+static CluePlan plan;   //Plan for the clue pattern of the last puzzle
+static bool havePlan;
+
+int main(const int argc, const char *argv[])
+{
+    bool csv = argc == 2 && strcmp(argv[1], "-c") == 0;
+    bool marks = argc == 2 && strcmp(argv[1], "-m") == 0;
+    planned = argc == 2 && strcmp(argv[1], "-p") == 0;
+    if(argc > 2 || (argc == 2 && !csv && !marks && !planned)){
+        fprintf(stderr, "usage: %s [-c | -m | -p] < puzzles\n", argv[0]);
+        exit(1);
+    }
+    if(!loadStartupTuning()){
+        exit(4);
+    }
+    if(marks){
+        out = malloc(OUTSIZE);
+        if(out == NULL){
+            fprintf(stderr, "Unable to allocate the batch buffers\n");
+            exit(2);
+        }
+        solveMarkLines();
+        flushOutput();
+        free(out);
+        return 0;
+    }
+    BatchReader *reader = initBatchReader(stdin);
+    uint8_t *solutions = malloc(MAXBOARDS * NUMCELLS);
+    uint8_t *status = malloc(MAXBOARDS);
+    out = malloc(OUTSIZE);
+    if(reader == NULL || solutions == NULL || status == NULL || out == NULL){
+        fprintf(stderr, "Unable to allocate the batch buffers\n");
+        exit(2);
+    }
+
+    const uint8_t *boards;
+    const bool *malformed;
+    size_t count;
+    while((count = readBatch(reader, &boards, &malformed)) > 0){
+        solveBoards(boards, malformed, solutions, status, count);
+        writeAnswers(boards, solutions, status, count, csv);
+    }
+    flushOutput();
+
+    deleteBatchReader(reader);
+    free(solutions);
+    free(status);
+    free(out);
+    return 0;
+}
+
+/**
+ * Solves `count` parsed boards, writing each solution to `solutions` and the
+ * BatchStatus of each board to `status`. In planned mode the plan is built
+ * again whenever a board's clue pattern differs from the plan's.
+ */
+static void solveBoards(const uint8_t *boards, const bool *malformed,
+                        uint8_t *solutions, uint8_t *status, size_t count)
+{
+    for(size_t i = 0; i < count; i++){
+        const uint8_t *board = boards + i * NUMCELLS;
+        uint8_t *solution = solutions + i * NUMCELLS;
+        if(malformed[i]){
+            status[i] = BATCH_INVALID;
+            continue;
+        }
+        if(planned && (!havePlan || !planMatches(&plan, board))){
+            havePlan = buildPlan(board, &plan);
+        }
+        if(planned ? solvePlanned(&plan, board, solution, NULL) :
+           solveWith(board, solution, ENGINE_AUTO, NULL)){
+            status[i] = BATCH_SOLVED;
+        }
+        else{
+            status[i] = checkValues(board) ? BATCH_UNSOLVABLE : BATCH_INVALID;
+        }
+    }
+}
+
+/**
+ * Formats the answers to `count` boards into the output buffer, writing the
+ * buffer out whenever it fills up.
+ */
+static void writeAnswers(const uint8_t *boards, const uint8_t *solutions,
+                         const uint8_t *status, size_t count, bool csv)
+{
+    size_t done = 0;
+    while(done < count){
+        size_t written;
+        done += formatRecords(out + outLen, OUTSIZE - outLen,
+                              boards + done * NUMCELLS,
+                              solutions + done * NUMCELLS, status + done,
+                              count - done, csv, &written);
+        outLen += written;
+        if(done < count){
+            flushOutput();
+        }
+    }
+}
+
+/**
+ * Solves every line of stdin as a board in the candidate format and writes
+ * one answer per line like the plain batches. A line that is not 729 chars
+ * of candidates (or is too long to read) is answered "invalid".
+ */
+static void solveMarkLines(void)
+{
+    char line[MARKSLEN + 3]; //The line, "\r\n" and the terminator
+    while(fgets(line, sizeof(line), stdin) != NULL){
+        size_t len = strlen(line);
+        bool whole = len > 0 && line[len - 1] == '\n';
+        if(!whole && !feof(stdin)){ //Too long, throw away the rest of it
+            int c;
+            while((c = getchar()) != EOF && c != '\n'){
+                continue;
+            }
+            line[0] = '\0';
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+
+        uint16_t cands[NUMCELLS];
+        uint8_t solution[NUMCELLS];
+        uint8_t status = BATCH_INVALID;
+        if(parseCandidates(line, cands)){
+            status = solveCandidates(cands, solution, NULL) ?
+                     BATCH_SOLVED : BATCH_UNSOLVABLE;
+        }
+        writeAnswers(solution, solution, &status, 1, false);
+    }
+}
+
+/**
+ * Writes everything in the output buffer to stdout.
+ */
+static void flushOutput(void)
+{
+    if(outLen > 0 && fwrite(out, 1, outLen, stdout) != outLen){
+        perror("batchSolve");
+        exit(3);
+    }
+    outLen = 0;
+}
@@ -0,0 +1,179 @@
+/**
+ * Tests the batchIo module: every input built here is parsed with
+ * parseRecords or read from a file with a BatchReader and must give exactly
+ * one board per line of input, with the puzzle lines among them parsed as
+ * valid boards, so that answer i of a batch always belongs to line i.
+ *
+ * Usage: ./batchTest
+ *
+ * Exit statuses are as follows
+ * 1 - A test failed (each failure is printed)
+ * 2 - The test buffers could not be allocated
+ */
+#include "./batchIo.h"
+
+#define PUZZLE "530070000600195000098000060800060003400803001700020006" \
+               "060000280000419005000080079"
+#define MAXTEXT (8 * 1024 * 1024) //Largest input built by a test
+#define MAXLINES 65536            //Most lines in an input built by a test
+
+//function prototypes
+static void testParse(const char *name, const char *text, size_t len);
+static void testReader(const char *name, const char *text, size_t len);
+static void checkBoards(const char *name, const char *text, size_t len,
+                        size_t count);
+static size_t buildText(char *text, const char *line, size_t copies);
+
+static char *input;    //Input of the current test
+static uint8_t *boards;
+static bool *malformed;
+static int failures;
+
+int main(void)
+{
+    input = malloc(MAXTEXT);
+    boards = malloc(MAXLINES * NUMCELLS);
+    malformed = malloc(MAXLINES * sizeof(bool));
+    if(input == NULL || boards == NULL || malformed == NULL){
+        fprintf(stderr, "Unable to allocate the test buffers\n");
+        exit(2);
+    }
+
+    //Blank lines must not be taken as part of an 82 byte record
+    size_t len = buildText(input, "", 30000);
+    len += buildText(input + len, PUZZLE, 1);
+    testParse("blank lines", input, len);
+
+    //A short line whose next line happens to end 82 bytes further on
+    len = buildText(input, "123", 1);
+    len += buildText(input + len, "0000000000000000000000000000000000000"
+                     "0000000000000000000000000000000000000000", 1);
+    len += buildText(input + len, PUZZLE, 1);
+    testParse("short lines", input, len);
+
+    len = buildText(input, PUZZLE "\r", 3);
+    len += buildText(input + len, "", 2);
+    memcpy(input + len, PUZZLE, NUMCELLS); //No newline on the last line
+    testParse("line endings", input, len + NUMCELLS);
+    testReader("line endings", input, len + NUMCELLS);
+
+    //More lines than one batch holds, all still in the buffer at the end
+    len = buildText(input, "012345678901234567890123456789", 45825);
+    len += buildText(input + len, PUZZLE, 1);
+    testReader("short lines at the end", input, len);
+
+    //A line longer than the whole read buffer
+    memset(input, '1', BLOCKSIZE + 10);
+    len = BLOCKSIZE + 10 + buildText(input + BLOCKSIZE + 10, "", 1);
+    len += buildText(input + len, PUZZLE, 2);
+    testReader("long line", input, len);
+
+    free(input);
+    free(boards);
+    free(malformed);
+    if(failures > 0){
+        exit(1);
+    }
+    printf("All batch tests passed\n");
+    return 0;
+}
+
+/**
+ * Parses `len` bytes of `text` in one call and checks the boards it gives.
+ */
+static void testParse(const char *name, const char *text, size_t len)
+{
+    size_t consumed;
+    size_t count = parseRecords(text, len, true, boards, malformed,
+                                MAXLINES, &consumed);
+    if(consumed != len){
+        printf("%s: only %zu of %zu bytes were parsed\n", name, consumed,
+               len);
+        failures++;
+        return;
+    }
+    checkBoards(name, text, len, count);
+}
+
+/**
+ * Writes `len` bytes of `text` to a temporary file, reads it back with a
+ * BatchReader and checks the boards it gives.
+ */
+static void testReader(const char *name, const char *text, size_t len)
+{
+    FILE *file = tmpfile();
+    BatchReader *reader = NULL;
+    if(file == NULL || fwrite(text, 1, len, file) != len ||
+       fseek(file, 0, SEEK_SET) != 0 ||
+       (reader = initBatchReader(file)) == NULL){
+        printf("%s: the test file could not be made\n", name);
+        failures++;
+        if(file != NULL){
+            fclose(file);
+        }
+        return;
+    }
+
+    const uint8_t *batch;
+    const bool *batchMalformed;
+    size_t got;
+    size_t count = 0;
+    while((got = readBatch(reader, &batch, &batchMalformed)) > 0){
+        for(size_t i = 0; i < got && count < MAXLINES; i++){
+            malformed[count++] = batchMalformed[i];
+        }
+    }
+    deleteBatchReader(reader);
+    fclose(file);
+    checkBoards(name, text, len, count);
+}
+
+/**
+ * Checks that `count` boards came from the `len` bytes of `text`, one per
+ * line, with the malformed flag of each in `malformed` clear exactly for the
+ * lines holding PUZZLE.
+ */
+static void checkBoards(const char *name, const char *text, size_t len,
+                        size_t count)
+{
+    size_t lines = 0;
+    for(size_t i = 0; i < len; i++){
+        lines += text[i] == '\n';
+    }
+    if(len > 0 && text[len - 1] != '\n'){
+        lines++;
+    }
+    if(count != lines){
+        printf("%s: %zu lines gave %zu boards\n", name, lines, count);
+        failures++;
+        return;
+    }
+
+    const char *line = text;
+    for(size_t i = 0; i < count; i++){
+        bool puzzle = (size_t)(text + len - line) >= NUMCELLS &&
+                      strncmp(line, PUZZLE, NUMCELLS) == 0;
+        if(malformed[i] == puzzle){
+            printf("%s: line %zu should %sbe malformed\n", name, i + 1,
+                   puzzle ? "not " : "");
+            failures++;
+            return;
+        }
+        const char *newline = memchr(line, '\n', text + len - line);
+        line = newline != NULL ? newline + 1 : text + len;
+    }
+}
+
+/**
+ * Writes `copies` copies of `line`, each followed by a newline, to `text`
+ * and returns the number of bytes written.
+ */
+static size_t buildText(char *text, const char *line, size_t copies)
+{
+    size_t len = strlen(line);
+    for(size_t i = 0; i < copies; i++){
+        memcpy(text + i * (len + 1), line, len);
+        text[i * (len + 1) + len] = '\n';
+    }
+    return copies * (len + 1);
+}
@@ -0,0 +1,223 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements compact board diffs for keeping boards in sync. See boardDiff.h
+ * for the layout of a diff.
+ */
+#include "./boardDiff.h"
+
+#define MARKBITS 0x1FF //Pencil marks for the digits 1 - 9
+
+/********* function prototypes *********/
+
+size_t diffBoards(Cell **from, Cell **to, uint8_t *out, size_t cap);
+bool patchBoard(Cell **board, const uint8_t *diff, size_t len);
+static size_t writeMask(uint8_t *out, const bool *present);
+static size_t readMask(const uint8_t *in, size_t len, bool *present,
+                       int *count);
+
+/**
+ * Writes the diff that turns board `from` into board `to` to `out`, which
+ * can hold `cap` bytes (DIFF_MAXBYTES is always enough). Returns the length of
+ * the diff, or 0 if either board or `out` is NULL or the diff does not fit.
+ */
+size_t diffBoards(Cell **from, Cell **to, uint8_t *out, size_t cap)
+{
+    bool valueChanged[DIFF_CELLS];
+    bool marksChanged[DIFF_CELLS];
+    uint8_t diff[DIFF_MAXBYTES];
+    if(from == NULL || to == NULL || out == NULL){
+        return 0;
+    }
+
+    for(int i = 0; i < DIFF_CELLS; i++){
+        Cell *old = getCell(i / BOARDSIZE, i % BOARDSIZE, from);
+        Cell *new = getCell(i / BOARDSIZE, i % BOARDSIZE, to);
+        valueChanged[i] = old->value != new->value;
+        marksChanged[i] = old->marks != new->marks;
+    }
+
+    size_t len = writeMask(diff, valueChanged);
+    int packed = 0; //Values written so far
+    for(int i = 0; i < DIFF_CELLS; i++){
+        if(!valueChanged[i]){
+            continue;
+        }
+        uint8_t value = getCell(i / BOARDSIZE, i % BOARDSIZE, to)->value;
+        if(packed % 2 == 0){
+            diff[len + packed / 2] = value;
+        }
+        else{
+            diff[len + packed / 2] |= value << 4;
+        }
+        packed++;
+    }
+    len += (packed + 1) / 2;
+
+    len += writeMask(diff + len, marksChanged);
+    for(int i = 0; i < DIFF_CELLS; i++){
+        if(!marksChanged[i]){
+            continue;
+        }
+        uint16_t delta = getCell(i / BOARDSIZE, i % BOARDSIZE, from)->marks ^
+                         getCell(i / BOARDSIZE, i % BOARDSIZE, to)->marks;
+        diff[len++] = delta & 0xFF;
+        diff[len++] = delta >> 8;
+    }
+
+    if(len > cap){
+        return 0;
+    }
+    memcpy(out, diff, len);
+    return len;
+}
+
+/**
+ * Applies a diff of `len` bytes from diffBoards to the given board. Values
+ * are written with setCellVal and clearCell so the board's hash is kept up to
+ * date. The whole diff is checked before anything is changed.
+ *
+ * Returns false (and leaves the board untouched) if the board or diff is NULL
+ * or the diff is malformed: cut short, longer than its contents, or holding
+ * a value above 9 or marks outside of 1 - 9. A diff that would change the
+ * value of a clue is rejected the same way, so a peer can't rewrite the
+ * puzzle itself. A diff can only be applied to the board it was taken from,
+ * since the marks deltas are relative to it.
+ */
+bool patchBoard(Cell **board, const uint8_t *diff, size_t len)
+{
+    bool valueChanged[DIFF_CELLS];
+    bool marksChanged[DIFF_CELLS];
+    int numValues;
+    int numMarks;
+    if(board == NULL || diff == NULL){
+        return false;
+    }
+
+    size_t pos = readMask(diff, len, valueChanged, &numValues);
+    size_t values = pos; //Where the packed values start
+    if(pos == 0 || len - pos < (size_t)(numValues + 1) / 2){
+        return false;
+    }
+    for(int i = 0, k = 0; i < DIFF_CELLS; i++){
+        if(!valueChanged[i]){
+            continue;
+        }
+        int value = (diff[values + k / 2] >> (k % 2 * 4)) & 0xF;
+        Cell *cell = getCell(i / BOARDSIZE, i % BOARDSIZE, board);
+        if(value > 9 || (cell->clue && value != cell->value)){
+            return false; //Clues belong to the puzzle, not to the player
+        }
+        k++;
+    }
+    pos += (numValues + 1) / 2;
+
+    size_t used = readMask(diff + pos, len - pos, marksChanged, &numMarks);
+    if(used == 0){
+        return false;
+    }
+    pos += used;
+    size_t deltas = pos; //Where the marks deltas start
+    if(len - pos != (size_t)numMarks * 2){
+        return false;
+    }
+    for(int k = 0; k < numMarks; k++){
+        if(diff[deltas + 2 * k + 1] & ~(MARKBITS >> 8)){
+            return false;
+        }
+    }
+
+    //The diff is well formed so it can be applied
+    int k = 0;
+    for(int i = 0; i < DIFF_CELLS; i++){
+        if(!valueChanged[i]){
+            continue;
+        }
+        int value = (diff[values + k / 2] >> (k % 2 * 4)) & 0xF;
+        if(value == 0){
+            clearCell(board, i / BOARDSIZE, i % BOARDSIZE);
+        }
+        else{
+            setCellVal(board, i / BOARDSIZE, i % BOARDSIZE, value);
+        }
+        k++;
+    }
+    k = 0;
+    for(int i = 0; i < DIFF_CELLS; i++){
+        if(marksChanged[i]){
+            getCell(i / BOARDSIZE, i % BOARDSIZE, board)->marks ^=
+                diff[deltas + 2 * k] | diff[deltas + 2 * k + 1] << 8;
+            k++;
+        }
+    }
+    return true;
+}
+
+/**
+ * Writes the mask of the cells set in `present` (see boardDiff.h) and returns
+ * the number of bytes used.
+ */
+static size_t writeMask(uint8_t *out, const bool *present)
+{
+    uint8_t groups[DIFF_GROUPS] = {0};
+    uint16_t header = 0;
+    for(int i = 0; i < DIFF_CELLS; i++){
+        if(present[i]){
+            groups[i / 8] |= 1 << (i % 8);
+            header |= 1 << (i / 8);
+        }
+    }
+
+    size_t len = 2;
+    out[0] = header & 0xFF;
+    out[1] = header >> 8;
+    for(int g = 0; g < DIFF_GROUPS; g++){
+        if(header & (1 << g)){
+            out[len++] = groups[g];
+        }
+    }
+    return len;
+}
+
+/**
+ * Reads a mask from the first `len` bytes of `in` into `present` and writes
+ * the number of cells in it to `count`. Returns the number of bytes used, or
+ * 0 if the mask is cut short or names a cell past the end of the board.
+ */
+static size_t readMask(const uint8_t *in, size_t len, bool *present,
+                       int *count)
+{
+    if(len < 2){
+        return 0;
+    }
+    uint16_t header = in[0] | in[1] << 8;
+    if(header >> DIFF_GROUPS != 0){
+        return 0;
+    }
+
+    size_t pos = 2;
+    *count = 0;
+    for(int g = 0; g < DIFF_GROUPS; g++){
+        uint8_t group = 0;
+        if(header & (1 << g)){
+            if(pos == len){
+                return 0;
+            }
+            group = in[pos++];
+        }
+        for(int bit = 0; bit < 8; bit++){
+            int cell = g * 8 + bit;
+            bool set = group & (1 << bit);
+            if(cell >= DIFF_CELLS){
+                if(set){
+                    return 0;
+                }
+                continue;
+            }
+            present[cell] = set;
+            *count += set;
+        }
+    }
+    return pos;
+}
@@ -0,0 +1,61 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements compact diffs between two boards so that a client and server
+ * can keep a board in sync by sending only what a move changed. A diff holds
+ * the new value of every cell whose value changed and the change to the
+ * pencil marks of every cell whose marks changed. Whether a cell is a clue is
+ * never part of a diff since that is fixed when the board is created.
+ *
+ * A diff is laid out as
+ *
+ *  value mask | values | marks mask | marks deltas
+ *
+ * where each mask says which of the 81 cells are present. The 81 bits are
+ * split into DIFF_GROUPS bytes of 8 cells and a mask is written as a 2 byte
+ * header with a bit set for each group that has any cell in it followed by
+ * only those group bytes, so a move touching one cell costs 3 bytes of mask
+ * instead of 11. The values are packed two to a byte (low nibble first) in
+ * cell order, and each marks delta is the XOR of the old and new marks as 2
+ * bytes (low byte first). A diff of identical boards is 4 bytes, setting one
+ * value takes 6 bytes and changing the marks of one cell takes 7.
+ */
+#ifndef BOARD_DIFF_H
+#define BOARD_DIFF_H
+
+#include "./sudokuBoard.h"
+
+#define DIFF_CELLS (BOARDSIZE * BOARDSIZE)
+#define DIFF_GROUPS ((DIFF_CELLS + 7) / 8)  //Bytes in a full cell mask
+//Length of the diff between two boards that differ in every cell
+#define DIFF_MAXBYTES (2 * (2 + DIFF_GROUPS) + (DIFF_CELLS + 1) / 2 + \
+                       2 * DIFF_CELLS)
+
+/********* function prototypes *********/
+
+size_t diffBoards(Cell **from, Cell **to, uint8_t *out, size_t cap);
+bool patchBoard(Cell **board, const uint8_t *diff, size_t len);
+
+/**
+ * Writes the diff that turns board `from` into board `to` to `out`, which
+ * can hold `cap` bytes (DIFF_MAXBYTES is always enough). Returns the length of
+ * the diff, or 0 if either board or `out` is NULL or the diff does not fit.
+ */
+size_t diffBoards(Cell **from, Cell **to, uint8_t *out, size_t cap);
+
+/**
+ * Applies a diff of `len` bytes from diffBoards to the given board. Values
+ * are written with setCellVal and clearCell so the board's hash is kept up to
+ * date. The whole diff is checked before anything is changed.
+ *
+ * Returns false (and leaves the board untouched) if the board or diff is NULL
+ * or the diff is malformed: cut short, longer than its contents, or holding
+ * a value above 9 or marks outside of 1 - 9. A diff that would change the
+ * value of a clue is rejected the same way, so a peer can't rewrite the
+ * puzzle itself. A diff can only be applied to the board it was taken from,
+ * since the marks deltas are relative to it.
+ */
+bool patchBoard(Cell **board, const uint8_t *diff, size_t len);
+
+#endif
@@ -15,6 +15,9 @@ int main(const int argc, const char *argv[])
     char *clue = malloc(strlen(argv[1]) + 1);
     strcpy(clue, argv[1]);
     Cell **board = initSetBoard(clue);
+    if(board == NULL){ //The reason has already been printed
+        exit(5);
+    }
     bool stillPlaying = true;
     int row, col, val;
     while(stillPlaying){
@@ -47,6 +50,8 @@ int main(const int argc, const char *argv[])
  * 1 - Improper amount of arguments 
  * 2 - The length of the input string is incorrect
  * 3 - The input string contains non-
+ * 4 - The board could not be allocated (initSetBoard exits with it)
+ * 5 - The clues contradict each other
  */ 
 void checkInputs(const int argc, const char *argv[])
 {
@@ -0,0 +1,270 @@
+/**
+ * Fuzz target for everything that reads untrusted input: initSetBoard,
+ * parseRecords, patchBoard, the solver's string, value and candidate format
+ * entry points and the singles pre-filter. The SAT solver is run on every
+ * puzzle as well and checked against the backtracking solver: the two must
+ * agree on whether there is a solution, and the SAT solution must keep the
+ * clues and be legal, otherwise the target aborts. Besides crashes (run it
+ * under a sanitizer) it watches the solver's node counts and appends every
+ * puzzle that needs more nodes than any seen before to a "slow puzzles"
+ * file, one puzzle per line, so the worst cases found can be rerun as a
+ * benchmark with batchSolve. The file is slowPuzzles.txt unless the
+ * SLOW_PUZZLES environment variable names another one.
+ *
+ * Built with -DFUZZ_LIBFUZZER this file only provides LLVMFuzzerTestOneInput
+ * and libFuzzer supplies main, e.g.
+ *   clang -g -O1 -fsanitize=fuzzer,address -DFUZZ_LIBFUZZER fuzzSolver.c \
+ *         batchIo.c sudokuSolver.c sudokuBoard.c sudokuRater.c boardDiff.c \
+ *         sudokuSat.c
+ * Otherwise it has its own driver that runs each given file through the
+ * target and then feeds it `runs` random mutations of the puzzles in them
+ * (clues changed, added or removed).
+ *
+ * Usage: ./fuzzSolver [-n runs] [inputs...]
+ *
+ * Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - An input file could not be read
+ */
+#include "./batchIo.h"
+#include "./sudokuRater.h"
+#include "./boardDiff.h"
+#include "./sudokuSat.h"
+
+#define SLOW_FILE "slowPuzzles.txt" //Default file slow puzzles are added to
+#define SLOW_MIN_NODES 1000 //Searches smaller than this are never recorded
+#define MAXSEEDS 1024       //Puzzles kept from the inputs for mutating
+
+static unsigned long worstNodes = SLOW_MIN_NODES;
+
+//function prototypes
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+static void fuzzPuzzle(const uint8_t *values);
+static void recordSlow(const char *puzzle, unsigned long nodes);
+#ifndef FUZZ_LIBFUZZER
+static size_t runFile(const char *path, char (*seeds)[RECORDLEN],
+                      size_t numSeeds);
+static void mutate(char *puzzle);
+#endif
+
+/**
+ * Runs one input through every parser and solver entry point. Always
+ * returns 0 as libFuzzer expects.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    char *text = malloc(size + 1);
+    uint8_t *boards = malloc((size + 1) * NUMCELLS);
+    bool *malformed = malloc(size + 1);
+    if(text == NULL || boards == NULL || malformed == NULL){
+        free(text);
+        free(boards);
+        free(malformed);
+        return 0;
+    }
+    memcpy(text, data, size);
+    text[size] = '\0';
+
+    //The board module, a failed initSetBoard still gets a diff applied
+    Cell **board = strlen(text) == NUMCELLS ? initSetBoard(text) : NULL;
+    if(board == NULL){
+        board = initBoard();
+    }
+    patchBoard(board, data, size);
+    deleteBoard(board);
+
+    char solution[NUMCELLS + 1];
+    solveString(text, solution, NULL);
+    uint16_t cands[NUMCELLS];
+    uint8_t values[NUMCELLS];
+    if(parseCandidates(text, cands)){
+        solveCandidates(cands, values, NULL);
+    }
+
+    //Every line parsed is a puzzle of its own (a line never takes less than
+    //one byte, so there are at most size + 1 of them), and the answers of a
+    //batch are only matched to its lines if there is exactly one per line
+    size_t lines = 0;
+    for(size_t i = 0; i < size; i++){
+        lines += text[i] == '\n';
+    }
+    if(size > 0 && text[size - 1] != '\n'){
+        lines++;
+    }
+    size_t consumed;
+    size_t count = parseRecords(text, size, true, boards, malformed, size + 1,
+                                &consumed);
+    if(count != lines || consumed != size){
+        fprintf(stderr, "%zu lines parsed as %zu boards using %zu of %zu "
+                "bytes\n", lines, count, consumed, size);
+        abort();
+    }
+    for(size_t i = 0; i < count; i++){
+        if(!malformed[i]){
+            fuzzPuzzle(boards + i * NUMCELLS);
+        }
+    }
+
+    free(text);
+    free(boards);
+    free(malformed);
+    return 0;
+}
+
+/**
+ * Solves, counts and classifies one parsed puzzle, recording it if the
+ * search needed more nodes than any puzzle before it.
+ */
+static void fuzzPuzzle(const uint8_t *values)
+{
+    char puzzle[NUMCELLS + 1];
+    uint8_t solution[NUMCELLS];
+    uint8_t satSolution[NUMCELLS];
+    SolverStats solveStats = {0}; //Not written if the puzzle fails to load
+    SolverStats countStats = {0};
+    Rating rating;
+    for(int i = 0; i < NUMCELLS; i++){
+        puzzle[i] = '0' + values[i];
+    }
+    puzzle[NUMCELLS] = '\0';
+
+    bool solved = solveValues(values, solution, &solveStats);
+    if(solveValuesSat(values, satSolution, NULL) != solved){
+        fprintf(stderr, "engines disagree on %s\n", puzzle);
+        abort();
+    }
+    for(int i = 0; solved && i < NUMCELLS; i++){
+        if(satSolution[i] == 0 || (values[i] != 0 &&
+                                   satSolution[i] != values[i])){
+            fprintf(stderr, "SAT solution breaks the clues of %s\n", puzzle);
+            abort();
+        }
+    }
+    if(solved && !checkValues(satSolution)){
+        fprintf(stderr, "SAT solution is not legal for %s\n", puzzle);
+        abort();
+    }
+    checkValues(values);
+    countSolutions(puzzle, 2, &countStats);
+    if(classifySingles(values, &rating) == SINGLES_STUCK){
+        rateValues(values, &rating);
+    }
+    recordSlow(puzzle, solveStats.nodes + countStats.nodes);
+}
+
+/**
+ * Appends the puzzle to the slow puzzles file if `nodes` is a new worst.
+ */
+static void recordSlow(const char *puzzle, unsigned long nodes)
+{
+    if(nodes <= worstNodes){
+        return;
+    }
+    worstNodes = nodes;
+    const char *path = getenv("SLOW_PUZZLES");
+    FILE *file = fopen(path != NULL ? path : SLOW_FILE, "a");
+    if(file == NULL){
+        perror("fuzzSolver");
+        return;
+    }
+    fprintf(file, "%s\n", puzzle);
+    fclose(file);
+    fprintf(stderr, "slow puzzle (%lu nodes): %s\n", nodes, puzzle);
+}
+
+#ifndef FUZZ_LIBFUZZER
+int main(const int argc, const char *argv[])
+{
+    static char seeds[MAXSEEDS][RECORDLEN];
+    long runs = 0;
+    int first = 1;
+    if(argc >= 3 && strcmp(argv[1], "-n") == 0){
+        char *end;
+        runs = strtol(argv[2], &end, 10);
+        if(*end != '\0' || runs < 0){
+            fprintf(stderr, "usage: %s [-n runs] [inputs...]\n", argv[0]);
+            exit(1);
+        }
+        first = 3;
+    }
+
+    size_t numSeeds = 0;
+    for(int i = first; i < argc; i++){
+        numSeeds = runFile(argv[i], seeds, numSeeds);
+    }
+    if(numSeeds == 0){
+        strcpy(seeds[numSeeds++], "53007000060019500009800006080006000340080300"
+                                  "1700020006060000280000419005000080079");
+    }
+
+    srand(1); //Runs are repeatable
+    char input[RECORDLEN + 1];
+    for(long run = 0; run < runs; run++){
+        strcpy(input, seeds[rand() % numSeeds]);
+        mutate(input);
+        input[NUMCELLS] = '\n';
+        LLVMFuzzerTestOneInput((const uint8_t *)input, RECORDLEN);
+    }
+    return 0;
+}
+
+/**
+ * Runs the whole file at `path` through the target as one input and adds the
+ * 81 char lines in it to `seeds`. Returns the new number of seeds.
+ */
+static size_t runFile(const char *path, char (*seeds)[RECORDLEN],
+                      size_t numSeeds)
+{
+    FILE *file = fopen(path, "rb");
+    if(file == NULL){
+        perror(path);
+        exit(2);
+    }
+    size_t size = 0;
+    size_t cap = 1 << 16;
+    char *data = malloc(cap);
+    size_t got;
+    while(data != NULL && (got = fread(data + size, 1, cap - size, file)) > 0){
+        size += got;
+        if(size == cap){
+            char *bigger = realloc(data, cap *= 2);
+            if(bigger == NULL){
+                free(data);
+            }
+            data = bigger;
+        }
+    }
+    fclose(file);
+    if(data == NULL){
+        fprintf(stderr, "Unable to read %s\n", path);
+        exit(2);
+    }
+    LLVMFuzzerTestOneInput((const uint8_t *)data, size);
+
+    char *line = data;
+    char *end = data + size;
+    while(line < end && numSeeds < MAXSEEDS){
+        char *newline = memchr(line, '\n', end - line);
+        size_t len = (newline != NULL ? newline : end) - line;
+        if(len == NUMCELLS){
+            memcpy(seeds[numSeeds], line, NUMCELLS);
+            seeds[numSeeds++][NUMCELLS] = '\0';
+        }
+        line += len + 1;
+    }
+    free(data);
+    return numSeeds;
+}
+
+/**
+ * Changes between one and four cells of the puzzle to a random digit or to
+ * empty.
+ */
+static void mutate(char *puzzle)
+{
+    int changes = 1 + rand() % 4;
+    for(int i = 0; i < changes; i++){
+        puzzle[rand() % NUMCELLS] = '0' + rand() % 10;
+    }
+}
+#endif
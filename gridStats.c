@@ -0,0 +1,434 @@
+/**
+ * Counts (or estimates) the number of complete sudoku grids the way
+ * Felgenhauer and Jarvis did, and reports how the count is spread over the
+ * possible first bands. Besides the statistics this runs the solver's
+ * counting search for hours on end over every thread, which makes it a
+ * stress test and a benchmark of countSolutionsTT at a scale nothing else
+ * reaches.
+ *
+ * Relabelling the digits of any grid turns box 1 into 123/456/789, so the
+ * grids are 9! times those with that box 1. The first band of those can be
+ * filled in 2612736 ways, but most of those ways are the same band up to
+ * permuting its rows, its boxes and the columns within each box (and then
+ * relabelling to restore box 1), none of which change how many ways the rest
+ * of the grid can be completed. Ordering the columns of boxes 2 and 3 by their
+ * top row and the two boxes by their top left cell leaves 36288 bands, one
+ * for every 72, and those fall into BAND_CLASSES classes under the rest of
+ * the band's symmetries. Only one band per class is completed, with
+ * countSolutionsTT, and the count weighted by the size of its class.
+ *
+ * Completing one band takes on the order of a minute, so the classes are
+ * shared out over `threads` threads, each with its own transposition table
+ * of `table MB` megabytes (the search slows down about three times with a
+ * quarter of the default), and with -n only the classes of `samples` bands
+ * drawn at random are completed. Since every band is equally likely to be
+ * drawn that gives an estimate of the number of grids along with its
+ * standard error, while a full run gives the exact number. -n 0 only reduces
+ * the bands.
+ *
+ * Usage: ./gridStats [-t threads] [-m table MB] [-n samples] [-s seed]
+ *
+ * Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The tables or threads could not be created
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <threads.h>
+#include <stdatomic.h>
+#include "./sudokuSolver.h"
+
+#define BANDCELLS 27
+#define FIXED_BANDS 2612736L //Bands with box 1 fixed
+#define REDUCED_BANDS 36288  //Of those, with boxes 2 and 3 in order
+#define BAND_ORDERINGS 72    //Bands each reduced band stands for
+#define BAND_CLASSES 416     //Classes the reduced bands fall into
+#define RELABELINGS 362880L  //9!, the ways to relabel the digits
+#define TABLE_MB 256   //Default transposition table of each thread
+#define MAXTHREADS 256
+
+typedef struct bandClass{
+    uint64_t key;        //Canonical form of the bands in the class
+    long size;           //Bands with box 1 fixed in the class
+    bool wanted;         //Whether the class is to be completed
+    long completions;    //Ways to complete one of its bands to a grid
+    unsigned long nodes; //Search nodes the count took
+}BandClass;
+
+//function prototypes
+static int reduceBands(uint64_t *keys);
+static void fillBand(uint8_t *band, int cell, uint64_t *keys, int *count);
+static uint64_t canonicalKey(const uint8_t *band);
+static int compareKeys(const void *a, const void *b);
+static int countClasses(void *arg);
+static void printGrids(uint64_t weighted);
+
+static const int perms[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2},
+                                {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+
+static BandClass *classes;
+static int numClasses;
+static atomic_int nextClass; //The next class a thread should complete
+static size_t tableBytes = (size_t)TABLE_MB << 20;
+
+int main(const int argc, const char *argv[])
+{
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    long samples = -1; //Every class
+    long seed = 1;
+    for(int i = 1; i < argc; i++){
+        char *end;
+        long value = i + 1 < argc ? strtol(argv[i + 1], &end, 10) : -1;
+        if(value < 0 || *end != '\0'){
+            fprintf(stderr, "usage: %s [-t threads] [-m table MB] "
+                    "[-n samples] [-s seed]\n", argv[0]);
+            exit(1);
+        }
+        if(strcmp(argv[i], "-t") == 0 && value >= 1 && value <= MAXTHREADS){
+            threads = value;
+        }
+        else if(strcmp(argv[i], "-m") == 0 && value >= 1){
+            tableBytes = (size_t)value << 20;
+        }
+        else if(strcmp(argv[i], "-n") == 0){
+            samples = value;
+        }
+        else if(strcmp(argv[i], "-s") == 0){
+            seed = value;
+        }
+        else{
+            fprintf(stderr, "usage: %s [-t threads] [-m table MB] "
+                    "[-n samples] [-s seed]\n", argv[0]);
+            exit(1);
+        }
+        i++;
+    }
+    if(threads < 1 || threads > MAXTHREADS){ //sysconf can fail or be huge
+        threads = threads < 1 ? 1 : MAXTHREADS;
+    }
+
+    static uint64_t keys[REDUCED_BANDS];
+    static uint64_t sorted[REDUCED_BANDS];
+    int numBands = reduceBands(keys);
+    memcpy(sorted, keys, sizeof(keys));
+    qsort(sorted, numBands, sizeof(uint64_t), compareKeys);
+    classes = calloc(numBands, sizeof(BandClass));
+    if(classes == NULL){
+        fprintf(stderr, "Unable to allocate the classes\n");
+        exit(2);
+    }
+    for(int i = 0; i < numBands; i++){
+        if(numClasses == 0 || classes[numClasses - 1].key != sorted[i]){
+            classes[numClasses++].key = sorted[i];
+        }
+        classes[numClasses - 1].size += BAND_ORDERINGS;
+    }
+    long smallest = FIXED_BANDS;
+    long largest = 0;
+    for(int c = 0; c < numClasses; c++){
+        smallest = classes[c].size < smallest ? classes[c].size : smallest;
+        largest = classes[c].size > largest ? classes[c].size : largest;
+    }
+    printf("%d reduced bands (%ld with box 1 fixed) in %d classes\n",
+           numBands, (long)numBands * BAND_ORDERINGS, numClasses);
+    printf("class sizes: smallest %ld, largest %ld\n", smallest, largest);
+    if(numBands != REDUCED_BANDS || numClasses != BAND_CLASSES){
+        fprintf(stderr, "expected %d reduced bands in %d classes\n",
+                REDUCED_BANDS, BAND_CLASSES);
+    }
+    if(samples == 0){
+        return 0;
+    }
+
+    //Draw the bands to sample, each standing for the class it falls in
+    int *drawn = NULL;
+    if(samples > 0){
+        drawn = malloc(samples * sizeof(int));
+        if(drawn == NULL){
+            fprintf(stderr, "Unable to allocate the samples\n");
+            exit(2);
+        }
+        srand(seed);
+        for(long s = 0; s < samples; s++){
+            uint64_t key = keys[rand() % numBands];
+            BandClass *found = bsearch(&key, classes, numClasses,
+                                       sizeof(BandClass), compareKeys);
+            drawn[s] = found - classes;
+            found->wanted = true;
+        }
+    }
+    else{
+        for(int c = 0; c < numClasses; c++){
+            classes[c].wanted = true;
+        }
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    thrd_t workers[MAXTHREADS];
+    for(long t = 0; t < threads; t++){
+        if(thrd_create(&workers[t], countClasses, NULL) != thrd_success){
+            fprintf(stderr, "Unable to start the counting threads\n");
+            exit(2);
+        }
+    }
+    int failed = 0;
+    for(long t = 0; t < threads; t++){
+        int result;
+        thrd_join(workers[t], &result);
+        failed |= result;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if(failed){
+        fprintf(stderr, "Unable to allocate the transposition tables\n");
+        exit(2);
+    }
+
+    double seconds = (end.tv_sec - start.tv_sec) +
+                     (end.tv_nsec - start.tv_nsec) / 1e9;
+    int counted = 0;
+    unsigned long nodes = 0;
+    long fewest = LONG_MAX;
+    long most = 0;
+    for(int c = 0; c < numClasses; c++){
+        if(classes[c].wanted){
+            counted++;
+            nodes += classes[c].nodes;
+            fewest = classes[c].completions < fewest ?
+                     classes[c].completions : fewest;
+            most = classes[c].completions > most ?
+                   classes[c].completions : most;
+        }
+    }
+    printf("completed %d classes on %ld threads in %.1f s (%.3g nodes/s)\n",
+           counted, threads, seconds, nodes / seconds);
+    printf("completions per band: fewest %ld, most %ld\n", fewest, most);
+
+    if(samples < 0){
+        uint64_t weighted = 0;
+        for(int c = 0; c < numClasses; c++){
+            weighted += (uint64_t)classes[c].size * classes[c].completions;
+        }
+        printf("mean completions %.1f\n", (double)weighted / FIXED_BANDS);
+        printGrids(weighted);
+    }
+    else{
+        double sum = 0;
+        double squares = 0;
+        for(long s = 0; s < samples; s++){
+            double count = classes[drawn[s]].completions;
+            sum += count;
+            squares += count * count;
+        }
+        double mean = sum / samples;
+        double spread = samples > 1 ?
+                        sqrt((squares - sum * mean) / (samples - 1)) : 0;
+        double scale = (double)RELABELINGS * FIXED_BANDS;
+        printf("mean completions %.1f (standard deviation %.1f)\n", mean,
+               spread);
+        printf("grids: about %.4e +- %.1e\n", mean * scale,
+               spread / sqrt(samples) * scale);
+        free(drawn);
+    }
+    free(classes);
+    return 0;
+}
+
+/**
+ * Writes the canonical key of every band with box 1 fixed and boxes 2 and 3
+ * in order to `keys` and returns the number of those bands.
+ */
+static int reduceBands(uint64_t *keys)
+{
+    uint8_t band[BANDCELLS] = {0};
+    int count = 0;
+    for(int i = 0; i < 9; i++){
+        band[(i / 3) * 9 + i % 3] = i + 1;
+    }
+    //Box 2 gets 4 and two more of 5 - 9 on top (in order), box 3 the rest
+    for(int a = 5; a <= 9; a++){
+        for(int b = a + 1; b <= 9; b++){
+            int col = 3;
+            band[col++] = 4;
+            band[col++] = a;
+            band[col++] = b;
+            for(int d = 5; d <= 9; d++){
+                if(d != a && d != b){
+                    band[col++] = d;
+                }
+            }
+            fillBand(band, 9, keys, &count);
+        }
+    }
+    return count;
+}
+
+/**
+ * Fills the cells of rows 2 and 3 outside of box 1 from `cell` on in every
+ * legal way, adding the key of each band completed to `keys`.
+ */
+static void fillBand(uint8_t *band, int cell, uint64_t *keys, int *count)
+{
+    if(cell == BANDCELLS){
+        keys[(*count)++] = canonicalKey(band);
+        return;
+    }
+    if(cell % 9 == 0){
+        cell += 3; //Box 1 is already filled
+    }
+    int row = cell / 9;
+    int col = cell % 9;
+    for(int d = 1; d <= 9; d++){
+        bool used = false;
+        for(int c = 0; c < col && !used; c++){
+            used = band[row * 9 + c] == d;
+        }
+        for(int r = 0; r < row && !used; r++){
+            used = band[r * 9 + col] == d;
+            for(int c = col / 3 * 3; c < col / 3 * 3 + 3 && !used; c++){
+                used = band[r * 9 + c] == d;
+            }
+        }
+        if(!used){
+            band[cell] = d;
+            fillBand(band, cell + 1, keys, count);
+        }
+    }
+    band[cell] = 0;
+}
+
+/**
+ * Returns the smallest key of the bands the given band can be turned into by
+ * permuting its rows, boxes and the columns within its boxes and relabelling
+ * so that box 1 reads 123/456/789. A key holds boxes 2 and 3 (columns in
+ * order, three digits each) as a number in base 9.
+ */
+static uint64_t canonicalKey(const uint8_t *band)
+{
+    uint64_t best = UINT64_MAX;
+    for(int r = 0; r < 6; r++){
+        for(int first = 0; first < 3; first++){
+            for(int p = 0; p < 6; p++){
+                //The band's columns top to bottom, box `first` moved first
+                int order[9];
+                int k = 0;
+                for(int j = 0; j < 3; j++){
+                    order[k++] = first * 3 + perms[p][j];
+                }
+                for(int box = 0; box < 3; box++){
+                    for(int j = 0; j < 3 && box != first; j++){
+                        order[k++] = box * 3 + j;
+                    }
+                }
+                uint8_t cols[9][3];
+                uint8_t label[10];
+                for(k = 0; k < 9; k++){
+                    for(int i = 0; i < 3; i++){
+                        cols[k][i] = band[perms[r][i] * 9 + order[k]];
+                    }
+                }
+                for(k = 0; k < 3; k++){
+                    for(int i = 0; i < 3; i++){
+                        label[cols[k][i]] = i * 3 + k + 1;
+                    }
+                }
+
+                //Relabel and put the columns of each box in order by their top
+                //cell, then the two boxes by their first columns
+                uint8_t rest[6][3];
+                for(k = 0; k < 6; k++){
+                    for(int i = 0; i < 3; i++){
+                        rest[k][i] = label[cols[k + 3][i]];
+                    }
+                    for(int j = k; j > k / 3 * 3 && rest[j][0] < rest[j - 1][0];
+                        j--){
+                        uint8_t swap[3];
+                        memcpy(swap, rest[j], 3);
+                        memcpy(rest[j], rest[j - 1], 3);
+                        memcpy(rest[j - 1], swap, 3);
+                    }
+                }
+                int second = rest[0][0] < rest[3][0] ? 0 : 3;
+                uint64_t key = 0;
+                for(int i = 0; i < 3; i++){
+                    for(k = 0; k < 6; k++){
+                        key = key * 9 + rest[(second + k) % 6][i] - 1;
+                    }
+                }
+                best = key < best ? key : best;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * Orders two keys, or a key and the class it names, for qsort and bsearch.
+ */
+static int compareKeys(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Thread body completing wanted classes until none are left. Returns nonzero
+ * if its transposition table could not be allocated.
+ */
+static int countClasses(void *arg)
+{
+    (void)arg;
+    TransTable *table = initTransTable(tableBytes);
+    if(table == NULL){
+        return 1;
+    }
+    int c;
+    while((c = atomic_fetch_add(&nextClass, 1)) < numClasses){
+        if(!classes[c].wanted){
+            continue;
+        }
+        //Box 1 and the key's boxes 2 and 3 make up the first band
+        char clues[NUMCELLS + 1];
+        uint64_t key = classes[c].key;
+        memset(clues, '0', NUMCELLS);
+        clues[NUMCELLS] = '\0';
+        for(int i = BANDCELLS - 1; i >= 0; i--){
+            if(i % 9 < 3){
+                clues[i] = '1' + (i / 9) * 3 + i % 9;
+            }
+            else{
+                clues[i] = '1' + key % 9;
+                key /= 9;
+            }
+        }
+        SolverStats stats = {0};
+        classes[c].completions = countSolutionsTT(clues, LONG_MAX, table,
+                                                  &stats);
+        classes[c].nodes = stats.nodes;
+    }
+    deleteTransTable(table);
+    return 0;
+}
+
+/**
+ * Prints the exact number of grids, 9! times `weighted`, the number of grids
+ * with box 1 fixed. The product can be past 64 bits so it is worked out in
+ * two halves of 9 decimal digits.
+ */
+static void printGrids(uint64_t weighted)
+{
+    const uint64_t half = 1000000000;
+    uint64_t low = weighted % half * RELABELINGS;
+    uint64_t high = weighted / half * RELABELINGS + low / half;
+    if(high > 0){
+        printf("grids: %llu%09llu\n", (unsigned long long)high,
+               (unsigned long long)(low % half));
+    }
+    else{
+        printf("grids: %llu\n", (unsigned long long)low);
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ * Sends puzzles to a running solveServer over the shared memory interface and
+ * prints the answers. Puzzles are read from stdin, one 81 char puzzle per
+ * line, and each answer is printed on its own line. Once stdin is exhausted
+ * the average round trip time is printed to stderr.
+ *
+ * Usage: ./ipcClient [segment name] < puzzles.txt
+ *
+ * Exit statuses are as follows
+ * 1 - Improper amount of arguments
+ * 2 - The segment could not be attached to
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include "./sudokuIpc.h"
+
+int main(const int argc, const char *argv[])
+{
+    if(argc > 2){
+        fprintf(stderr, "usage: %s [segment name]\n", argv[0]);
+        exit(1);
+    }
+    const char *name = argc == 2 ? argv[1] : IPC_NAME;
+
+    IpcSegment *seg = ipcAttach(name);
+    if(seg == NULL){
+        fprintf(stderr, "Unable to attach to the segment %s\n", name);
+        exit(2);
+    }
+
+    char line[256];
+    char solution[NUMCELLS + 1];
+    long requests = 0;
+    double totalNs = 0;
+    while(fgets(line, sizeof(line), stdin) != NULL){
+        line[strcspn(line, "\r\n")] = '\0';
+        if(line[0] == '\0'){
+            continue;
+        }
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        IpcStatus status = ipcSolve(seg, line, solution);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        totalNs += (end.tv_sec - start.tv_sec) * 1e9 +
+                   (end.tv_nsec - start.tv_nsec);
+        requests++;
+
+        switch(status){
+            case IPC_SOLVED:
+                printf("%s\n", solution);
+                break;
+            case IPC_UNSOLVABLE:
+                printf("unsolvable\n");
+                break;
+            case IPC_INVALID:
+                printf("invalid\n");
+                break;
+            default:
+                printf("error\n");
+                break;
+        }
+    }
+
+    if(requests > 0){
+        fprintf(stderr, "%ld requests, %.2f us average round trip\n",
+                requests, totalNs / requests / 1000.0);
+    }
+    ipcDetach(seg);
+    return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * Solves one killer sudoku read from stdin and prints its solution as an 81
+ * char line, with the search statistics on stderr. With -c it instead
+ * prints how many solutions the puzzle has, counting at most `limit`.
+ *
+ * The puzzle is given one cage per line: the cage's sum followed by its cells,
+ * each written as its row and column as two digits from 1 to 9, so
+ * "15 11 12 21" is a cage of the three cells in the top left corner adding up
+ * to 15. Blank lines and lines starting with '#' are skipped. A given is a
+ * cage of one cell.
+ *
+ * Usage: ./killerSolve [-c limit] < cages.txt
+ *
+ * Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The cages could not be read or are not legal
+ * 3 - The puzzle has no solution
+ */
+#include "./sudokuKiller.h"
+
+#define MAXLINE 256
+
+//function prototypes
+static bool readCages(KillerPuzzle *puzzle);
+static bool readCage(const char *line, KillerCage *cage);
+
+int main(const int argc, const char *argv[])
+{
+    long limit = 0;
+    if(argc == 3 && strcmp(argv[1], "-c") == 0){
+        char *end;
+        limit = strtol(argv[2], &end, 10);
+        if(*end != '\0' || limit < 1){
+            limit = -1;
+        }
+    }
+    if(limit < 0 || (argc != 1 && limit == 0)){
+        fprintf(stderr, "usage: %s [-c limit] < cages\n", argv[0]);
+        exit(1);
+    }
+
+    static KillerPuzzle puzzle;
+    if(!readCages(&puzzle) || !checkKiller(&puzzle)){
+        fprintf(stderr, "The cages are malformed, overlap or have a sum "
+                "their cells can not make\n");
+        exit(2);
+    }
+    SolverStats stats;
+    if(limit > 0){
+        long count = countKiller(&puzzle, limit, &stats);
+        printf("%ld\n", count);
+        fprintf(stderr, "%lu nodes, %lu guesses\n", stats.nodes,
+                stats.guesses);
+        return 0;
+    }
+    uint8_t solution[NUMCELLS];
+    bool solved = solveKiller(&puzzle, solution, &stats);
+    fprintf(stderr, "%s after %lu nodes, %lu guesses\n",
+            solved ? "solved" : "no solution", stats.nodes, stats.guesses);
+    if(!solved){
+        exit(3);
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        putchar('0' + solution[i]);
+    }
+    putchar('\n');
+    return 0;
+}
+
+/**
+ * Reads every cage line from stdin into `puzzle`. Returns false if a line is
+ * too long or malformed, or there are more cages than cells.
+ */
+static bool readCages(KillerPuzzle *puzzle)
+{
+    char line[MAXLINE];
+    puzzle->numCages = 0;
+    while(fgets(line, MAXLINE, stdin) != NULL){
+        if(strchr(line, '\n') == NULL && !feof(stdin)){
+            return false;
+        }
+        const char *start = line;
+        while(isspace(*start)){
+            start++;
+        }
+        if(*start == '\0' || *start == '#'){
+            continue;
+        }
+        if(puzzle->numCages == NUMCELLS ||
+           !readCage(start, &puzzle->cages[puzzle->numCages])){
+            return false;
+        }
+        puzzle->numCages++;
+    }
+    return true;
+}
+
+/**
+ * Parses one cage line, a sum followed by one to nine cells. Returns false
+ * if anything in the line is not a number or a cell is not two digits from
+ * 1 to 9.
+ */
+static bool readCage(const char *line, KillerCage *cage)
+{
+    char *end;
+    long sum = strtol(line, &end, 10);
+    if(end == line || sum < 1 || sum > CAGE_MAX_SUM){
+        return false;
+    }
+    cage->sum = sum;
+    cage->size = 0;
+    line = end;
+    while(true){
+        while(isspace(*line)){
+            line++;
+        }
+        if(*line == '\0'){
+            break;
+        }
+        if(cage->size == BOARDSIZE || line[0] < '1' || line[0] > '9' ||
+           line[1] < '1' || line[1] > '9' ||
+           (line[2] != '\0' && !isspace(line[2]))){
+            return false;
+        }
+        cage->cells[cage->size++] = (line[0] - '1') * BOARDSIZE +
+                                    line[1] - '1';
+        line += 2;
+    }
+    return cage->size > 0;
+}
@@ -0,0 +1,179 @@
+/**
+ * Solves one large grid ("mega" puzzles of up to 64x64 cells) read from stdin
+ * and prints the solution in the same form, followed by how long it took on
+ * stderr. The grid is given as its cells row by row, separated by any white
+ * space, with 0 or '.' for an empty cell; its size follows from the number of
+ * cells, which has to be the fourth power of a box size.
+ *
+ * By default the grid is solved with the local search in sudokuAnneal, run as
+ * `chains` parallel chains for at most `seconds` seconds. With -x it is solved
+ * exactly with the SAT engine instead, which can also tell that a grid has no
+ * solution but only takes boxes up to SAT_MAX_BOX.
+ *
+ * Usage: ./megaSolve [-x] [-c chains] [-l seconds] [-s seed] < grid.txt
+ *
+ * Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The grid could not be read or is not a square of squares
+ * 3 - No solution was found
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include <unistd.h>
+#include "./sudokuAnneal.h"
+#include "./sudokuSat.h"
+
+#define DEFAULT_SECONDS 60
+#define MAXCELLS (ANNEAL_MAX_BOX * ANNEAL_MAX_BOX * ANNEAL_MAX_BOX * \
+                  ANNEAL_MAX_BOX)
+
+//function prototypes
+static int readGrid(uint8_t *values);
+static void printGrid(const uint8_t *values, int side);
+
+int main(const int argc, const char *argv[])
+{
+    bool exact = false;
+    long chains = sysconf(_SC_NPROCESSORS_ONLN);
+    double seconds = DEFAULT_SECONDS;
+    unsigned long seed = 1;
+    for(int i = 1; i < argc; i++){
+        char *end = "";
+        if(strcmp(argv[i], "-x") == 0){
+            exact = true;
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-c") == 0){
+            chains = strtol(argv[++i], &end, 10);
+            if(chains < 1 || chains > ANNEAL_MAX_CHAINS){
+                end = "bad";
+            }
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-l") == 0){
+            seconds = strtod(argv[++i], &end);
+            if(!(seconds > 0)){
+                end = "bad";
+            }
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-s") == 0){
+            seed = strtoul(argv[++i], &end, 10);
+        }
+        else{
+            end = "bad";
+        }
+        if(*end != '\0'){
+            fprintf(stderr, "usage: %s [-x] [-c chains] [-l seconds] "
+                    "[-s seed] < grid\n", argv[0]);
+            exit(1);
+        }
+    }
+    if(chains < 1){ //sysconf failed
+        chains = 1;
+    }
+    else if(chains > ANNEAL_MAX_CHAINS){
+        chains = ANNEAL_MAX_CHAINS;
+    }
+
+    static uint8_t values[MAXCELLS];
+    static uint8_t solution[MAXCELLS];
+    int boxSize = readGrid(values);
+    int largest = exact ? SAT_MAX_BOX * SAT_MAX_BOX :
+                          ANNEAL_MAX_BOX * ANNEAL_MAX_BOX;
+    if(boxSize < 0 || boxSize * boxSize > largest){
+        fprintf(stderr, "The grid must be a square of squares, at most "
+                "%dx%d cells\n", largest, largest);
+        exit(2);
+    }
+
+    bool solved;
+    if(exact){
+        SatStats stats;
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        solved = satSolveGrid(boxSize, values, solution, &stats);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        fprintf(stderr, "%s in %.3f s (%lu decisions, %lu conflicts)\n",
+                solved ? "solved" : "no solution",
+                (end.tv_sec - start.tv_sec) +
+                (end.tv_nsec - start.tv_nsec) / 1e9,
+                stats.decisions, stats.conflicts);
+    }
+    else{
+        AnnealStats stats;
+        solved = annealGrid(boxSize, values, solution, chains, seed, seconds,
+                            &stats);
+        if(solved){
+            fprintf(stderr, "solved by chain %d of %d in %.3f s (%lu moves, "
+                    "%lu reheats)\n", stats.winner, stats.chains,
+                    stats.seconds, stats.moves, stats.reheats);
+        }
+        else if(stats.singles < 0){
+            fprintf(stderr, "no solution, the clues contradict each other\n");
+        }
+        else{
+            fprintf(stderr, "no solution after %.3f s (best cost %d, %lu "
+                    "moves)\n", stats.seconds, stats.bestCost, stats.moves);
+        }
+    }
+    if(!solved){
+        exit(3);
+    }
+    printGrid(solution, boxSize * boxSize);
+    return 0;
+}
+
+/**
+ * Reads a grid from stdin into `values`. Returns its box size, or -1 if the
+ * input holds something other than numbers and '.', has too many cells or a
+ * number of cells that is not a fourth power.
+ */
+static int readGrid(uint8_t *values)
+{
+    int count = 0;
+    int c = getchar();
+    while(c != EOF){
+        if(isspace(c)){
+            c = getchar();
+            continue;
+        }
+        if(count == MAXCELLS){
+            return -1;
+        }
+        if(c == '.'){
+            values[count++] = 0;
+            c = getchar();
+            continue;
+        }
+        int value = 0;
+        if(!isdigit(c)){
+            return -1;
+        }
+        while(isdigit(c)){
+            value = value * 10 + c - '0';
+            if(value > ANNEAL_MAX_BOX * ANNEAL_MAX_BOX){
+                return -1;
+            }
+            c = getchar();
+        }
+        values[count++] = value;
+    }
+    for(int box = ANNEAL_MIN_BOX; box <= ANNEAL_MAX_BOX; box++){
+        if(count == box * box * box * box){
+            return box;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Prints the grid row by row with every number padded to the same width.
+ */
+static void printGrid(const uint8_t *values, int side)
+{
+    int width = side >= 10 ? 2 : 1;
+    for(int row = 0; row < side; row++){
+        for(int col = 0; col < side; col++){
+            printf("%*d%c", width, values[row * side + col],
+                   col == side - 1 ? '\n' : ' ');
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/**
+ * Finds the fewest clues a unique puzzle for the given solution grid can
+ * have and prints that number on the first line and such a puzzle as 81
+ * digits (0 for an empty cell) on the second. Every clue count from `from`
+ * up is searched in turn with searchClues, with a line on stderr for each
+ * one ruled out, until a unique puzzle turns up or the count reaches the
+ * size of the smallest puzzle the greedy bound found.
+ *
+ * -f sets the first clue count searched. It is 17 by default since no
+ * sudoku with 16 clues exists; -f 1 searches the smaller counts too. -k
+ * stops the search after that many clues, in which case the smallest puzzle
+ * found is printed instead, and -t sets the number of threads (one per
+ * processor by default).
+ *
+ * Usage: ./minClues [-t threads] [-f from] [-k most] grid
+ *
+ * Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The grid is not a full legal grid, or the search could not be had
+ * 3 - The search stopped at -k before finding the minimum
+ */
+#include <time.h>
+#include <unistd.h>
+#include "./sudokuMinClue.h"
+
+#define DEFAULT_FROM 17 //No unique puzzle has fewer clues
+
+//function prototypes
+static bool readGrid(const char *text, uint8_t *grid);
+static void printPuzzle(int clues, const uint8_t *puzzle);
+
+int main(const int argc, const char *argv[])
+{
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    long from = DEFAULT_FROM;
+    long most = NUMCELLS;
+    const char *text = NULL;
+    for(int i = 1; i < argc; i++){
+        char *end = "";
+        if(i + 1 < argc && strcmp(argv[i], "-t") == 0){
+            threads = strtol(argv[++i], &end, 10);
+            if(threads < 1 || threads > MINCLUE_MAX_THREADS){
+                end = "bad";
+            }
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-f") == 0){
+            from = strtol(argv[++i], &end, 10);
+            if(from < 1 || from > NUMCELLS){
+                end = "bad";
+            }
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-k") == 0){
+            most = strtol(argv[++i], &end, 10);
+            if(most < 1 || most > NUMCELLS){
+                end = "bad";
+            }
+        }
+        else if(text == NULL && argv[i][0] != '-'){
+            text = argv[i];
+        }
+        else{
+            end = "bad";
+        }
+        if(*end != '\0'){
+            text = NULL;
+            break;
+        }
+    }
+    if(text == NULL){
+        fprintf(stderr, "usage: %s [-t threads] [-f from] [-k most] grid\n",
+                argv[0]);
+        exit(1);
+    }
+    if(threads < 1){ //sysconf failed
+        threads = 1;
+    }
+    else if(threads > MINCLUE_MAX_THREADS){
+        threads = MINCLUE_MAX_THREADS;
+    }
+
+    uint8_t grid[NUMCELLS];
+    MinClueSearch *search = NULL;
+    if(readGrid(text, grid)){
+        search = initMinClue(grid, threads);
+    }
+    if(search == NULL){
+        fprintf(stderr, "The grid must be 81 digits making a legal solution "
+                "grid\n");
+        exit(2);
+    }
+    MinClueStats stats;
+    getMinClueStats(search, &stats);
+    fprintf(stderr, "%d unavoidable sets, greedy bound %d clues\n",
+            stats.sets, stats.upperBound);
+
+    uint8_t puzzle[NUMCELLS];
+    for(int clues = from; clues <= most; clues++){
+        time_t start = time(NULL);
+        int found = searchClues(search, clues, puzzle);
+        if(found < 0){
+            fprintf(stderr, "The search threads could not be started\n");
+            exit(2);
+        }
+        getMinClueStats(search, &stats);
+        if(found == 1){
+            deleteMinClue(search);
+            printPuzzle(stats.upperBound, puzzle);
+            return 0;
+        }
+        fprintf(stderr, "no puzzle with %d clues (%ld s, %lu nodes, %lu "
+                "checks, %d sets)\n", clues, (long)(time(NULL) - start),
+                stats.nodes, stats.checks, stats.sets);
+    }
+    int clues = smallestPuzzle(search, puzzle);
+    deleteMinClue(search);
+    fprintf(stderr, "Stopped at %ld clues, the smallest puzzle found has "
+            "%d\n", most, clues);
+    printPuzzle(clues, puzzle);
+    exit(3);
+}
+
+/**
+ * Reads an 81 char grid of the digits 1 - 9 into `grid`. Returns false if it
+ * is the wrong length or holds anything else.
+ */
+static bool readGrid(const char *text, uint8_t *grid)
+{
+    if(strlen(text) != NUMCELLS){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        if(text[i] < '1' || text[i] > '9'){
+            return false;
+        }
+        grid[i] = text[i] - '0';
+    }
+    return true;
+}
+
+/**
+ * Prints the number of clues and then the puzzle as 81 digits.
+ */
+static void printPuzzle(int clues, const uint8_t *puzzle)
+{
+    printf("%d\n", clues);
+    for(int i = 0; i < NUMCELLS; i++){
+        putchar('0' + puzzle[i]);
+    }
+    putchar('\n');
+}
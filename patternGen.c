@@ -0,0 +1,112 @@
+/**
+ * Generates a puzzle whose clues form the pattern read from stdin, with
+ * generatePattern, and prints the puzzle and then its solution as lines of
+ * 81 digits (0 for an empty cell). The search statistics go to stderr.
+ *
+ * The pattern is given as 81 cells row by row with white space ignored,
+ * '.', '0' or '-' for an empty cell and any other char for a clue, so it can
+ * be drawn as 9 lines of 'X's and dots.
+ *
+ * -t sets the number of threads (one per processor by default), -g the most
+ * random grids to try before giving up and -s the random seed.
+ *
+ * Usage: ./patternGen [-t threads] [-g grids] [-s seed] < pattern.txt
+ *
+ * Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The pattern could not be read or has fewer than 17 clues
+ * 3 - No puzzle was found in the grids tried
+ */
+#include <unistd.h>
+#include "./sudokuPattern.h"
+
+#define DEFAULT_GRIDS 10000 //Default number of grids tried
+
+//function prototypes
+static int readPattern(bool *clues);
+
+int main(const int argc, const char *argv[])
+{
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned long grids = DEFAULT_GRIDS;
+    unsigned long seed = 1;
+    bool good = true;
+    for(int i = 1; i < argc && good; i++){
+        char *end = "bad";
+        if(i + 1 < argc && strcmp(argv[i], "-t") == 0){
+            threads = strtol(argv[++i], &end, 10);
+            if(threads < 1 || threads > PATTERN_MAX_THREADS){
+                end = "bad";
+            }
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-g") == 0){
+            grids = strtoul(argv[++i], &end, 10);
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-s") == 0){
+            seed = strtoul(argv[++i], &end, 10);
+        }
+        good = *end == '\0';
+    }
+    if(!good){
+        fprintf(stderr, "usage: %s [-t threads] [-g grids] [-s seed] "
+                "< pattern\n", argv[0]);
+        exit(1);
+    }
+    if(threads < 1){ //sysconf failed
+        threads = 1;
+    }
+    else if(threads > PATTERN_MAX_THREADS){
+        threads = PATTERN_MAX_THREADS;
+    }
+
+    bool clues[NUMCELLS];
+    int numClues = readPattern(clues);
+    if(numClues < PATTERN_MIN_CLUES){
+        fprintf(stderr, "The pattern must be %d cells with at least %d "
+                "clues\n", NUMCELLS, PATTERN_MIN_CLUES);
+        exit(2);
+    }
+    uint8_t puzzle[NUMCELLS];
+    uint8_t solution[NUMCELLS];
+    PatternStats stats;
+    bool found = generatePattern(clues, puzzle, solution, grids, threads,
+                                 seed, &stats);
+    fprintf(stderr, "%lu grids, %lu variants, %lu pruned, %lu checked\n",
+            stats.grids, stats.variants, stats.pruned, stats.checks);
+    if(!found){
+        fprintf(stderr, "No puzzle found with %d clues in this pattern\n",
+                numClues);
+        exit(3);
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        putchar('0' + puzzle[i]);
+    }
+    putchar('\n');
+    for(int i = 0; i < NUMCELLS; i++){
+        putchar('0' + solution[i]);
+    }
+    putchar('\n');
+    return 0;
+}
+
+/**
+ * Reads the pattern from stdin into `clues`. Returns the number of clues, or
+ * -1 if there are not exactly NUMCELLS cells.
+ */
+static int readPattern(bool *clues)
+{
+    int count = 0;
+    int numClues = 0;
+    int c;
+    while((c = getchar()) != EOF){
+        if(isspace(c)){
+            continue;
+        }
+        if(count == NUMCELLS){
+            return -1;
+        }
+        clues[count] = c != '.' && c != '0' && c != '-';
+        numClues += clues[count++];
+    }
+    return count == NUMCELLS ? numClues : -1;
+}
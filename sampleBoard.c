@@ -0,0 +1,142 @@
+/**
+ * Draws solutions of an under-constrained puzzle uniformly at random with
+ * sampleSolutions and prints how many solutions it has on the first line,
+ * then one sampled solution per line as 81 digits. The counting statistics
+ * go to stderr.
+ *
+ * -k sets the number of samples (1 by default), -t the number of counting
+ * threads (one per processor by default), -m the transposition table of
+ * each thread in megabytes, -l the largest number of solutions a board may
+ * have to be sampled (boards with more are only reported as having at least
+ * that many) and -s the random seed.
+ *
+ * Usage: ./sampleBoard [-k samples] [-t threads] [-m table MB] [-l limit]
+ *                      [-s seed] puzzle
+ *
+ * Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The puzzle is malformed or not legal, or the tables, threads or
+ *     sample buffer could not be had
+ * 3 - The puzzle has no solution or too many to sample
+ */
+#include <unistd.h>
+#include "./sudokuSample.h"
+
+#define TABLE_MB 64             //Default transposition table of each thread
+#define DEFAULT_LIMIT 100000000 //Default cap on the number of solutions
+
+//function prototypes
+static bool readPuzzle(const char *text, uint8_t *values);
+
+int main(const int argc, const char *argv[])
+{
+    long k = 1;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    long tableMB = TABLE_MB;
+    long limit = DEFAULT_LIMIT;
+    unsigned long seed = 1;
+    const char *puzzle = NULL;
+    for(int i = 1; i < argc; i++){
+        char *end = "";
+        if(i + 1 < argc && strcmp(argv[i], "-k") == 0){
+            k = strtol(argv[++i], &end, 10);
+            if(k < 0 || k > INT32_MAX / NUMCELLS){
+                end = "bad";
+            }
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-t") == 0){
+            threads = strtol(argv[++i], &end, 10);
+            if(threads < 1 || threads > SAMPLE_MAX_THREADS){
+                end = "bad";
+            }
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-m") == 0){
+            tableMB = strtol(argv[++i], &end, 10);
+            if(tableMB < 1 || tableMB > (1L << 20)){
+                end = "bad";
+            }
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-l") == 0){
+            limit = strtol(argv[++i], &end, 10);
+            if(limit < 1){
+                end = "bad";
+            }
+        }
+        else if(i + 1 < argc && strcmp(argv[i], "-s") == 0){
+            seed = strtoul(argv[++i], &end, 10);
+        }
+        else if(puzzle == NULL && argv[i][0] != '-'){
+            puzzle = argv[i];
+        }
+        else{
+            end = "bad";
+        }
+        if(*end != '\0'){
+            puzzle = NULL;
+            break;
+        }
+    }
+    if(puzzle == NULL){
+        fprintf(stderr, "usage: %s [-k samples] [-t threads] [-m table MB] "
+                "[-l limit] [-s seed] puzzle\n", argv[0]);
+        exit(1);
+    }
+    if(threads < 1){ //sysconf failed
+        threads = 1;
+    }
+    else if(threads > SAMPLE_MAX_THREADS){
+        threads = SAMPLE_MAX_THREADS;
+    }
+
+    uint8_t values[NUMCELLS];
+    uint8_t *samples = malloc((k > 0 ? k : 1) * NUMCELLS);
+    SampleStats stats;
+    long count = -1;
+    if(samples != NULL && readPuzzle(puzzle, values)){
+        count = sampleSolutions(values, k, samples, limit, threads,
+                                (size_t)tableMB << 20, seed, &stats);
+    }
+    if(count < 0){
+        fprintf(stderr, "The puzzle is not legal or the tables could not be "
+                "allocated\n");
+        exit(2);
+    }
+    fprintf(stderr, "%lu boards counted, %lu nodes, %lu table hits\n",
+            stats.counts, stats.nodes, stats.ttHits);
+    if(count == 0 || count >= limit){
+        printf("%s%ld\n", count == 0 ? "" : ">=", count);
+        exit(3);
+    }
+    printf("%ld\n", count);
+    for(long s = 0; s < k; s++){
+        for(int i = 0; i < NUMCELLS; i++){
+            putchar('0' + samples[s * NUMCELLS + i]);
+        }
+        putchar('\n');
+    }
+    free(samples);
+    return 0;
+}
+
+/**
+ * Reads an 81 char puzzle ('0' or '.' for an empty cell) into `values`.
+ * Returns false if it is the wrong length or holds anything else.
+ */
+static bool readPuzzle(const char *text, uint8_t *values)
+{
+    if(strlen(text) != NUMCELLS){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        if(text[i] == '.' || text[i] == '0'){
+            values[i] = 0;
+        }
+        else if(text[i] >= '1' && text[i] <= '9'){
+            values[i] = text[i] - '0';
+        }
+        else{
+            return false;
+        }
+    }
+    return true;
+}
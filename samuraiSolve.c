@@ -0,0 +1,108 @@
+/**
+ * Solves one Samurai sudoku read from stdin and prints its solution as 21
+ * lines of 21 chars with a space in each gap, and the search statistics on
+ * stderr. With -c it instead prints how many solutions the puzzle has,
+ * counting at most `limit`.
+ *
+ * The puzzle is given as the 441 cells of the 21x21 canvas row by row, with
+ * white space ignored, a digit for a clue, '0' or '.' for an empty cell and
+ * '0', '.' or '-' for a gap, so the usual 21 lines with the gaps written as
+ * dashes or dots can be read as they are.
+ *
+ * Usage: ./samuraiSolve [-c limit] < puzzle.txt
+ *
+ * Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The puzzle could not be read or is not legal
+ * 3 - The puzzle has no solution
+ */
+#include "./sudokuMulti.h"
+
+#define CANVAS (SAMURAI_SIDE * SAMURAI_SIDE)
+
+//function prototypes
+static bool readCanvas(const MultiLayout *layout, uint8_t *values);
+
+int main(const int argc, const char *argv[])
+{
+    long limit = 0;
+    if(argc == 3 && strcmp(argv[1], "-c") == 0){
+        char *end;
+        limit = strtol(argv[2], &end, 10);
+        if(*end != '\0' || limit < 1){
+            limit = -1;
+        }
+    }
+    if(limit < 0 || (argc != 1 && limit == 0)){
+        fprintf(stderr, "usage: %s [-c limit] < puzzle\n", argv[0]);
+        exit(1);
+    }
+
+    MultiLayout layout;
+    samuraiLayout(&layout);
+    uint8_t values[CANVAS];
+    uint8_t solution[CANVAS];
+    SolverStats stats;
+    if(!readCanvas(&layout, values)){
+        fprintf(stderr, "The puzzle must be %d cells with digits only in "
+                "the five grids\n", CANVAS);
+        exit(2);
+    }
+    if(limit > 0){
+        long count = countMulti(&layout, values, limit, &stats);
+        if(count < 0){
+            fprintf(stderr, "The clues repeat a digit\n");
+            exit(2);
+        }
+        printf("%ld\n", count);
+        fprintf(stderr, "%lu nodes, %lu guesses\n", stats.nodes,
+                stats.guesses);
+        return 0;
+    }
+    bool solved = solveMulti(&layout, values, solution, &stats);
+    fprintf(stderr, "%s after %lu nodes, %lu guesses\n",
+            solved ? "solved" : "no solution", stats.nodes, stats.guesses);
+    if(!solved){
+        exit(3);
+    }
+    for(int row = 0; row < SAMURAI_SIDE; row++){
+        for(int col = 0; col < SAMURAI_SIDE; col++){
+            int value = solution[row * SAMURAI_SIDE + col];
+            putchar(value == 0 ? ' ' : '0' + value);
+        }
+        putchar('\n');
+    }
+    return 0;
+}
+
+/**
+ * Reads the canvas from stdin into `values`. Returns false if there are not
+ * exactly CANVAS cells, a cell is not a digit, '.' or '-', or a gap holds a
+ * digit other than 0 or a cell of a grid is a '-'.
+ */
+static bool readCanvas(const MultiLayout *layout, uint8_t *values)
+{
+    int count = 0;
+    int c;
+    while((c = getchar()) != EOF){
+        if(isspace(c)){
+            continue;
+        }
+        if(count == CANVAS){
+            return false;
+        }
+        int row = count / SAMURAI_SIDE;
+        int col = count % SAMURAI_SIDE;
+        bool gap = !inLayout(layout, row, col);
+        if(c == '.' || c == '0' || (c == '-' && gap)){
+            values[count++] = 0;
+        }
+        else if(c >= '1' && c <= '9' && !gap){
+            values[count++] = c - '0';
+        }
+        else{
+            return false;
+        }
+    }
+    return count == CANVAS;
+}
@@ -0,0 +1,314 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a fixed size cache of puzzle answers that many threads (or
+ * processes, when the cache lives in shared memory) can use at once.
+ *
+ * Memory is laid out as the array of 64 byte slots followed by one reference
+ * byte per slot. Keeping the reference bits out of the slots means a hit
+ * never writes to the line another reader is copying, and the bit is only
+ * stored when it is not already set so popular entries stay read-only.
+ */
+#include "./solutionCache.h"
+
+#define CELLNIBBLE(c) ((c) == '.' ? 0 : ((c) >= '0' && (c) <= '9') ? \
+                       (c) - '0' : 0xF) //Anything malformed packs as 0xF
+#define PACKEDCELLS 72 //Rows 1 - 8, the last row is rebuilt from the columns
+#define STATUSSHIFT 32 //Where the status lives in data[4]
+
+/********* function prototypes *********/
+
+size_t solutionCacheBytes(size_t budget);
+SolutionCache *initSolutionCache(size_t budget);
+bool attachSolutionCache(SolutionCache *cache, void *mem, size_t bytes,
+                         bool clear);
+void puzzleKey(const char *puzzle, uint64_t key[2]);
+bool solutionLookup(SolutionCache *cache, const char *puzzle, int *status,
+                    char *solution);
+void solutionInsert(SolutionCache *cache, const char *puzzle, int status,
+                    const char *solution);
+void deleteSolutionCache(SolutionCache *cache);
+static size_t slotsForBudget(size_t budget);
+static uint64_t mix64(uint64_t x);
+static bool readSlot(SolutionSlot *slot, const uint64_t key[2],
+                     uint64_t data[5]);
+static void unpackSolution(const uint64_t data[5], char *solution);
+
+/**
+ * Returns the number of bytes a cache will actually use when given a memory
+ * budget of `budget` bytes. The slot count is rounded down to a power of two
+ * so the result is never more than the budget. Returns 0 if the budget is too
+ * small to hold SOLCACHE_WAYS slots.
+ */
+size_t solutionCacheBytes(size_t budget)
+{
+    size_t slots = slotsForBudget(budget);
+    return slots * (sizeof(SolutionSlot) + 1);
+}
+
+/**
+ * Allocates an empty cache that uses no more than `budget` bytes. Returns
+ * NULL if the budget is too small or the memory could not be allocated.
+ */
+SolutionCache *initSolutionCache(size_t budget)
+{
+    size_t bytes = solutionCacheBytes(budget);
+    if(bytes == 0){
+        return NULL;
+    }
+    SolutionCache *cache = malloc(sizeof(SolutionCache));
+    if(cache == NULL){
+        return NULL;
+    }
+    //aligned_alloc wants a multiple of the alignment
+    void *mem = aligned_alloc(SOLCACHE_SLOTSIZE,
+                              (bytes + SOLCACHE_SLOTSIZE - 1) &
+                              ~(size_t)(SOLCACHE_SLOTSIZE - 1));
+    if(mem == NULL){
+        free(cache);
+        return NULL;
+    }
+    attachSolutionCache(cache, mem, bytes, true);
+    cache->owned = true;
+    return cache;
+}
+
+/**
+ * Sets `cache` up to use `bytes` bytes of memory starting at `mem` (which
+ * must be 64 byte aligned), for example memory shared between processes.
+ * If `clear` is true the memory is emptied first, otherwise whatever cache
+ * another process left there is used as is. Returns false if any pointer is
+ * NULL or `bytes` is too small.
+ */
+bool attachSolutionCache(SolutionCache *cache, void *mem, size_t bytes,
+                         bool clear)
+{
+    if(cache == NULL || mem == NULL){
+        return false;
+    }
+    //Same rounding as solutionCacheBytes, counting the reference bytes
+    size_t slots = slotsForBudget(bytes / (sizeof(SolutionSlot) + 1) *
+                                  sizeof(SolutionSlot));
+    if(slots == 0){
+        return false;
+    }
+    if(clear){
+        memset(mem, 0, slots * (sizeof(SolutionSlot) + 1));
+    }
+    cache->slots = mem;
+    cache->refs = (_Atomic uint8_t *)(cache->slots + slots);
+    cache->mask = slots - 1;
+    cache->owned = false;
+    return true;
+}
+
+/**
+ * Writes the 16 byte fingerprint of an 81 char puzzle to `key`. '.' and '0'
+ * are treated as the same empty cell and every other non-digit packs to the
+ * same value, so a malformed puzzle never shares a key with a well formed
+ * one. The fingerprint is never all zeros.
+ */
+void puzzleKey(const char *puzzle, uint64_t key[2])
+{
+    //Pack the cells 16 to a word (6 words) and fold the words into two
+    //independently seeded hashes
+    uint64_t h1 = 0x9E3779B97F4A7C15ULL;
+    uint64_t h2 = 0xC2B2AE3D27D4EB4FULL;
+    uint64_t word = 0;
+    for(int i = 0; i < NUMCELLS; i++){
+        word = (word << 4) | CELLNIBBLE(puzzle[i]);
+        if(i % 16 == 15 || i == NUMCELLS - 1){
+            h1 = mix64(h1 ^ word);
+            h2 = mix64(h2 + word * 0xFF51AFD7ED558CCDULL);
+            word = 0;
+        }
+    }
+    key[0] = h1 | 1; //An empty slot has a zero key
+    key[1] = h2;
+}
+
+/**
+ * Looks up a puzzle. If it is cached its status is written to `status`, its
+ * solution (82 chars including the terminator) is written to `solution` and
+ * true is returned. The solution is only meaningful for answers that were
+ * inserted with one.
+ *
+ * Returns false if the puzzle is not cached or any argument is NULL.
+ */
+bool solutionLookup(SolutionCache *cache, const char *puzzle, int *status,
+                    char *solution)
+{
+    if(cache == NULL || puzzle == NULL || status == NULL || solution == NULL){
+        return false;
+    }
+    uint64_t key[2];
+    uint64_t data[5];
+    puzzleKey(puzzle, key);
+    size_t home = key[1] & cache->mask;
+    for(int way = 0; way < SOLCACHE_WAYS; way++){
+        size_t index = (home + way) & cache->mask;
+        if(readSlot(&cache->slots[index], key, data)){
+            if(atomic_load_explicit(&cache->refs[index],
+                                    memory_order_relaxed) == 0){
+                atomic_store_explicit(&cache->refs[index], 1,
+                                      memory_order_relaxed);
+            }
+            *status = (data[4] >> STATUSSHIFT) & 0xFF;
+            unpackSolution(data, solution);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Stores the answer to a puzzle, evicting another answer if the puzzle's
+ * slots are full. `solution` may be NULL for answers without a solution. The
+ * insert is skipped if another writer is changing the chosen slot.
+ */
+void solutionInsert(SolutionCache *cache, const char *puzzle, int status,
+                    const char *solution)
+{
+    if(cache == NULL || puzzle == NULL){
+        return;
+    }
+    uint64_t key[2];
+    puzzleKey(puzzle, key);
+
+    //Prefer the slot already holding this key, then an empty slot, then the
+    //first slot whose reference bit is clear
+    size_t home = key[1] & cache->mask;
+    size_t victim = SIZE_MAX;
+    for(int way = 0; way < SOLCACHE_WAYS && victim == SIZE_MAX; way++){
+        size_t index = (home + way) & cache->mask;
+        SolutionSlot *slot = &cache->slots[index];
+        uint64_t k0 = atomic_load_explicit(&slot->key[0], memory_order_relaxed);
+        uint64_t k1 = atomic_load_explicit(&slot->key[1], memory_order_relaxed);
+        if((k0 == key[0] && k1 == key[1]) || (k0 == 0 && k1 == 0)){
+            victim = index;
+        }
+    }
+    for(int sweep = 0; victim == SIZE_MAX; sweep++){
+        size_t index = (home + sweep % SOLCACHE_WAYS) & cache->mask;
+        if(atomic_exchange_explicit(&cache->refs[index], 0,
+                                    memory_order_relaxed) == 0 ||
+           sweep == 2 * SOLCACHE_WAYS){ //Readers keep setting the bits
+            victim = index;
+        }
+    }
+
+    uint64_t data[5] = {0};
+    if(solution != NULL){
+        for(int i = 0; i < PACKEDCELLS; i++){
+            data[i / 16] |= (uint64_t)(solution[i] - '0') << (4 * (i % 16));
+        }
+    }
+    data[4] |= (uint64_t)(status & 0xFF) << STATUSSHIFT;
+
+    SolutionSlot *slot = &cache->slots[victim];
+    uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    if((seq & 1) || !atomic_compare_exchange_strong_explicit(&slot->seq,
+                       &seq, seq + 1, memory_order_acquire,
+                       memory_order_relaxed)){
+        return; //Someone else is writing this slot
+    }
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&slot->key[0], key[0], memory_order_relaxed);
+    atomic_store_explicit(&slot->key[1], key[1], memory_order_relaxed);
+    for(int i = 0; i < 5; i++){
+        atomic_store_explicit(&slot->data[i], data[i], memory_order_relaxed);
+    }
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+    atomic_store_explicit(&cache->refs[victim], 0, memory_order_relaxed);
+}
+
+/**
+ * Frees a cache made by initSolutionCache. For caches set up with
+ * attachSolutionCache the memory belongs to the caller and is left alone. If
+ * the given cache is NULL this function does nothing.
+ */
+void deleteSolutionCache(SolutionCache *cache)
+{
+    if(cache == NULL){
+        return;
+    }
+    if(cache->owned){
+        free(cache->slots);
+        free(cache);
+    }
+}
+
+/**
+ * Returns the largest power of two number of slots that fit in `budget` bytes
+ * (counting each slot's reference byte) or 0 if fewer than SOLCACHE_WAYS fit.
+ */
+static size_t slotsForBudget(size_t budget)
+{
+    size_t fit = budget / (sizeof(SolutionSlot) + 1);
+    if(fit < SOLCACHE_WAYS){
+        return 0;
+    }
+    size_t slots = SOLCACHE_WAYS;
+    while(slots * 2 <= fit){
+        slots *= 2;
+    }
+    return slots;
+}
+
+/**
+ * Scrambles the bits of a word (the splitmix64 finalizer).
+ */
+static uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * Copies the data out of a slot if it holds `key`. Returns false if the slot
+ * holds another key or a writer changed it during the copy. A torn read is
+ * simply treated as a miss rather than waiting on the writer, which may be
+ * another process that has died mid-write.
+ */
+static bool readSlot(SolutionSlot *slot, const uint64_t key[2],
+                     uint64_t data[5])
+{
+    uint64_t before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if(before & 1){
+        return false;
+    }
+    uint64_t k0 = atomic_load_explicit(&slot->key[0], memory_order_relaxed);
+    uint64_t k1 = atomic_load_explicit(&slot->key[1], memory_order_relaxed);
+    if(k0 != key[0] || k1 != key[1]){
+        return false;
+    }
+    for(int i = 0; i < 5; i++){
+        data[i] = atomic_load_explicit(&slot->data[i], memory_order_relaxed);
+    }
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&slot->seq, memory_order_relaxed) == before;
+}
+
+/**
+ * Unpacks the first 8 rows of a solution and rebuilds the last row from the
+ * digit missing in each column. Writes 81 digits and a terminator.
+ */
+static void unpackSolution(const uint64_t data[5], char *solution)
+{
+    int colSums[BOARDSIZE] = {0};
+    for(int i = 0; i < PACKEDCELLS; i++){
+        int digit = (data[i / 16] >> (4 * (i % 16))) & 0xF;
+        solution[i] = '0' + digit;
+        colSums[i % BOARDSIZE] += digit;
+    }
+    for(int col = 0; col < BOARDSIZE; col++){
+        int missing = 45 - colSums[col]; //1 + 2 + ... + 9 = 45
+        solution[PACKEDCELLS + col] = '0' + (missing <= 9 ? missing : 0);
+    }
+    solution[NUMCELLS] = '\0';
+}
@@ -0,0 +1,119 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a fixed size cache of puzzle answers that many threads (or
+ * processes, when the cache lives in shared memory) can use at once.
+ *
+ * The cache is an open addressing hash table of 64 byte slots, one cache line
+ * each. A slot is keyed by a 16 byte fingerprint of the packed puzzle and
+ * holds the answer's status plus the solution packed 4 bits per cell. Only
+ * the first 8 rows of a solution are stored since the last row of a complete
+ * grid is just the digit each column is missing.
+ *
+ * Reads never write to the slot. Each slot has a sequence number that is odd
+ * while a writer is changing it, so a reader copies the slot and treats it as
+ * a miss if the sequence changed underneath it. Writers claim a slot by moving
+ * its sequence from even to odd with a CAS, and simply give up on the insert
+ * if another writer already holds it.
+ *
+ * A key may only live in the SOLCACHE_WAYS slots following its hash. When all
+ * of them are full the victim is chosen with the CLOCK (second chance) policy:
+ * every slot has a reference bit set on each hit and the first slot in the
+ * window whose bit is clear is evicted, clearing bits on the way.
+ */
+#ifndef SOLUTION_CACHE_H
+#define SOLUTION_CACHE_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include "./sudokuSolver.h"
+
+#define SOLCACHE_WAYS 8      //Slots a key may live in
+#define SOLCACHE_SLOTSIZE 64 //Bytes per slot
+
+typedef struct solutionSlot{
+    _Alignas(SOLCACHE_SLOTSIZE) _Atomic uint64_t seq; //Odd while written
+    _Atomic uint64_t key[2];  //Puzzle fingerprint, both 0 if the slot is empty
+    _Atomic uint64_t data[5]; //Packed solution rows 1 - 8 and the status
+}SolutionSlot;
+
+typedef struct solutionCache{
+    SolutionSlot *slots;
+    _Atomic uint8_t *refs; //CLOCK reference bit of each slot
+    size_t mask;           //Number of slots - 1 (always a power of two)
+    bool owned;            //Whether deleteSolutionCache frees the memory
+}SolutionCache;
+
+/********* function prototypes *********/
+
+size_t solutionCacheBytes(size_t budget);
+SolutionCache *initSolutionCache(size_t budget);
+bool attachSolutionCache(SolutionCache *cache, void *mem, size_t bytes,
+                         bool clear);
+void puzzleKey(const char *puzzle, uint64_t key[2]);
+bool solutionLookup(SolutionCache *cache, const char *puzzle, int *status,
+                    char *solution);
+void solutionInsert(SolutionCache *cache, const char *puzzle, int status,
+                    const char *solution);
+void deleteSolutionCache(SolutionCache *cache);
+
+/**
+ * Returns the number of bytes a cache will actually use when given a memory
+ * budget of `budget` bytes. The slot count is rounded down to a power of two
+ * so the result is never more than the budget. Returns 0 if the budget is too
+ * small to hold SOLCACHE_WAYS slots.
+ */
+size_t solutionCacheBytes(size_t budget);
+
+/**
+ * Allocates an empty cache that uses no more than `budget` bytes. Returns
+ * NULL if the budget is too small or the memory could not be allocated.
+ */
+SolutionCache *initSolutionCache(size_t budget);
+
+/**
+ * Sets `cache` up to use `bytes` bytes of memory starting at `mem` (which
+ * must be 64 byte aligned), for example memory shared between processes.
+ * If `clear` is true the memory is emptied first, otherwise whatever cache
+ * another process left there is used as is. Returns false if any pointer is
+ * NULL or `bytes` is too small.
+ */
+bool attachSolutionCache(SolutionCache *cache, void *mem, size_t bytes,
+                         bool clear);
+
+/**
+ * Writes the 16 byte fingerprint of an 81 char puzzle to `key`. '.' and '0'
+ * are treated as the same empty cell and every other non-digit packs to the
+ * same value, so a malformed puzzle never shares a key with a well formed
+ * one. The fingerprint is never all zeros.
+ */
+void puzzleKey(const char *puzzle, uint64_t key[2]);
+
+/**
+ * Looks up a puzzle. If it is cached its status is written to `status`, its
+ * solution (82 chars including the terminator) is written to `solution` and
+ * true is returned. The solution is only meaningful for answers that were
+ * inserted with one.
+ *
+ * Returns false if the puzzle is not cached or any argument is NULL.
+ */
+bool solutionLookup(SolutionCache *cache, const char *puzzle, int *status,
+                    char *solution);
+
+/**
+ * Stores the answer to a puzzle, evicting another answer if the puzzle's
+ * slots are full. `solution` may be NULL for answers without a solution. The
+ * insert is skipped if another writer is changing the chosen slot.
+ */
+void solutionInsert(SolutionCache *cache, const char *puzzle, int status,
+                    const char *solution);
+
+/**
+ * Frees a cache made by initSolutionCache. For caches set up with
+ * attachSolutionCache the memory belongs to the caller and is left alone. If
+ * the given cache is NULL this function does nothing.
+ */
+void deleteSolutionCache(SolutionCache *cache);
+
+#endif
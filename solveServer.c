@@ -0,0 +1,74 @@
+/**
+ * Serves solve requests from processes on the same machine over the shared
+ * memory interface in sudokuIpc. The server runs until it is interrupted
+ * (Ctrl-C or SIGTERM) at which point the segment is removed. Answers are
+ * kept in a cache inside the segment so that repeated requests (e.g. everyone
+ * fetching the daily puzzle) are answered by the clients themselves.
+ *
+ * Usage: ./solveServer [segment name] [cache MB]
+ *
+ * The segment name defaults to IPC_NAME and the cache size to
+ * IPC_CACHE_BYTES. A cache size of 0 disables the cache. Puzzles are solved
+ * under the thresholds in the engine config file if there is one. Exit
+ * statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The segment could not be created or another server is serving it
+ * 3 - The engine config could not be loaded
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "./sudokuIpc.h"
+#include "./sudokuEngine.h"
+
+static volatile sig_atomic_t running = 1;
+
+//function prototypes
+static void stopServer(int sig);
+
+int main(const int argc, const char *argv[])
+{
+    if(argc > 3){
+        fprintf(stderr, "usage: %s [segment name] [cache MB]\n", argv[0]);
+        exit(1);
+    }
+    const char *name = argc >= 2 ? argv[1] : IPC_NAME;
+    size_t cacheBytes = IPC_CACHE_BYTES;
+    if(argc == 3){
+        char *end;
+        long megabytes = strtol(argv[2], &end, 10);
+        if(*end != '\0' || megabytes < 0 ||
+           (unsigned long)megabytes > SIZE_MAX >> 20){
+            fprintf(stderr, "The cache size must be a number of megabytes\n");
+            exit(1);
+        }
+        cacheBytes = (size_t)megabytes << 20;
+    }
+    if(!loadStartupTuning()){
+        exit(3);
+    }
+
+    IpcSegment *seg = ipcCreate(name, cacheBytes);
+    if(seg == NULL){
+        fprintf(stderr, "Unable to create the segment %s\n", name);
+        exit(2);
+    }
+
+    //No SA_RESTART so that a signal wakes the server out of its futex sleep
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stopServer;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    ipcServe(seg, &running);
+    ipcDestroy(seg, name);
+    return 0;
+}
+
+/**
+ * Signal handler that asks ipcServe to return.
+ */
+static void stopServer(int sig)
+{
+    (void)sig;
+    running = 0;
+}
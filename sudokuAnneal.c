@@ -0,0 +1,670 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements the local search solver. See sudokuAnneal.h for how the search
+ * works. Every chain has its own copy of the grid and its own digit counts,
+ * so the chains share nothing while they run but the flag saying which one
+ * (if any) has won.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include <limits.h>
+#include <time.h>
+#include <threads.h>
+#include <stdatomic.h>
+#include "./sudokuAnneal.h"
+
+#define MAXSIDE (ANNEAL_MAX_BOX * ANNEAL_MAX_BOX)
+#define CONFLICT_TRIES 64 //Cells looked at for one whose digit is in conflict
+#define SAMPLE_MOVES 200 //Random moves the starting temperature is taken from
+
+typedef struct annealShared{
+    int boxSize;
+    int side;
+    int cells;
+    const uint8_t *values;    //The clues plus the singles
+    const uint64_t *cands;    //Digits each cell may hold next to those
+    uint8_t *solution;        //Written by the chain that wins
+    atomic_int winner;        //Chain that solved the grid, -1 until one does
+    atomic_bool stop;         //Set if the chains have to give up early
+    struct timespec deadline;
+    struct timespec solvedAt;
+    unsigned long seed;
+}AnnealShared;
+
+typedef struct annealChain{
+    AnnealShared *shared;
+    int id;
+    uint64_t random;       //State of the chain's random numbers
+    uint8_t *grid;
+    int *rowCount;         //Times each digit is in each row, at row*side+d-1
+    int *colCount;
+    int *boxFree;          //Cells of each box that are not clues
+    int *numFree;
+    int *movable;          //Boxes with at least two cells that are not clues
+    int numMovable;
+    unsigned long *tabuUntil; //Move count each cell is tabu until
+    unsigned long moves;
+    unsigned long reheats;
+    int cost;
+    int bestCost;
+}AnnealChain;
+
+/********* function prototypes *********/
+
+bool annealGrid(int boxSize, const uint8_t *values, uint8_t *solution,
+                int chains, unsigned long seed, double timeLimit,
+                AnnealStats *stats);
+static int fillSingles(int boxSize, uint8_t *grid, uint64_t *cands);
+static int runChain(void *arg);
+static bool initChain(AnnealChain *chain);
+static bool fillBox(AnnealChain *chain, int box);
+static bool augment(AnnealChain *chain, const int *open, int k, int *owner,
+                    bool *visited);
+static void freeChain(AnnealChain *chain);
+static double startTemperature(AnnealChain *chain);
+static bool pickMove(AnnealChain *chain, int *first, int *second);
+static bool inConflict(const AnnealChain *chain, int cell);
+static bool allowed(const AnnealChain *chain, int first, int second);
+static int swapDelta(const AnnealChain *chain, int first, int second);
+static int lineDelta(const int *counts, int out, int in);
+static void swapCells(AnnealChain *chain, int first, int second);
+static uint64_t nextRandom(uint64_t *state);
+static bool pastDeadline(const struct timespec *deadline);
+
+/**
+ * Solves a grid with boxes of `boxSize` by `boxSize` cells, given row by row
+ * in `values` (0 for an empty cell, digits 1 to boxSize^2), with `chains`
+ * chains of local search in parallel. `seed` makes runs repeatable (apart
+ * from which chain finishes first). On success the solution is written to
+ * `solution` in the same form and true is returned.
+ *
+ * This function will return false if either array is NULL, the box size or
+ * number of chains is out of range, the values are not legal, the singles
+ * show there is no solution, no chain found a solution within `timeLimit`
+ * seconds, or the memory or threads could not be had. If `stats` is not
+ * NULL the statistics of the search are written to it.
+ */
+bool annealGrid(int boxSize, const uint8_t *values, uint8_t *solution,
+                int chains, unsigned long seed, double timeLimit,
+                AnnealStats *stats)
+{
+    AnnealStats local;
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(AnnealStats));
+    stats->winner = -1;
+    stats->bestCost = -1; //0 would read as solved
+    if(values == NULL || solution == NULL || boxSize < ANNEAL_MIN_BOX ||
+       boxSize > ANNEAL_MAX_BOX || chains < 1 || chains > ANNEAL_MAX_CHAINS){
+        return false;
+    }
+    int side = boxSize * boxSize;
+    int cells = side * side;
+    uint8_t *start = malloc(cells);
+    uint64_t *cands = malloc(cells * sizeof(uint64_t));
+    if(start == NULL || cands == NULL){
+        free(start);
+        free(cands);
+        return false;
+    }
+    memcpy(start, values, cells);
+    stats->singles = fillSingles(boxSize, start, cands);
+    if(stats->singles < 0){
+        free(start);
+        free(cands);
+        return false;
+    }
+
+    AnnealShared shared;
+    AnnealChain chain[ANNEAL_MAX_CHAINS];
+    thrd_t threads[ANNEAL_MAX_CHAINS];
+    struct timespec began;
+    shared.boxSize = boxSize;
+    shared.side = side;
+    shared.cells = cells;
+    shared.values = start;
+    shared.cands = cands;
+    shared.solution = solution;
+    shared.seed = seed;
+    atomic_init(&shared.winner, -1);
+    atomic_init(&shared.stop, false);
+    clock_gettime(CLOCK_MONOTONIC, &began);
+    double whole = floor(timeLimit);
+    shared.deadline.tv_sec = began.tv_sec + (time_t)whole;
+    shared.deadline.tv_nsec = began.tv_nsec +
+                              (long)((timeLimit - whole) * 1e9);
+    if(shared.deadline.tv_nsec >= 1000000000L){
+        shared.deadline.tv_sec++;
+        shared.deadline.tv_nsec -= 1000000000L;
+    }
+
+    int started = 0;
+    for(; started < chains; started++){
+        chain[started].shared = &shared;
+        chain[started].id = started;
+        chain[started].moves = 0;
+        chain[started].reheats = 0;
+        chain[started].bestCost = INT_MAX; //Until the chain has a grid
+        if(thrd_create(&threads[started], runChain, &chain[started]) !=
+           thrd_success){
+            atomic_store(&shared.stop, true);
+            break;
+        }
+    }
+    stats->bestCost = INT_MAX;
+    for(int c = 0; c < started; c++){
+        thrd_join(threads[c], NULL);
+        stats->moves += chain[c].moves;
+        stats->reheats += chain[c].reheats;
+        if(chain[c].bestCost < stats->bestCost){
+            stats->bestCost = chain[c].bestCost;
+        }
+    }
+    if(stats->bestCost == INT_MAX){
+        stats->bestCost = -1;
+    }
+    stats->chains = started;
+    stats->winner = atomic_load(&shared.winner);
+
+    struct timespec ended = shared.solvedAt;
+    if(stats->winner < 0){
+        clock_gettime(CLOCK_MONOTONIC, &ended);
+    }
+    stats->seconds = (ended.tv_sec - began.tv_sec) +
+                     (ended.tv_nsec - began.tv_nsec) / 1e9;
+    free(start);
+    free(cands);
+    return stats->winner >= 0;
+}
+
+/**
+ * Fills every naked and hidden single of the grid (and those they lead to)
+ * in place and writes the candidates left to each cell to `cands` (just its
+ * own digit for a filled cell). Returns the number of cells filled, or -1 if
+ * the values are not legal, some empty cell has no candidate left or some
+ * unit has no place left for a digit it is missing.
+ */
+static int fillSingles(int boxSize, uint8_t *grid, uint64_t *cands)
+{
+    int side = boxSize * boxSize;
+    uint64_t all = side == 64 ? ~(uint64_t)0 : ((uint64_t)1 << side) - 1;
+    uint64_t rows[MAXSIDE] = {0};
+    uint64_t cols[MAXSIDE] = {0};
+    uint64_t boxes[MAXSIDE] = {0};
+    for(int i = 0; i < side * side; i++){
+        int row = i / side;
+        int col = i % side;
+        int box = (row / boxSize) * boxSize + col / boxSize;
+        if(grid[i] > side){
+            return -1;
+        }
+        if(grid[i] != 0){
+            uint64_t bit = (uint64_t)1 << (grid[i] - 1);
+            if((rows[row] | cols[col] | boxes[box]) & bit){
+                return -1;
+            }
+            rows[row] |= bit;
+            cols[col] |= bit;
+            boxes[box] |= bit;
+        }
+    }
+
+    int filled = 0;
+    bool changed = true;
+    while(changed){
+        changed = false;
+        for(int i = 0; i < side * side; i++){
+            int row = i / side;
+            int col = i % side;
+            int box = (row / boxSize) * boxSize + col / boxSize;
+            if(grid[i] != 0){
+                continue;
+            }
+            cands[i] = all & ~(rows[row] | cols[col] | boxes[box]);
+            if(cands[i] == 0){
+                return -1;
+            }
+            if((cands[i] & (cands[i] - 1)) == 0){
+                grid[i] = __builtin_ctzll(cands[i]) + 1;
+                rows[row] |= cands[i];
+                cols[col] |= cands[i];
+                boxes[box] |= cands[i];
+                filled++;
+                changed = true;
+            }
+        }
+        //Hidden singles are only looked for once no naked ones are left
+        for(int unit = 0; unit < 3 * side && !changed; unit++){
+            int where[MAXSIDE];
+            int places[MAXSIDE] = {0};
+            for(int k = 0; k < side; k++){
+                int row = unit < side ? unit : unit < 2 * side ?
+                          k : (unit - 2 * side) / boxSize * boxSize +
+                          k / boxSize;
+                int col = unit < side ? k : unit < 2 * side ?
+                          unit - side : (unit - 2 * side) % boxSize *
+                          boxSize + k % boxSize;
+                int i = row * side + col;
+                if(grid[i] != 0){
+                    places[grid[i] - 1] = -1;
+                    continue;
+                }
+                for(uint64_t left = cands[i]; left != 0; left &= left - 1){
+                    int d = __builtin_ctzll(left);
+                    if(places[d] >= 0){
+                        places[d]++;
+                        where[d] = i;
+                    }
+                }
+            }
+            for(int d = 0; d < side; d++){
+                if(places[d] == 0){
+                    return -1;
+                }
+                if(places[d] == 1){
+                    int i = where[d];
+                    int row = i / side;
+                    int col = i % side;
+                    int box = (row / boxSize) * boxSize + col / boxSize;
+                    uint64_t bit = (uint64_t)1 << d;
+                    if(grid[i] != 0 ||
+                       ((rows[row] | cols[col] | boxes[box]) & bit)){
+                        return -1; //Two digits are hidden singles of a cell
+                    }
+                    grid[i] = d + 1;
+                    rows[row] |= bit;
+                    cols[col] |= bit;
+                    boxes[box] |= bit;
+                    filled++;
+                    changed = true;
+                }
+            }
+        }
+    }
+    for(int i = 0; i < side * side; i++){
+        if(grid[i] != 0){
+            cands[i] = (uint64_t)1 << (grid[i] - 1);
+        }
+    }
+    return filled;
+}
+
+/**
+ * Thread body running one chain until it or another chain solves the grid,
+ * the deadline passes or the chains are stopped. Always returns 0, a chain
+ * that could not get its memory simply never finds anything.
+ */
+static int runChain(void *arg)
+{
+    AnnealChain *chain = arg;
+    AnnealShared *shared = chain->shared;
+    if(!initChain(chain)){
+        return 0;
+    }
+
+    //A round is long enough for every pair in every box to be tried once
+    long roundLength = 0;
+    for(int b = 0; b < chain->numMovable; b++){
+        long open = chain->numFree[chain->movable[b]];
+        roundLength += open * open;
+    }
+    double start = startTemperature(chain);
+    double temperature = start;
+    int stale = 0; //Rounds since the last new best
+    while(chain->cost > 0 && chain->numMovable > 0 &&
+          atomic_load(&shared->winner) < 0 && !atomic_load(&shared->stop) &&
+          !pastDeadline(&shared->deadline)){
+        bool improved = false;
+        for(long m = 0; m < roundLength && chain->cost > 0; m++){
+            int first;
+            int second;
+            pickMove(chain, &first, &second);
+            chain->moves++;
+            if(!allowed(chain, first, second)){
+                continue;
+            }
+            int delta = swapDelta(chain, first, second);
+            bool tabu = chain->moves < chain->tabuUntil[first] ||
+                        chain->moves < chain->tabuUntil[second];
+            if(tabu && chain->cost + delta >= chain->bestCost){
+                continue;
+            }
+            if(delta > 0 && (nextRandom(&chain->random) >> 11) /
+               9007199254740992.0 >= exp(-delta / temperature)){
+                continue;
+            }
+            swapCells(chain, first, second);
+            chain->cost += delta;
+            chain->tabuUntil[first] = chain->moves + ANNEAL_TABU;
+            chain->tabuUntil[second] = chain->moves + ANNEAL_TABU;
+            if(chain->cost < chain->bestCost){
+                chain->bestCost = chain->cost;
+                improved = true;
+            }
+        }
+        temperature *= ANNEAL_COOLING;
+        stale = improved ? 0 : stale + 1;
+        if(stale >= ANNEAL_REHEAT){
+            temperature = start;
+            stale = 0;
+            chain->reheats++;
+        }
+    }
+
+    int none = -1;
+    if(chain->cost == 0 &&
+       atomic_compare_exchange_strong(&shared->winner, &none, chain->id)){
+        clock_gettime(CLOCK_MONOTONIC, &shared->solvedAt);
+        memcpy(shared->solution, chain->grid, shared->cells);
+    }
+    freeChain(chain);
+    return 0;
+}
+
+/**
+ * Gives the chain its random numbers, fills every box with its missing
+ * digits at random (each in a cell it is a candidate of) and counts the
+ * digits and the cost of the result. Returns false (with everything freed)
+ * if the memory could not be had or some box has no such filling, in which
+ * case the grid has no solution.
+ */
+static bool initChain(AnnealChain *chain)
+{
+    AnnealShared *shared = chain->shared;
+    int side = shared->side;
+    int boxSize = shared->boxSize;
+    chain->random = (shared->seed + 1) * 0x9E3779B97F4A7C15ULL ^
+                    (chain->id + 1) * 0xBF58476D1CE4E5B9ULL;
+    if(chain->random == 0){
+        chain->random = 1;
+    }
+    chain->grid = malloc(shared->cells);
+    chain->rowCount = calloc(shared->cells, sizeof(int));
+    chain->colCount = calloc(shared->cells, sizeof(int));
+    chain->boxFree = malloc(shared->cells * sizeof(int));
+    chain->numFree = calloc(side, sizeof(int));
+    chain->movable = malloc(side * sizeof(int));
+    chain->tabuUntil = calloc(shared->cells, sizeof(unsigned long));
+    if(chain->grid == NULL || chain->rowCount == NULL ||
+       chain->colCount == NULL || chain->boxFree == NULL ||
+       chain->numFree == NULL || chain->movable == NULL ||
+       chain->tabuUntil == NULL){
+        freeChain(chain);
+        return false;
+    }
+    memcpy(chain->grid, shared->values, shared->cells);
+
+    chain->numMovable = 0;
+    for(int box = 0; box < side; box++){
+        int *open = chain->boxFree + box * side;
+        for(int k = 0; k < side; k++){
+            int row = (box / boxSize) * boxSize + k / boxSize;
+            int col = (box % boxSize) * boxSize + k % boxSize;
+            int cell = row * side + col;
+            if(chain->grid[cell] == 0){
+                open[chain->numFree[box]++] = cell;
+            }
+        }
+        if(!fillBox(chain, box)){
+            freeChain(chain);
+            return false;
+        }
+        if(chain->numFree[box] >= 2){
+            chain->movable[chain->numMovable++] = box;
+        }
+    }
+
+    for(int i = 0; i < shared->cells; i++){
+        int digit = chain->grid[i] - 1;
+        chain->rowCount[(i / side) * side + digit]++;
+        chain->colCount[(i % side) * side + digit]++;
+    }
+    chain->cost = 0;
+    for(int i = 0; i < shared->cells; i++){
+        chain->cost += (chain->rowCount[i] == 0) + (chain->colCount[i] == 0);
+    }
+    chain->bestCost = chain->cost;
+    return true;
+}
+
+/**
+ * Fills the empty cells of a box with the digits it is missing, each in a
+ * cell it is a candidate of, by finding a random perfect matching between
+ * the cells and the digits with augmenting paths. Returns false if there is
+ * no such matching.
+ */
+static bool fillBox(AnnealChain *chain, int box)
+{
+    int side = chain->shared->side;
+    int count = chain->numFree[box];
+    int *open = chain->boxFree + box * side;
+    int owner[MAXSIDE]; //Index in `open` of the cell holding each digit
+    for(int d = 0; d < side; d++){
+        owner[d] = -1;
+    }
+    //The cells are shuffled so that the matching found differs every time
+    for(int k = count - 1; k > 0; k--){
+        int j = nextRandom(&chain->random) % (k + 1);
+        int swap = open[k];
+        open[k] = open[j];
+        open[j] = swap;
+    }
+    for(int k = 0; k < count; k++){
+        bool visited[MAXSIDE] = {false};
+        if(!augment(chain, open, k, owner, visited)){
+            return false;
+        }
+    }
+    for(int d = 0; d < side; d++){
+        if(owner[d] >= 0){
+            chain->grid[open[owner[d]]] = d + 1;
+        }
+    }
+    return true;
+}
+
+/**
+ * Looks for a digit for cell `open[k]`, taking it from the cell that owns it
+ * if that cell can move on to another digit in turn. Digits are tried from a
+ * random one on. Returns true if the cell got a digit.
+ */
+static bool augment(AnnealChain *chain, const int *open, int k, int *owner,
+                    bool *visited)
+{
+    int side = chain->shared->side;
+    uint64_t cands = chain->shared->cands[open[k]];
+    int first = nextRandom(&chain->random) % side;
+    for(int j = 0; j < side; j++){
+        int d = (first + j) % side;
+        if(!(cands & ((uint64_t)1 << d)) || visited[d]){
+            continue;
+        }
+        visited[d] = true;
+        if(owner[d] < 0 || augment(chain, open, owner[d], owner, visited)){
+            owner[d] = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Frees everything a chain holds. Safe on a chain initChain gave up on.
+ */
+static void freeChain(AnnealChain *chain)
+{
+    free(chain->grid);
+    free(chain->rowCount);
+    free(chain->colCount);
+    free(chain->boxFree);
+    free(chain->numFree);
+    free(chain->movable);
+    free(chain->tabuUntil);
+    chain->grid = NULL;
+    chain->rowCount = NULL;
+    chain->colCount = NULL;
+    chain->boxFree = NULL;
+    chain->numFree = NULL;
+    chain->movable = NULL;
+    chain->tabuUntil = NULL;
+}
+
+/**
+ * Returns the standard deviation of the change in cost of SAMPLE_MOVES
+ * random moves (none of them made), or 1 if they all change it equally.
+ */
+static double startTemperature(AnnealChain *chain)
+{
+    double sum = 0;
+    double squares = 0;
+    int first;
+    int second;
+    if(chain->numMovable == 0){
+        return 1;
+    }
+    int sampled = 0;
+    for(int m = 0; m < SAMPLE_MOVES; m++){
+        pickMove(chain, &first, &second);
+        if(allowed(chain, first, second)){
+            double delta = swapDelta(chain, first, second);
+            sum += delta;
+            squares += delta * delta;
+            sampled++;
+        }
+    }
+    if(sampled == 0){
+        return 1;
+    }
+    double mean = sum / sampled;
+    double spread = sqrt(squares / sampled - mean * mean);
+    return spread > 0 ? spread : 1;
+}
+
+/**
+ * Picks two different cells that are not clues from a random box with at
+ * least two of them. Returns false if there is no such box.
+ */
+static bool pickMove(AnnealChain *chain, int *first, int *second)
+{
+    if(chain->numMovable == 0){
+        return false;
+    }
+    int side = chain->shared->side;
+    int box = 0;
+    int count = 0;
+    int a = 0;
+    for(int tries = 0; tries < CONFLICT_TRIES; tries++){
+        box = chain->movable[nextRandom(&chain->random) % chain->numMovable];
+        count = chain->numFree[box];
+        a = nextRandom(&chain->random) % count;
+        if(inConflict(chain, chain->boxFree[box * side + a])){
+            break;
+        }
+    }
+    int b = nextRandom(&chain->random) % (count - 1);
+    b += b >= a; //Skips over a so the two always differ
+    *first = chain->boxFree[box * side + a];
+    *second = chain->boxFree[box * side + b];
+    return true;
+}
+
+/**
+ * Returns true if the digit of the cell is also in another cell of its row
+ * or column.
+ */
+static bool inConflict(const AnnealChain *chain, int cell)
+{
+    int side = chain->shared->side;
+    int digit = chain->grid[cell] - 1;
+    return chain->rowCount[(cell / side) * side + digit] > 1 ||
+           chain->colCount[(cell % side) * side + digit] > 1;
+}
+
+/**
+ * Returns true if each of the two cells may take the other's digit.
+ */
+static bool allowed(const AnnealChain *chain, int first, int second)
+{
+    const uint64_t *cands = chain->shared->cands;
+    return (cands[first] >> (chain->grid[second] - 1) & 1) &&
+           (cands[second] >> (chain->grid[first] - 1) & 1);
+}
+
+/**
+ * Returns the change in cost swapping the two cells would make, looking only
+ * at the rows and columns they are in.
+ */
+static int swapDelta(const AnnealChain *chain, int first, int second)
+{
+    int side = chain->shared->side;
+    int a = chain->grid[first];
+    int b = chain->grid[second];
+    int delta = 0;
+    if(first / side != second / side){
+        delta += lineDelta(chain->rowCount + (first / side) * side, a, b);
+        delta += lineDelta(chain->rowCount + (second / side) * side, b, a);
+    }
+    if(first % side != second % side){
+        delta += lineDelta(chain->colCount + (first % side) * side, a, b);
+        delta += lineDelta(chain->colCount + (second % side) * side, b, a);
+    }
+    return delta;
+}
+
+/**
+ * Returns the change in the digits missing from a row or column with the
+ * given digit counts when digit `out` is replaced by a different digit `in`.
+ */
+static int lineDelta(const int *counts, int out, int in)
+{
+    return (counts[out - 1] == 1) - (counts[in - 1] == 0);
+}
+
+/**
+ * Swaps the digits of two cells in the same box, keeping the row and column
+ * counts up to date.
+ */
+static void swapCells(AnnealChain *chain, int first, int second)
+{
+    int side = chain->shared->side;
+    int a = chain->grid[first];
+    int b = chain->grid[second];
+    chain->rowCount[(first / side) * side + a - 1]--;
+    chain->rowCount[(first / side) * side + b - 1]++;
+    chain->rowCount[(second / side) * side + b - 1]--;
+    chain->rowCount[(second / side) * side + a - 1]++;
+    chain->colCount[(first % side) * side + a - 1]--;
+    chain->colCount[(first % side) * side + b - 1]++;
+    chain->colCount[(second % side) * side + b - 1]--;
+    chain->colCount[(second % side) * side + a - 1]++;
+    chain->grid[first] = b;
+    chain->grid[second] = a;
+}
+
+/**
+ * Returns the next number of an xorshift64* generator.
+ */
+static uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * Returns true if the monotonic clock is past the given time.
+ */
+static bool pastDeadline(const struct timespec *deadline)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > deadline->tv_sec ||
+           (now.tv_sec == deadline->tv_sec &&
+            now.tv_nsec >= deadline->tv_nsec);
+}
@@ -0,0 +1,87 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a local search solver for large grids, which an exact search
+ * can take hours over. It solves 16x16 grids in well under a second and
+ * some 25x25 grids in seconds, but it is not dependable from 25x25 up:
+ * on 25x25 and 36x36 grids with about half of the cells given a minute of
+ * search on one CPU can stall with a few conflicts left. megaSolve -x runs
+ * the exact SAT engine instead, for boxes up to SAT_MAX_BOX.
+ *
+ * Rather than filling cells one at a time it starts from a full grid and
+ * repairs it: after filling the naked and hidden singles every box gets its
+ * missing digits at random, each in a cell it is still a candidate of, so
+ * the boxes are always right and only the rows and columns have conflicts.
+ * The cost of a grid is the number of digits missing from its rows plus
+ * those missing from its columns, and a grid with cost 0 is a solution.
+ *
+ * A move swaps two cells of the same box that are not clues, as long as each
+ * digit stays among the candidates of its new cell, which keeps the search
+ * away from grids the clues already rule out. The first cell of a move is
+ * one whose digit is repeated in its row or column whenever such a cell turns
+ * up in up to 64 random picks, so the moves go where the conflicts are. The
+ * solver keeps a count of every digit in every row and column, so the change
+ * in cost of a swap only looks at the two digits in the two rows and two
+ * columns it touches, and takes the same few steps on a 64x64 grid as on a
+ * 9x9 one. Moves are accepted by simulated annealing: always if they do not
+ * raise the cost, otherwise with probability exp(-delta / temperature). The
+ * temperature starts at the spread of the costs of random moves, is lowered
+ * by ANNEAL_COOLING after every round of moves, and is raised back to its
+ * start when ANNEAL_REHEAT rounds pass without a new best grid. A cell that
+ * was just moved is tabu for ANNEAL_TABU moves unless moving it again beats
+ * the best grid, which stops two cells from being swapped back and forth.
+ *
+ * Each chain is a separate search with its own random numbers, and the
+ * chains run in parallel threads until one of them solves the grid or the
+ * time limit runs out. Local search can not prove that a grid has no
+ * solution, so running out of time is the only way it gives up.
+ */
+#ifndef SUDOKU_ANNEAL_H
+#define SUDOKU_ANNEAL_H
+
+#include "./sudokuBoard.h"
+
+#define ANNEAL_MIN_BOX 2     //Smallest box size accepted (a 4x4 grid)
+#define ANNEAL_MAX_BOX 8     //Largest box size accepted (a 64x64 grid)
+#define ANNEAL_MAX_CHAINS 64
+#define ANNEAL_COOLING 0.99  //Factor the temperature drops by each round
+#define ANNEAL_REHEAT 100    //Rounds without a new best before reheating
+#define ANNEAL_TABU 8        //Moves a cell stays tabu after it moved
+
+typedef struct annealStats{
+    int chains;            //Chains that ran
+    int winner;            //Chain that solved the grid, -1 if none did
+    int bestCost;          //Lowest cost any chain reached, 0 if solved and
+                           //-1 if no chain got started
+    int singles;           //Cells filled as singles before searching, -1
+                           //if the values or singles contradicted
+    unsigned long moves;   //Moves tried by all chains together
+    unsigned long reheats; //Times any chain was reheated
+    double seconds;        //Time until the solution, or until giving up
+}AnnealStats;
+
+/********* function prototypes *********/
+
+bool annealGrid(int boxSize, const uint8_t *values, uint8_t *solution,
+                int chains, unsigned long seed, double timeLimit,
+                AnnealStats *stats);
+
+/**
+ * Solves a grid with boxes of `boxSize` by `boxSize` cells, given row by row
+ * in `values` (0 for an empty cell, digits 1 to boxSize^2), with `chains`
+ * chains of local search in parallel. `seed` makes runs repeatable (apart
+ * from which chain finishes first). On success the solution is written to
+ * `solution` in the same form and true is returned.
+ *
+ * This function will return false if either array is NULL, the box size or
+ * number of chains is out of range, the values are not legal, the singles
+ * show there is no solution, no chain found a solution within `timeLimit`
+ * seconds, or the memory or threads could not be had. If `stats` is not
+ * NULL the statistics of the search are written to it.
+ */
+bool annealGrid(int boxSize, const uint8_t *values, uint8_t *solution,
+                int chains, unsigned long seed, double timeLimit,
+                AnnealStats *stats);
+
+#endif
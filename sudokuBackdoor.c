@@ -0,0 +1,244 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements the backdoor search and the branching profile. See
+ * sudokuBackdoor.h for what they measure.
+ *
+ * The backdoor search runs the singles pass through propagateValues, one
+ * call per set of cells. The profile runs searchUnits on the grid's units
+ * with a pass that counts each node as the search reaches it. Each thread
+ * writes the backdoor it finds into the row of the job (first cell) it was
+ * found under, and the earliest first cell with a backdoor is kept with an
+ * atomic minimum, so nothing else is shared.
+ */
+#include <threads.h>
+#include <stdatomic.h>
+#include "./sudokuBackdoor.h"
+
+typedef struct doorSearch{
+    uint8_t start[NUMCELLS];    //The puzzle after the singles pass
+    uint8_t solution[NUMCELLS];
+    uint8_t cands[NUMCELLS];    //Cells the pass leaves empty, in order
+    int numCands;
+    int size;                   //Size of the sets being tried
+    atomic_int nextJob;
+    atomic_int firstFound;      //Earliest job with a backdoor, or numCands
+    uint8_t found[NUMCELLS][BACKDOOR_MAX_SIZE]; //Backdoor found by each job
+    unsigned long tried[BACKDOOR_MAX_THREADS];
+}DoorSearch;
+
+typedef struct doorWorker{
+    DoorSearch *search;
+    int id;
+}DoorWorker;
+
+/********* function prototypes *********/
+
+int findBackdoor(const uint8_t *values, int maxSize, int threads,
+                 Backdoor *backdoor);
+bool branchProfile(const uint8_t *values, BranchProfile *profile);
+static int searchDoors(void *arg);
+static bool trySets(DoorSearch *search, int job, const uint8_t *values,
+                    uint8_t *chosen, int have, int from, unsigned long *tried);
+static bool profilePass(const UnitGraph *graph, const UnitView *view,
+                        int depth, const void *arg);
+
+/**
+ * Finds the smallest backdoor of the puzzle given as 81 cell values (0 for an
+ * empty cell) with at most `maxSize` cells, searching each size over
+ * `threads` threads, and writes it to `backdoor`. The values come from the
+ * first solution solveValues finds, so a puzzle with several solutions has
+ * the backdoor of that one.
+ *
+ * Returns 1 once the backdoor is written, 0 if the values are not legal or
+ * the puzzle has no solution and -1 if an argument is NULL or out of range or
+ * the search could not be allocated or started.
+ */
+int findBackdoor(const uint8_t *values, int maxSize, int threads,
+                 Backdoor *backdoor)
+{
+    if(values == NULL || backdoor == NULL || maxSize < 0 ||
+       maxSize > BACKDOOR_MAX_SIZE || threads < 1 ||
+       threads > BACKDOOR_MAX_THREADS){
+        return -1;
+    }
+    DoorSearch *search = malloc(sizeof(DoorSearch));
+    if(search == NULL){
+        return -1;
+    }
+    if(!solveValues(values, search->solution, NULL) ||
+       propagateValues(values, search->start) < 0){
+        free(search);
+        return 0;
+    }
+    search->numCands = 0;
+    for(int i = 0; i < NUMCELLS; i++){
+        if(search->start[i] == 0){
+            search->cands[search->numCands++] = i;
+        }
+    }
+    backdoor->size = search->numCands == 0 ? 0 : -1;
+    backdoor->tried = 1;
+
+    DoorWorker workers[BACKDOOR_MAX_THREADS];
+    thrd_t ids[BACKDOOR_MAX_THREADS];
+    for(int size = 1; backdoor->size == -1 && size <= maxSize; size++){
+        search->size = size;
+        atomic_store(&search->nextJob, 0);
+        atomic_store(&search->firstFound, search->numCands);
+        memset(search->tried, 0, sizeof(search->tried));
+        int started = 0;
+        //A size small enough to try in a blink is not worth the threads
+        if(threads == 1 || size == 1){
+            workers[0].search = search;
+            workers[0].id = 0;
+            searchDoors(&workers[0]);
+            started = 1;
+        }
+        else{
+            for(; started < threads; started++){
+                workers[started].search = search;
+                workers[started].id = started;
+                if(thrd_create(&ids[started], searchDoors,
+                               &workers[started]) != thrd_success){
+                    break;
+                }
+            }
+            for(int t = 0; t < started; t++){
+                thrd_join(ids[t], NULL);
+            }
+        }
+        if(started == 0){
+            free(search);
+            return -1;
+        }
+        for(int t = 0; t < started; t++){
+            backdoor->tried += search->tried[t];
+        }
+        int first = atomic_load(&search->firstFound);
+        if(first < search->numCands){
+            backdoor->size = size;
+            memcpy(backdoor->cells, search->found[first], size);
+        }
+    }
+    free(search);
+    return 1;
+}
+
+/**
+ * Writes the branching profile of solveValuesPropagate on the puzzle given as
+ * 81 cell values to `profile`. Returns false if either argument is NULL, the
+ * values are not legal or the puzzle has no solution.
+ */
+bool branchProfile(const uint8_t *values, BranchProfile *profile)
+{
+    if(profile == NULL || !checkValues(values)){
+        return false;
+    }
+    memset(profile, 0, sizeof(BranchProfile));
+    uint8_t grid[NUMCELLS] = {0};
+    uint16_t used[3 * BOARDSIZE] = {0};
+    UnitView view = {grid, NULL, used};
+    for(int i = 0; i < NUMCELLS; i++){
+        if(values[i] != 0){
+            placeUnitDigit(gridUnits(), &view, i, values[i]);
+        }
+    }
+    SolverStats stats = {0};
+    long found = searchUnits(gridUnits(), &view, profilePass, profile, 1,
+                             &stats);
+    profile->nodes = stats.nodes;
+    profile->guesses = stats.guesses;
+    return found == 1;
+}
+
+/**
+ * Thread body: claims first cells one at a time and tries every set of the
+ * current size starting with each, until the cells run out or pass the
+ * earliest one a backdoor has been found under.
+ */
+static int searchDoors(void *arg)
+{
+    DoorWorker *worker = arg;
+    DoorSearch *search = worker->search;
+    int job;
+    while((job = atomic_fetch_add(&search->nextJob, 1)) < search->numCands &&
+          job < atomic_load(&search->firstFound)){
+        uint8_t chosen[BACKDOOR_MAX_SIZE];
+        if(trySets(search, job, search->start, chosen, 0, job,
+                   &search->tried[worker->id])){
+            int first = atomic_load(&search->firstFound);
+            while(job < first &&
+                  !atomic_compare_exchange_weak(&search->firstFound, &first,
+                                                job)){
+                continue;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Tries every way of adding cells from cands[from] on to the `have` cells
+ * already given in `values` (as left by the singles pass) until there are as
+ * many as the search's size. Returns true, with the cells written to the
+ * job's row of found backdoors, as soon as one leaves the pass with nothing
+ * to fill.
+ */
+static bool trySets(DoorSearch *search, int job, const uint8_t *values,
+                    uint8_t *chosen, int have, int from, unsigned long *tried)
+{
+    for(int k = from; k < search->numCands; k++){
+        int cell = search->cands[k];
+        if(values[cell] != 0){ //The pass filled it, so the set is smaller
+            continue;
+        }
+        uint8_t given[NUMCELLS];
+        uint8_t next[NUMCELLS];
+        memcpy(given, values, NUMCELLS);
+        given[cell] = search->solution[cell];
+        propagateValues(given, next);
+        (*tried)++;
+        chosen[have] = cell;
+        if(memchr(next, 0, NUMCELLS) == NULL){
+            memcpy(search->found[job], chosen, have + 1);
+            return true;
+        }
+        if(have + 1 < search->size &&
+           trySets(search, job, next, chosen, have + 1, k + 1, tried)){
+            return true;
+        }
+        if(have == 0){ //Only the job's own first cell starts its sets
+            break;
+        }
+        if(job > atomic_load(&search->firstFound)){
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * The pass searchUnits runs on every node of the profile: the singles pass,
+ * then, if the node will branch, a record of how many candidates it branches
+ * on and how deep it is.
+ */
+static bool profilePass(const UnitGraph *graph, const UnitView *view,
+                        int depth, const void *arg)
+{
+    BranchProfile *profile = (BranchProfile *)arg;
+    if(!propagateUnits(graph, view)){
+        return false;
+    }
+    uint16_t cands;
+    if(pickUnitCell(graph, view, 2, &cands) == -1){
+        return true;
+    }
+    profile->widths[__builtin_popcount(cands)]++;
+    profile->depths[depth]++;
+    if(depth > profile->maxDepth){
+        profile->maxDepth = depth;
+    }
+    return true;
+}
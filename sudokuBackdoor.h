@@ -0,0 +1,83 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements two measures of how hard a puzzle is for the solver, used to
+ * predict what a request will cost before it is routed.
+ *
+ * The backdoor of a puzzle is the smallest set of empty cells that, once
+ * given their values from the solution, leaves a puzzle the singles pass
+ * alone can finish. A puzzle singles can already solve has a backdoor of
+ * size 0, and every guess the solver has to get right shows up as a cell of
+ * it. The sets of k cells are tried for k = 1, 2, ... in turn, with three
+ * things keeping the count of sets down:
+ *
+ *  - the singles pass runs on the puzzle first and only the cells it leaves
+ *    empty are tried, since giving a cell the pass would fill anyway changes
+ *    nothing,
+ *  - each set is built one cell at a time and the pass run again after each
+ *    one, from where it stood before the cell, so a set costs one pass and
+ *    not k, and
+ *  - a cell the pass has filled by then is not added, as that set is the
+ *    same as the smaller one already tried.
+ *
+ * Each size is shared out over threads by the first cell of the sets, which
+ * stop trying sets whose first cell comes after the earliest one a backdoor
+ * was found under, so the backdoor reported is always the first in order.
+ *
+ * The branching profile is the shape of the search solveValuesPropagate does
+ * on the puzzle, which it follows step for step: the number of nodes, how
+ * many candidates each branched on and how deep each was.
+ */
+#ifndef SUDOKU_BACKDOOR_H
+#define SUDOKU_BACKDOOR_H
+
+#include "./sudokuSolver.h"
+
+#define BACKDOOR_MAX_THREADS 64
+#define BACKDOOR_MAX_SIZE 8 //Largest backdoor searched for
+
+typedef struct backdoor{
+    int size;                       //Cells in the backdoor, -1 if it has more
+                                    //than the largest size searched
+    uint8_t cells[BACKDOOR_MAX_SIZE];
+    unsigned long tried;            //Sets of cells the pass was run on
+}Backdoor;
+
+typedef struct branchProfile{
+    unsigned long nodes;                 //Cells branched on
+    unsigned long guesses;               //Values tried in those cells
+    int maxDepth;                        //Most guesses on the path to a node
+    unsigned long widths[BOARDSIZE + 1]; //Nodes by how many candidates they
+                                         //branched on
+    unsigned long depths[NUMCELLS];      //Nodes at each depth
+}BranchProfile;
+
+/********* function prototypes *********/
+
+int findBackdoor(const uint8_t *values, int maxSize, int threads,
+                 Backdoor *backdoor);
+bool branchProfile(const uint8_t *values, BranchProfile *profile);
+
+/**
+ * Finds the smallest backdoor of the puzzle given as 81 cell values (0 for an
+ * empty cell) with at most `maxSize` cells, searching each size over
+ * `threads` threads, and writes it to `backdoor`. The values come from the
+ * first solution solveValues finds, so a puzzle with several solutions has
+ * the backdoor of that one.
+ *
+ * Returns 1 once the backdoor is written, 0 if the values are not legal or
+ * the puzzle has no solution and -1 if an argument is NULL or out of range or
+ * the search could not be allocated or started.
+ */
+int findBackdoor(const uint8_t *values, int maxSize, int threads,
+                 Backdoor *backdoor);
+
+/**
+ * Writes the branching profile of solveValuesPropagate on the puzzle given as
+ * 81 cell values to `profile`. Returns false if either argument is NULL, the
+ * values are not legal or the puzzle has no solution.
+ */
+bool branchProfile(const uint8_t *values, BranchProfile *profile);
+
+#endif
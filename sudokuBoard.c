@@ -3,8 +3,9 @@
  * Date: 08/26/19
  * 
  * Implements a sudoku board as a 9x9 grouping of 'Cell' types. Each cell type
- * consists of the current value within that cell (0 if not initalized) and
- * whether or not that value is original (was given as a clue).
+ * consists of the current value within that cell (0 if not initalized),
+ * whether or not that value is original (was given as a clue) and the pencil
+ * marks the player has made in it.
  * 
  * To initialze a board that represents a given sudoku construction/puzzle. 
  * A string of length 81 (excluding terminator) that row by row represents the
@@ -18,20 +19,37 @@
  * traditionally examined in linear algebra. That is all declarations are in
  * [row][col] format.
  * 
+ * Every board also keeps a 64 bit Zobrist hash of its values: the XOR of a
+ * fixed random key for each (cell, value) pair on the board. setCellVal
+ * updates the hash in O(1) by XORing out the old value's key and XORing in
+ * the new one, so getBoardHash never has to look at all 81 cells. Values
+ * written directly through getCell are not seen by the hash.
+ * 
  */
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <stddef.h>
 
 #define BOARDSIZE 9 //sudoku boards are square so only one value is needed 
 
 typedef struct cell{
-    int value; //The current value in the cell
-    bool clue; //Whether or not the given value was given as a clue
+    int value;      //The current value in the cell
+    bool clue;      //Whether or not the given value was given as a clue
+    uint16_t marks; //Pencil marks, bit d-1 is set if d is marked
 }Cell;
 
+//A board is handed out as a pointer to `rows` so the block holding it can
+//always be found again from the board (see getBlock)
+typedef struct boardBlock{
+    uint64_t hash;                       //Zobrist hash of the values
+    Cell *rows[BOARDSIZE];               //What callers see as the board
+    Cell cells[BOARDSIZE][BOARDSIZE];
+}BoardBlock;
+
 /********* function prototypes *********/ 
 
 //Initialization, setters, and getters
@@ -39,7 +57,10 @@ Cell **initBoard();               //initialzes an empty board
 Cell **initSetBoard(char *clues); //intializes a board with the given set
 Cell *getCell(int row, int col, Cell **board);
 void setCellVal(Cell **board, int row, int col, int val);
-static char *convertToWSStr(char *str);
+void clearCell(Cell **board, int row, int col);
+uint64_t getBoardHash(Cell **board);
+uint64_t zobristKey(int row, int col, int val);
+static BoardBlock *getBlock(Cell **board);
 
 //Legality functions
 bool isCompleteBoard(Cell **Board);
@@ -56,33 +77,25 @@ void deleteBoard();
 /**
  * Creates a 9*9 sudoku board out Cell structs. As there is no independent 
  * sudoku board struct this function will return a pointer to the first value 
- * of the board. 
+ * of the board. The rows, cells and hash of a board are allocated together in
+ * one block (see BoardBlock) which is only ever freed by deleteBoard.
  * 
  * This function will return NULL if any of the memory requested could not be 
  * allocated
  */ 
 Cell** initBoard()
 {
-    Cell** board = calloc(BOARDSIZE, __SIZEOF_POINTER__);
-    if(board == NULL){
+    BoardBlock *block = calloc(1, sizeof(BoardBlock)); //All values start at 0
+    if(block == NULL){
         return NULL;
     }
     for(int i = 0; i < BOARDSIZE; i++){
-        board[i] = calloc(BOARDSIZE, __SIZEOF_POINTER__);
-        if(board[i] == NULL){
-            return NULL;
-        }
+        block->rows[i] = block->cells[i];
         for(int j = 0; j < BOARDSIZE; j++){
-            Cell *cell = malloc(sizeof(Cell));
-            if(cell == NULL){
-                return NULL;
-            }
-            cell->clue = false;
-            cell->value = 0;
-            board[i][j] = *cell;
+            block->cells[i][j].clue = false;
         }
     }
-    return board;
+    return block->rows;
 }
 
 /**
@@ -92,6 +105,11 @@ Cell** initBoard()
  * Will return NULL if any of the memory required for the board could not be
  * allocated or if the `clues` argument is not of the proper length (81) or if
  * it contains any non-numerical
+ * 
+ * Also returns NULL if the clues can't be the start of a solution: a digit
+ * is given twice in a row, column or square, or an empty cell sees all nine
+ * digits. Both are found with one bitmask of used digits per unit so a
+ * contradictory puzzle is turned away before anything tries to solve it.
  */ 
 Cell** initSetBoard(char *clues)
 {
@@ -109,23 +127,50 @@ Cell** initSetBoard(char *clues)
             return NULL;
         }
     }
-    char *newClues = convertToWSStr(clues);
     Cell** board = initBoard();
     if(board == NULL){
         fprintf(stderr, "Unable to intialize board");
         exit(4);
     }
+    //Digits used in each row, column and square (bit d-1 for digit d)
+    uint16_t rows[BOARDSIZE] = {0};
+    uint16_t cols[BOARDSIZE] = {0};
+    uint16_t boxes[BOARDSIZE] = {0};
     int loc = 0;
-    int cellVal;
     for(int row = 0; row < BOARDSIZE; row++){
         for(int col = 0; col < BOARDSIZE; col++){
             Cell *curCell = getCell(row, col, board);
-            sscanf(&newClues[loc], "%d", &cellVal);
+            int cellVal = clues[loc] - '0'; //Already checked to be a digit
+            int box = (row / 3) * 3 + col / 3;
             if(cellVal > 0){  
+                 uint16_t bit = 1 << (cellVal - 1);
+                 if((rows[row] | cols[col] | boxes[box]) & bit){
+                     fprintf(stderr, "The clue %d at [%d][%d] is repeated\n",
+                             cellVal, row, col);
+                     deleteBoard(board);
+                     return NULL;
+                 }
+                 rows[row] |= bit;
+                 cols[col] |= bit;
+                 boxes[box] |= bit;
                  curCell->clue = true;
-                 curCell->value = cellVal;
+                 setCellVal(board, row, col, cellVal);
+            }
+            loc++;
+        }
+    }
+
+    //An empty cell that sees every digit can never be filled
+    for(int row = 0; row < BOARDSIZE; row++){
+        for(int col = 0; col < BOARDSIZE; col++){
+            int box = (row / 3) * 3 + col / 3;
+            if(getCell(row, col, board)->value == 0 &&
+               (rows[row] | cols[col] | boxes[box]) == 0x1FF){
+                fprintf(stderr, "The cell [%d][%d] has no candidates\n",
+                        row, col);
+                deleteBoard(board);
+                return NULL;
             }
-            loc += 2;
         }
     }
     return board;
@@ -153,9 +198,10 @@ Cell *getCell(int row, int col, Cell** board)
 }
 
 /**
- * Sets the cell at the given [row][col] to the given value. This function
- * will do nothing if the given board is NULL, either the row or col argument
- * is not within the board or if the given value is not within 1 - 9.
+ * Sets the cell at the given [row][col] to the given value and updates the
+ * board's hash. This function will do nothing if the given board is NULL,
+ * either the row or col argument is not within the board or if the given
+ * value is not within 1 - 9.
  */ 
 void setCellVal(Cell **board, int row, int col, int val)
 {
@@ -171,34 +217,71 @@ void setCellVal(Cell **board, int row, int col, int val)
         return;
     }
 
+    BoardBlock *block = getBlock(board);
+    if(cell->value != 0){
+        block->hash ^= zobristKey(row, col, cell->value);
+    }
+    block->hash ^= zobristKey(row, col, val);
     cell->value = val;
 }
 
-
 /**
- * Converts the clues input (used in initSetBoard) to a series of characters
- * seperated by whitespace for easier reading. This function will return NULL if
- * `clues` is NULL otherwise it will return the same string but with whitespace 
- * between each character.
- */ 
-static char *convertToWSStr(char *str)
+ * Empties the cell at the given [row][col] and updates the board's hash. The
+ * cell's pencil marks are left as they are. This function will do nothing if
+ * the given board is NULL or either the row or col argument is not within
+ * the board.
+ */
+void clearCell(Cell **board, int row, int col)
 {
-    if(str == NULL){
-        return NULL;
+    Cell *cell = getCell(row, col, board);
+    if(cell == NULL){
+        return;
+    }
+    if(cell->value != 0){
+        getBlock(board)->hash ^= zobristKey(row, col, cell->value);
     }
+    cell->value = 0;
+}
 
-    int len = strlen(str);
-    char *newStr = malloc(sizeof(char)*len*2+1); //Double the length of the  
-                                                 //input string and then 
-                                                 //re-add the null terminator 
-    for(int loc = 0; loc < len; loc++){
-        newStr[loc*2] = str[loc];
-        newStr[loc*2+1] = ' ';
+/**
+ * Returns the Zobrist hash of the values on the given board. Two boards with
+ * the same values always have the same hash regardless of the order the
+ * values were set in. Returns 0 if the board is NULL (which is also the hash
+ * of an empty board).
+ */
+uint64_t getBoardHash(Cell **board)
+{
+    if(board == NULL){
+        return 0;
     }
-    newStr[strlen(newStr)+1] = '\0';
-    return newStr;
+    return getBlock(board)->hash;
+}
+
+/**
+ * Returns the Zobrist key of `val` in the cell at [row][col], the amount the
+ * board hash is XORed with when that value is placed or removed. Keys are
+ * derived from the cell and value with a fixed mixing function so they are
+ * the same in every process and need no table to be set up.
+ */
+uint64_t zobristKey(int row, int col, int val)
+{
+    //splitmix64 finalizer over a distinct number for each (cell, value)
+    uint64_t x = (uint64_t)((row * BOARDSIZE + col) * 10 + val) +
+                 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
 }
 
+/**
+ * Returns the block a board was allocated in by initBoard.
+ */
+static BoardBlock *getBlock(Cell **board)
+{
+    return (BoardBlock *)((char *)board - offsetof(BoardBlock, rows));
+}
+
+
 /**
  * Checks if a the cell at the given [row][col] position has a legal value given
  * the relvant row, column, and square it is in. 
@@ -463,8 +546,8 @@ void printBoard(Cell **board)
 
 
 /**
- * Deletes a given board from memory cell by cell. If the given board is NULL
- * this function will simply return and not throw an error.
+ * Deletes a given board from memory. If the given board is NULL this function
+ * will simply return and not throw an error.
  */ 
 void deleteBoard(Cell **board)
 {
@@ -473,13 +556,5 @@ void deleteBoard(Cell **board)
         return;
     }
     
-    for(int i = 0; i < BOARDSIZE; i++){
-        for(int j = 0; j < BOARDSIZE; j++){
-            Cell *cell = &board[i][j];
-            if(cell != NULL){
-                free(cell);
-            }
-        }
-    }
-    free(board);
+    free(getBlock(board));
 }
\ No newline at end of file
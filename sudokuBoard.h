@@ -3,8 +3,9 @@
  * Date: 08/26/19
  * 
  * Implements a sudoku board as a 9x9 grouping of 'Cell' types. Each cell type
- * consists of the current value within that cell (0 if not initalized) and
- * whether or not that value is original (was given as a clue).
+ * consists of the current value within that cell (0 if not initalized),
+ * whether or not that value is original (was given as a clue) and the pencil
+ * marks the player has made in it.
  * 
  * To initialze a board that represents a given sudoku construction/puzzle. 
  * A string of length 81 (excluding terminator) that row by row represents the
@@ -18,18 +19,29 @@
  * traditionally examined in linear algebra. That is all declarations are in
  * [row][col] format.
  * 
+ * Every board also keeps a 64 bit Zobrist hash of its values: the XOR of a
+ * fixed random key for each (cell, value) pair on the board. setCellVal
+ * updates the hash in O(1) by XORing out the old value's key and XORing in
+ * the new one, so getBoardHash never has to look at all 81 cells. Values
+ * written directly through getCell are not seen by the hash.
+ * 
  */
+#ifndef SUDOKU_BOARD_H
+#define SUDOKU_BOARD_H
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 
 #define BOARDSIZE 9 //sudoku boards are square so only one value is needed 
 
 typedef struct cell{
-    int value; //The current value in the cell
-    bool clue; //Whether or not the given value was given as a clue
+    int value;      //The current value in the cell
+    bool clue;      //Whether or not the given value was given as a clue
+    uint16_t marks; //Pencil marks, bit d-1 is set if d is marked
 }Cell;
 
 /********* function prototypes *********/ 
@@ -39,6 +51,9 @@ Cell **initBoard();    //initialzes an empty board
 Cell **initSetBoard(char *clues); //intializes a board from a given clue set
 Cell *getCell(int row, int col, Cell **board);
 void setCellVal(Cell **board, int row, int col, int val);
+void clearCell(Cell **board, int row, int col);
+uint64_t getBoardHash(Cell **board);
+uint64_t zobristKey(int row, int col, int val);
 
 //Legality functions
 bool isCompleteBoard(Cell **board);
@@ -55,7 +70,9 @@ void deleteBoard();
 /**
  * Creates a 9*9 sudoku board out Cell structs. As there is no independent 
  * sudoku board struct this function will return a pointer to the first value 
- * of the board. 
+ * of the board. The rows, cells and hash of a board are allocated together in
+ * one block which is only ever freed by deleteBoard. The hash is kept in that
+ * block rather than in the cells and is read with getBoardHash.
  * 
  * This function will return NULL if any of the memory requested could not be 
  * allocated
@@ -69,6 +86,11 @@ Cell** initBoard();
  * Will return NULL if any of the memory required for the board could not be
  * allocated or if the `clues` argument is not of the proper length (81) or if
  * it contains any non-numerical
+ * 
+ * Also returns NULL if the clues can't be the start of a solution: a digit
+ * is given twice in a row, column or square, or an empty cell sees all nine
+ * digits. Both are found with one bitmask of used digits per unit so a
+ * contradictory puzzle is turned away before anything tries to solve it.
  */ 
 Cell** initSetBoard(char *clues);
 
@@ -84,12 +106,37 @@ Cell *getCell(int row, int col, Cell** board);
 
 
 /**
- * Sets the cell at the given [row][col] to the given value. This function
- * will do nothing if the given board is NULL, either the row or col argument
- * is not within the board or if the given value is not within 1 - 9.
+ * Sets the cell at the given [row][col] to the given value and updates the
+ * board's hash. This function will do nothing if the given board is NULL,
+ * either the row or col argument is not within the board or if the given
+ * value is not within 1 - 9.
  */ 
 void setCellVal(Cell **board, int row, int col, int val);
 
+/**
+ * Empties the cell at the given [row][col] and updates the board's hash. The
+ * cell's pencil marks are left as they are. This function will do nothing if
+ * the given board is NULL or either the row or col argument is not within
+ * the board.
+ */
+void clearCell(Cell **board, int row, int col);
+
+/**
+ * Returns the Zobrist hash of the values on the given board. Two boards with
+ * the same values always have the same hash regardless of the order the
+ * values were set in. Returns 0 if the board is NULL (which is also the hash
+ * of an empty board).
+ */
+uint64_t getBoardHash(Cell **board);
+
+/**
+ * Returns the Zobrist key of `val` in the cell at [row][col], the amount the
+ * board hash is XORed with when that value is placed or removed. Keys are
+ * derived from the cell and value with a fixed mixing function so they are
+ * the same in every process and need no table to be set up.
+ */
+uint64_t zobristKey(int row, int col, int val);
+
 /**
  * Checks if a the cell at the given [row][col] position has a legal value given
  * the relvant row, column, and square it is in. 
@@ -151,7 +198,9 @@ bool isLegalSquare(Cell **board, int row, int col);
 void printBoard(Cell **board);
 
 /**
- * Deletes a given board from memory cell by cell. If the given board is NULL
- * this function will simply return and not throw an error.
+ * Deletes a given board from memory. If the given board is NULL this function
+ * will simply return and not throw an error.
  */ 
-void deleteBoard(Cell **board);
\ No newline at end of file
+void deleteBoard(Cell **board);
+
+#endif
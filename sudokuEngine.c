@@ -0,0 +1,378 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements engine selection on top of the solver. ENGINE_AUTO always pays
+ * for one propagation pass to get the puzzle's features, and puzzles the
+ * pass solves on its own never reach a search at all. The engine it picks
+ * then starts from the propagated values and runs its own pass over them
+ * again, but that pass finds nothing left to place, so it costs a single
+ * round over the units.
+ */
+#include <errno.h>
+#include "./sudokuEngine.h"
+
+#define CONFIG_LINE 128 //Longest config file line read
+
+static EngineTuning current = {TUNE_MAX_CLUES, TUNE_MIN_EMPTY,
+                               TUNE_MIN_DENSITY, TUNE_MAX_DENSITY};
+
+static const char *engineNames[NUMENGINES] = {"auto", "backtrack",
+                                              "propagate", "sat"};
+
+/********* function prototypes *********/
+
+bool solve(Cell **board, Engine engine);
+bool solveWith(const uint8_t *values, uint8_t *solution, Engine engine,
+               SolverStats *stats);
+bool solveStringWith(const char *clues, char *solution, Engine engine,
+                     SolverStats *stats);
+bool puzzleFeatures(const uint8_t *values, PuzzleFeatures *features,
+                    uint8_t *propagated);
+Engine chooseEngine(const PuzzleFeatures *features);
+void getEngineTuning(EngineTuning *tuning);
+bool setEngineTuning(const EngineTuning *tuning);
+const char *engineName(Engine engine);
+bool loadEngineTuning(const char *path);
+bool saveEngineTuning(const char *path);
+bool loadStartupTuning(void);
+static bool readTuning(FILE *file, const char *path);
+
+/**
+ * Solves the given board in place with the given engine, filling every cell
+ * that is not a clue using setCellVal. Returns true if a solution was found.
+ *
+ * This function will return false (and leave the board untouched) if the
+ * board is NULL, holds a value outside of 0 - 9, the values on it are not
+ * legal, the puzzle has no solution or `engine` is out of range.
+ */
+bool solve(Cell **board, Engine engine)
+{
+    uint8_t values[NUMCELLS];
+    uint8_t solution[NUMCELLS];
+    if(board == NULL){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        int val = getCell(i / BOARDSIZE, i % BOARDSIZE, board)->value;
+        if(val < 0 || val > 9){
+            return false;
+        }
+        values[i] = val;
+    }
+    if(!solveWith(values, solution, engine, NULL)){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        if(values[i] == 0){
+            setCellVal(board, i / BOARDSIZE, i % BOARDSIZE, solution[i]);
+        }
+    }
+    return true;
+}
+
+/**
+ * Solves the puzzle given as 81 cell values with the given engine, like
+ * solveValues. If `stats` is not NULL the search statistics are written to
+ * it (all zero if the propagation pass solved the puzzle on its own).
+ */
+bool solveWith(const uint8_t *values, uint8_t *solution, Engine engine,
+               SolverStats *stats)
+{
+    PuzzleFeatures features;
+    uint8_t propagated[NUMCELLS];
+    if(solution == NULL){
+        return false;
+    }
+    switch(engine){
+    case ENGINE_BACKTRACK:
+        return solveValues(values, solution, stats);
+    case ENGINE_PROPAGATE:
+        return solveValuesPropagate(values, solution, stats);
+    case ENGINE_SAT:
+        return solveValuesSat(values, solution, stats);
+    case ENGINE_AUTO:
+        break;
+    default:
+        return false;
+    }
+
+    if(!puzzleFeatures(values, &features, propagated)){
+        return false;
+    }
+    if(features.empty == 0){
+        if(stats != NULL){
+            memset(stats, 0, sizeof(SolverStats));
+        }
+        memcpy(solution, propagated, NUMCELLS);
+        return true;
+    }
+    return solveWith(propagated, solution, chooseEngine(&features), stats);
+}
+
+/**
+ * Solves the puzzle given by the string `clues` with the given engine, like
+ * solveString.
+ */
+bool solveStringWith(const char *clues, char *solution, Engine engine,
+                     SolverStats *stats)
+{
+    uint8_t values[NUMCELLS];
+    uint8_t result[NUMCELLS];
+    if(clues == NULL || solution == NULL){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        char c = clues[i];
+        if(c == '.'){
+            values[i] = 0;
+        }
+        else if(c >= '0' && c <= '9'){ //Also catches a string that ends early
+            values[i] = c - '0';
+        }
+        else{
+            return false;
+        }
+    }
+    if(clues[NUMCELLS] != '\0' || !solveWith(values, result, engine, stats)){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        solution[i] = '0' + result[i];
+    }
+    solution[NUMCELLS] = '\0';
+    return true;
+}
+
+/**
+ * Runs the propagation pass on the puzzle given as 81 cell values and writes
+ * its features to `features`. If `propagated` is not NULL the values after
+ * the pass are written to it. Returns false if the values are not legal or
+ * the pass showed that the puzzle has no solution.
+ */
+bool puzzleFeatures(const uint8_t *values, PuzzleFeatures *features,
+                    uint8_t *propagated)
+{
+    uint8_t local[NUMCELLS];
+    if(features == NULL){
+        return false;
+    }
+    if(propagated == NULL){
+        propagated = local;
+    }
+    int filled = propagateValues(values, propagated);
+    if(filled < 0){
+        return false;
+    }
+
+    //Digits used in each row, column and square after the pass
+    uint16_t rows[BOARDSIZE] = {0};
+    uint16_t cols[BOARDSIZE] = {0};
+    uint16_t boxes[BOARDSIZE] = {0};
+    features->clues = 0;
+    for(int i = 0; i < NUMCELLS; i++){
+        int row = i / BOARDSIZE;
+        int col = i % BOARDSIZE;
+        features->clues += values[i] != 0;
+        if(propagated[i] != 0){
+            uint16_t bit = 1 << (propagated[i] - 1);
+            rows[row] |= bit;
+            cols[col] |= bit;
+            boxes[(row / 3) * 3 + col / 3] |= bit;
+        }
+    }
+
+    int cands = 0;
+    features->propagated = filled;
+    features->empty = 0;
+    for(int i = 0; i < NUMCELLS; i++){
+        int row = i / BOARDSIZE;
+        int col = i % BOARDSIZE;
+        if(propagated[i] == 0){
+            uint16_t used = rows[row] | cols[col] |
+                            boxes[(row / 3) * 3 + col / 3];
+            cands += BOARDSIZE - __builtin_popcount(used);
+            features->empty++;
+        }
+    }
+    features->density = features->empty > 0 ?
+                        (double)cands / features->empty : 0;
+    return true;
+}
+
+/**
+ * Returns the engine ENGINE_AUTO uses for a puzzle with the given features
+ * under the current tuning. Never returns ENGINE_AUTO.
+ */
+Engine chooseEngine(const PuzzleFeatures *features)
+{
+    if(features != NULL && features->clues <= current.maxClues &&
+       features->empty >= current.minEmpty &&
+       features->density >= current.minDensity &&
+       features->density < current.maxDensity){
+        return ENGINE_PROPAGATE;
+    }
+    return ENGINE_BACKTRACK;
+}
+
+/**
+ * Writes the current routing thresholds to `tuning`.
+ */
+void getEngineTuning(EngineTuning *tuning)
+{
+    if(tuning != NULL){
+        *tuning = current;
+    }
+}
+
+/**
+ * Replaces the routing thresholds used by ENGINE_AUTO. The tuning is shared
+ * by the whole process and is not locked, so it should only be set before
+ * any solving starts. Returns false (and changes nothing) if `tuning` is NULL
+ * or holds a negative threshold, a density that is not a number or a
+ * maxDensity below its minDensity.
+ */
+bool setEngineTuning(const EngineTuning *tuning)
+{
+    //Written so that a NaN density is rejected too
+    if(tuning == NULL || tuning->maxClues < 0 || tuning->minEmpty < 0 ||
+       !(tuning->minDensity >= 0) ||
+       !(tuning->maxDensity >= tuning->minDensity)){
+        return false;
+    }
+    current = *tuning;
+    return true;
+}
+
+/**
+ * Returns the name of the given engine, or "unknown" if it is out of range.
+ */
+const char *engineName(Engine engine)
+{
+    if(engine < ENGINE_AUTO || engine >= NUMENGINES){
+        return "unknown";
+    }
+    return engineNames[engine];
+}
+
+/**
+ * Reads routing thresholds from the config file at `path` and sets them with
+ * setEngineTuning. Thresholds the file leaves out keep their current value.
+ * Returns false (printing why to stderr and changing nothing) if the file
+ * cannot be read, has a line that is not a known threshold and its value, or
+ * holds thresholds setEngineTuning rejects.
+ */
+bool loadEngineTuning(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if(file == NULL){
+        perror(path);
+        return false;
+    }
+    bool loaded = readTuning(file, path);
+    fclose(file);
+    return loaded;
+}
+
+/**
+ * Writes the current routing thresholds to a config file at `path` that
+ * loadEngineTuning can read back. Returns false (printing why to stderr) if
+ * the file cannot be written.
+ */
+bool saveEngineTuning(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if(file == NULL){
+        perror(path);
+        return false;
+    }
+    fprintf(file, "# Routing thresholds for ENGINE_AUTO, see sudokuEngine.h\n");
+    fprintf(file, "maxClues %d\n", current.maxClues);
+    fprintf(file, "minEmpty %d\n", current.minEmpty);
+    fprintf(file, "minDensity %.17g\n", current.minDensity);
+    fprintf(file, "maxDensity %.17g\n", current.maxDensity);
+    if(ferror(file) | fclose(file)){ //Always close, even after an error
+        fprintf(stderr, "Unable to write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Loads the config file a program should start with: the file named by the
+ * ENGINE_CONFIG environment variable if it is set, otherwise ENGINE_CONFIG in
+ * the working directory. Not having the default file is not an error, the
+ * built in thresholds are kept. Returns false if a file was found (or named)
+ * but could not be loaded.
+ */
+bool loadStartupTuning(void)
+{
+    const char *path = getenv("ENGINE_CONFIG");
+    if(path != NULL){
+        return loadEngineTuning(path);
+    }
+    FILE *file = fopen(ENGINE_CONFIG, "r");
+    if(file == NULL){
+        if(errno == ENOENT){
+            return true;
+        }
+        perror(ENGINE_CONFIG);
+        return false;
+    }
+    bool loaded = readTuning(file, ENGINE_CONFIG);
+    fclose(file);
+    return loaded;
+}
+
+/**
+ * Parses an open config file (named `path` in error messages) and sets the
+ * thresholds in it. See loadEngineTuning.
+ */
+static bool readTuning(FILE *file, const char *path)
+{
+    EngineTuning tuning = current;
+    char line[CONFIG_LINE];
+    int lineNum = 0;
+    while(fgets(line, CONFIG_LINE, file) != NULL){
+        char name[CONFIG_LINE];
+        double value;
+        char extra;
+        lineNum++;
+        if(strchr(line, '\n') == NULL && !feof(file)){
+            fprintf(stderr, "%s:%d: line too long\n", path, lineNum);
+            return false;
+        }
+        int fields = sscanf(line, "%s %lf %c", name, &value, &extra);
+        if(fields <= 0 || name[0] == '#'){
+            continue; //Blank line or comment
+        }
+        bool whole = fields == 2 && value >= 0 && value <= NUMCELLS &&
+                     value == (int)value;
+        if(fields == 2 && strcmp(name, "minDensity") == 0){
+            tuning.minDensity = value;
+        }
+        else if(fields == 2 && strcmp(name, "maxDensity") == 0){
+            tuning.maxDensity = value;
+        }
+        else if(whole && strcmp(name, "maxClues") == 0){
+            tuning.maxClues = value;
+        }
+        else if(whole && strcmp(name, "minEmpty") == 0){
+            tuning.minEmpty = value;
+        }
+        else{
+            fprintf(stderr, "%s:%d: expected a threshold and its value\n",
+                    path, lineNum);
+            return false;
+        }
+    }
+    if(ferror(file)){
+        perror(path);
+        return false;
+    }
+    if(!setEngineTuning(&tuning)){
+        fprintf(stderr, "%s: thresholds out of range\n", path);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,165 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Lets callers pick which search engine solves a puzzle, or leave the choice
+ * to ENGINE_AUTO. No single engine is best for every puzzle: the plain
+ * backtracking search is cheapest per node and wins on easy puzzles and on
+ * puzzles with many solutions, while propagating singles at every node costs
+ * more per node but needs far fewer of them on hard puzzles.
+ *
+ * ENGINE_AUTO first runs the propagation pass, which on its own solves most
+ * easy puzzles, and then looks at cheap features of what is left: how many
+ * clues the puzzle had, how many cells are still empty, and how many
+ * candidates those cells have on average. Puzzles that are still sparse and
+ * open go to ENGINE_PROPAGATE, everything else to ENGINE_BACKTRACK. Puzzles
+ * that are very open (TUNE_MAX_DENSITY) usually have many solutions, and
+ * backtracking finds one of those sooner, so they go back to backtracking.
+ * The thresholds live in an EngineTuning that can be replaced with values
+ * taken from benchmarks on real traffic.
+ *
+ * Which thresholds are best depends on the machine as much as on the
+ * puzzles, so they can also be kept in a config file (ENGINE_CONFIG unless
+ * the ENGINE_CONFIG environment variable names another one) that the
+ * programs load at startup. tuneEngine writes that file from measurements.
+ * The file holds one "name value" line per threshold, named as in
+ * EngineTuning, and lines starting with '#' are comments.
+ */
+#ifndef SUDOKU_ENGINE_H
+#define SUDOKU_ENGINE_H
+
+#include "./sudokuSolver.h"
+#include "./sudokuSat.h"
+
+//Default routing thresholds, measured on generated minimal puzzles
+#define TUNE_MAX_CLUES 30      //More clues than this never go to PROPAGATE
+#define TUNE_MIN_EMPTY 50      //Fewer empty cells than this never do either
+#define TUNE_MIN_DENSITY 3.5   //Nor do fewer candidates per empty cell
+#define TUNE_MAX_DENSITY 4.25  //Nor do this many or more
+
+#define ENGINE_CONFIG "sudokuEngine.conf" //Default config file
+
+typedef enum engine{
+    ENGINE_AUTO = 0,  //Chosen from the puzzle's features
+    ENGINE_BACKTRACK, //Propagation once, then plain backtracking
+    ENGINE_PROPAGATE, //Propagation at every node of the search
+    ENGINE_SAT,       //The CDCL SAT solver in sudokuSat, never picked by AUTO
+    NUMENGINES
+}Engine;
+
+typedef struct puzzleFeatures{
+    int clues;      //Cells given in the puzzle
+    int propagated; //Cells the propagation pass filled
+    int empty;      //Cells still empty after the pass
+    double density; //Average candidates of those cells, 0 if there are none
+}PuzzleFeatures;
+
+typedef struct engineTuning{
+    int maxClues;      //See TUNE_MAX_CLUES
+    int minEmpty;      //See TUNE_MIN_EMPTY
+    double minDensity; //See TUNE_MIN_DENSITY
+    double maxDensity; //See TUNE_MAX_DENSITY
+}EngineTuning;
+
+/********* function prototypes *********/
+
+bool solve(Cell **board, Engine engine);
+bool solveWith(const uint8_t *values, uint8_t *solution, Engine engine,
+               SolverStats *stats);
+bool solveStringWith(const char *clues, char *solution, Engine engine,
+                     SolverStats *stats);
+bool puzzleFeatures(const uint8_t *values, PuzzleFeatures *features,
+                    uint8_t *propagated);
+Engine chooseEngine(const PuzzleFeatures *features);
+void getEngineTuning(EngineTuning *tuning);
+bool setEngineTuning(const EngineTuning *tuning);
+const char *engineName(Engine engine);
+bool loadEngineTuning(const char *path);
+bool saveEngineTuning(const char *path);
+bool loadStartupTuning(void);
+
+/**
+ * Solves the given board in place with the given engine, filling every cell
+ * that is not a clue using setCellVal. Returns true if a solution was found.
+ *
+ * This function will return false (and leave the board untouched) if the
+ * board is NULL, holds a value outside of 0 - 9, the values on it are not
+ * legal, the puzzle has no solution or `engine` is out of range.
+ */
+bool solve(Cell **board, Engine engine);
+
+/**
+ * Solves the puzzle given as 81 cell values with the given engine, like
+ * solveValues. If `stats` is not NULL the search statistics are written to
+ * it (all zero if the propagation pass solved the puzzle on its own).
+ */
+bool solveWith(const uint8_t *values, uint8_t *solution, Engine engine,
+               SolverStats *stats);
+
+/**
+ * Solves the puzzle given by the string `clues` with the given engine, like
+ * solveString.
+ */
+bool solveStringWith(const char *clues, char *solution, Engine engine,
+                     SolverStats *stats);
+
+/**
+ * Runs the propagation pass on the puzzle given as 81 cell values and writes
+ * its features to `features`. If `propagated` is not NULL the values after
+ * the pass are written to it. Returns false if the values are not legal or
+ * the pass showed that the puzzle has no solution.
+ */
+bool puzzleFeatures(const uint8_t *values, PuzzleFeatures *features,
+                    uint8_t *propagated);
+
+/**
+ * Returns the engine ENGINE_AUTO uses for a puzzle with the given features
+ * under the current tuning. Never returns ENGINE_AUTO.
+ */
+Engine chooseEngine(const PuzzleFeatures *features);
+
+/**
+ * Writes the current routing thresholds to `tuning`.
+ */
+void getEngineTuning(EngineTuning *tuning);
+
+/**
+ * Replaces the routing thresholds used by ENGINE_AUTO. The tuning is shared
+ * by the whole process and is not locked, so it should only be set before
+ * any solving starts. Returns false (and changes nothing) if `tuning` is NULL
+ * or holds a negative threshold, a density that is not a number or a
+ * maxDensity below its minDensity.
+ */
+bool setEngineTuning(const EngineTuning *tuning);
+
+/**
+ * Returns the name of the given engine, or "unknown" if it is out of range.
+ */
+const char *engineName(Engine engine);
+
+/**
+ * Reads routing thresholds from the config file at `path` and sets them with
+ * setEngineTuning. Thresholds the file leaves out keep their current value.
+ * Returns false (printing why to stderr and changing nothing) if the file
+ * cannot be read, has a line that is not a known threshold and its value, or
+ * holds thresholds setEngineTuning rejects.
+ */
+bool loadEngineTuning(const char *path);
+
+/**
+ * Writes the current routing thresholds to a config file at `path` that
+ * loadEngineTuning can read back. Returns false (printing why to stderr) if
+ * the file cannot be written.
+ */
+bool saveEngineTuning(const char *path);
+
+/**
+ * Loads the config file a program should start with: the file named by the
+ * ENGINE_CONFIG environment variable if it is set, otherwise ENGINE_CONFIG in
+ * the working directory. Not having the default file is not an error, the
+ * built in thresholds are kept. Returns false if a file was found (or named)
+ * but could not be loaded.
+ */
+bool loadStartupTuning(void);
+
+#endif
@@ -0,0 +1,564 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a shared-memory interface for solving puzzles from other
+ * processes on the same machine. The server creates a named segment in
+ * /dev/shm (see ipcCreate) which holds a ring of request/response slots.
+ * A client attaches to that segment, claims a free slot, writes its puzzle
+ * into it and waits for the server to write the solution back into the same
+ * slot.
+ *
+ * Sleeping and waking is done with futexes on words inside the segment. A
+ * side only sets its "sleeping" flag and calls into the kernel after spinning
+ * for IPC_SPINS polls, and the other side only calls futex wake when that
+ * flag is set.
+ *
+ * The shared cache lives right after the IpcSegment struct in the mapping.
+ * Its size is recorded in the segment so every process can build its own
+ * view of it (see segmentCache).
+ *
+ * Slots are claimed by swapping the client's pid into `owner`, which is only
+ * cleared after the slot is FREE again, so a slot with an owner can never
+ * be claimed twice. Only the server frees slots for clients (reapSlots and
+ * finishSlot), so it never frees one it is in the middle of answering. The
+ * one slot both sides may free is an abandoned slot that has just become
+ * DONE; each side moves it from DONE to FREE with a CAS, so only one of
+ * them does.
+ *
+ * The segment is always created with O_EXCL, so a server never wipes a
+ * segment another one is serving. The server holds an flock on the segment
+ * for as long as it runs, so a segment whose lock can be had was left behind
+ * by a crash. The pid of the server is kept in the segment so clients can
+ * tell when it dies.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "./sudokuIpc.h"
+#include "./sudokuEngine.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpuRelax() __builtin_ia32_pause()
+#else
+#define cpuRelax() ((void)0)
+#endif
+
+/********* function prototypes *********/
+
+IpcSegment *ipcCreate(const char *name, size_t cacheBudget);
+IpcSegment *ipcAttach(const char *name);
+void ipcDetach(IpcSegment *seg);
+void ipcDestroy(IpcSegment *seg, const char *name);
+IpcStatus ipcSolve(IpcSegment *seg, const char *puzzle, char *solution);
+int ipcPoll(IpcSegment *seg);
+void ipcServe(IpcSegment *seg, volatile sig_atomic_t *running);
+static IpcSegment *mapSegment(int fd, size_t bytes);
+static bool reclaimSegment(const char *name);
+static SolutionCache *segmentCache(IpcSegment *seg, SolutionCache *view);
+static IpcSlot *claimSlot(IpcSegment *seg, const struct timespec *start);
+static void abandonSlot(IpcSegment *seg, IpcSlot *slot);
+static void releaseSlot(IpcSlot *slot);
+static void answerSlot(IpcSlot *slot, SolutionCache *cache);
+static void finishSlot(IpcSlot *slot);
+static void reapSlots(IpcSegment *seg);
+static bool processAlive(pid_t pid);
+static long elapsedMs(const struct timespec *start);
+static void futexWait(_Atomic uint32_t *word, uint32_t expected, long ms);
+static void futexWake(_Atomic uint32_t *word);
+
+/**
+ * Creates the shared segment with the given name and maps it into this
+ * process. All slots start out FREE and the cache, which uses at most
+ * `cacheBudget` bytes, starts out empty. A budget of 0 disables the cache.
+ *
+ * A segment of that name left behind by a server that has died is removed
+ * first, but one whose server is still running is never touched. Returns
+ * NULL in that case, if another server is starting on the same name or if
+ * the segment could not be created or mapped.
+ */
+IpcSegment *ipcCreate(const char *name, size_t cacheBudget)
+{
+    if(name == NULL){
+        return NULL;
+    }
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0 && errno == EEXIST){
+        if(!reclaimSegment(name)){
+            fprintf(stderr, "The segment %s is already being served\n", name);
+            return NULL;
+        }
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if(fd < 0){
+        perror("shm_open");
+        return NULL;
+    }
+
+    //Until the lock is taken another server may see the new segment as one
+    //left behind. If it got the lock first it also removes the name, so the
+    //segment is given up either way
+    struct stat info;
+    if(flock(fd, LOCK_EX | LOCK_NB) != 0 || fstat(fd, &info) != 0 ||
+       info.st_nlink == 0){
+        fprintf(stderr, "Another server is starting on the segment %s\n",
+                name);
+        close(fd);
+        return NULL;
+    }
+    size_t cacheBytes = solutionCacheBytes(cacheBudget);
+    if(ftruncate(fd, sizeof(IpcSegment) + cacheBytes) != 0){
+        perror("ftruncate");
+        shm_unlink(name);
+        close(fd);
+        return NULL;
+    }
+    IpcSegment *seg = mapSegment(fd, sizeof(IpcSegment) + cacheBytes);
+    if(seg == NULL){
+        shm_unlink(name);
+        close(fd);
+        return NULL;
+    }
+    memset(seg, 0, sizeof(IpcSegment));
+    seg->serverPid = getpid();
+    seg->lockFd = fd;
+    seg->cacheBytes = cacheBytes;
+    SolutionCache view;
+    if(cacheBytes > 0){
+        attachSolutionCache(&view, seg + 1, cacheBytes, true);
+    }
+    atomic_thread_fence(memory_order_seq_cst);
+    seg->magic = IPC_MAGIC;
+    return seg;
+}
+
+/**
+ * Maps an existing shared segment created by a server into this process.
+ * Returns NULL if there is no segment with the given name or if it has not
+ * been initialized by ipcCreate.
+ */
+IpcSegment *ipcAttach(const char *name)
+{
+    if(name == NULL){
+        return NULL;
+    }
+    int fd = shm_open(name, O_RDWR, 0);
+    if(fd < 0){
+        perror("shm_open");
+        return NULL;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(IpcSegment)){
+        fprintf(stderr, "The segment %s is not a solver segment\n", name);
+        close(fd);
+        return NULL;
+    }
+    IpcSegment *seg = mapSegment(fd, info.st_size);
+    close(fd);
+    if(seg == NULL){
+        return NULL;
+    }
+    if(seg->magic != IPC_MAGIC ||
+       sizeof(IpcSegment) + seg->cacheBytes != (size_t)info.st_size){
+        fprintf(stderr, "The segment %s is not a solver segment\n", name);
+        ipcDetach(seg);
+        return NULL;
+    }
+    return seg;
+}
+
+/**
+ * Unmaps the segment from this process. If `seg` is NULL this function does
+ * nothing.
+ */
+void ipcDetach(IpcSegment *seg)
+{
+    if(seg == NULL){
+        return;
+    }
+    munmap(seg, sizeof(IpcSegment) + seg->cacheBytes);
+}
+
+/**
+ * Unmaps the segment, removes its name so no new clients can attach and
+ * drops the server's lock on it. Only the server should call this.
+ */
+void ipcDestroy(IpcSegment *seg, const char *name)
+{
+    int lockFd = seg != NULL ? seg->lockFd : -1;
+    ipcDetach(seg);
+    if(name != NULL){
+        shm_unlink(name);
+    }
+    if(lockFd >= 0){
+        close(lockFd);
+    }
+}
+
+/**
+ * Answers `puzzle` (81 chars, '0' or '.' for empty cells) from the shared
+ * cache or, if it is not cached, submits it to the server and blocks until it
+ * has been answered. If the returned status is IPC_SOLVED the solution is
+ * copied into `solution` which must be able to hold 82 chars.
+ *
+ * Returns IPC_INVALID without contacting the server if the puzzle is not 81
+ * chars long and IPC_ERROR if `seg` or `solution` is NULL, or if no slot
+ * could be had or no answer came within IPC_TIMEOUT_MS or before the server
+ * died.
+ */
+IpcStatus ipcSolve(IpcSegment *seg, const char *puzzle, char *solution)
+{
+    if(seg == NULL || solution == NULL){
+        return IPC_ERROR;
+    }
+    if(puzzle == NULL || strlen(puzzle) != NUMCELLS){
+        return IPC_INVALID;
+    }
+    SolutionCache view;
+    int cached;
+    if(solutionLookup(segmentCache(seg, &view), puzzle, &cached, solution)){
+        return cached;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    IpcSlot *slot = claimSlot(seg, &start);
+    if(slot == NULL){
+        return IPC_ERROR;
+    }
+    memcpy(slot->puzzle, puzzle, NUMCELLS + 1);
+    atomic_store(&slot->state, SLOT_REQUEST);
+
+    //Bumping `pending` after publishing the request means a server that is
+    //about to sleep either sees the new count or we see it sleeping
+    atomic_fetch_add(&seg->pending, 1);
+    if(atomic_load(&seg->serverSleeping)){
+        futexWake(&seg->pending);
+    }
+
+    for(int spin = 0; atomic_load(&slot->state) != SLOT_DONE; spin++){
+        if(spin < IPC_SPINS){
+            cpuRelax();
+            continue;
+        }
+        atomic_store(&slot->waiting, 1);
+        futexWait(&slot->state, SLOT_REQUEST, IPC_CHECK_MS);
+        if(atomic_load(&slot->state) != SLOT_DONE &&
+           (elapsedMs(&start) >= IPC_TIMEOUT_MS ||
+            !processAlive(seg->serverPid))){
+            abandonSlot(seg, slot);
+            return IPC_ERROR;
+        }
+    }
+    atomic_store(&slot->waiting, 0);
+
+    IpcStatus status = slot->status;
+    if(status == IPC_SOLVED){
+        memcpy(solution, slot->solution, NUMCELLS + 1);
+    }
+    atomic_store(&slot->state, SLOT_FREE);
+    releaseSlot(slot);
+    return status;
+}
+
+/**
+ * Answers every request currently waiting in the segment and returns how
+ * many were answered. Requests for the same puzzle are only solved once and
+ * the answer is copied to all of them. Answers are added to the shared cache.
+ */
+int ipcPoll(IpcSegment *seg)
+{
+    SolutionCache view;
+    SolutionCache *cache = segmentCache(seg, &view);
+    IpcSlot *waiting[IPC_SLOTS];
+    uint64_t keys[IPC_SLOTS][2];
+    int numWaiting = 0;
+    for(int i = 0; i < IPC_SLOTS; i++){
+        IpcSlot *slot = &seg->slots[i];
+        if(atomic_load_explicit(&slot->state, memory_order_acquire) ==
+           SLOT_REQUEST){
+            slot->puzzle[NUMCELLS] = '\0'; //Never trust the client's terminator
+            puzzleKey(slot->puzzle, keys[numWaiting]);
+            waiting[numWaiting++] = slot;
+        }
+    }
+
+    for(int i = 0; i < numWaiting; i++){
+        IpcSlot *slot = waiting[i];
+        if(slot == NULL){ //Already answered along with an identical request
+            continue;
+        }
+        answerSlot(slot, cache);
+        finishSlot(slot);
+        for(int j = i + 1; j < numWaiting; j++){
+            if(waiting[j] != NULL && keys[j][0] == keys[i][0] &&
+               keys[j][1] == keys[i][1]){
+                waiting[j]->status = slot->status;
+                memcpy(waiting[j]->solution, slot->solution, NUMCELLS + 1);
+                finishSlot(waiting[j]);
+                waiting[j] = NULL;
+            }
+        }
+    }
+    return numWaiting;
+}
+
+/**
+ * Answers requests until `*running` becomes 0. When there are no requests
+ * the server spins for IPC_SPINS polls before sleeping until a client wakes
+ * it. A signal interrupts the sleep so a handler clearing `*running` is
+ * enough to stop the server. Before every sleep, and every IPC_REAP_POLLS
+ * polls while busy, the slots held by clients that have died are freed.
+ */
+void ipcServe(IpcSegment *seg, volatile sig_atomic_t *running)
+{
+    if(seg == NULL || running == NULL){
+        return;
+    }
+    int idle = 0;
+    unsigned long polls = 0;
+    while(*running){
+        uint32_t seen = atomic_load(&seg->pending);
+        if(++polls % IPC_REAP_POLLS == 0){
+            reapSlots(seg);
+        }
+        if(ipcPoll(seg) > 0){
+            idle = 0;
+            continue;
+        }
+        if(++idle < IPC_SPINS){
+            cpuRelax();
+            continue;
+        }
+
+        //Any request published before `seen` was read has been answered by
+        //the poll above, so only sleep if nothing has arrived since. The
+        //sleep is timed so dead clients' slots are freed even when idle.
+        reapSlots(seg);
+        atomic_store(&seg->serverSleeping, 1);
+        if(atomic_load(&seg->pending) == seen){
+            futexWait(&seg->pending, seen, IPC_CHECK_MS);
+        }
+        atomic_store(&seg->serverSleeping, 0);
+        if(atomic_load(&seg->pending) != seen){
+            idle = 0;
+        }
+    }
+}
+
+/**
+ * Maps the first `bytes` bytes of the shared segment open in `fd`. Returns
+ * NULL if the segment could not be mapped.
+ */
+static IpcSegment *mapSegment(int fd, size_t bytes)
+{
+    void *mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(mem == MAP_FAILED){
+        perror("mmap");
+        return NULL;
+    }
+    return mem;
+}
+
+/**
+ * Removes the segment with the given name unless a running server holds its
+ * lock, in which case it returns false. The lock is kept until the name is
+ * gone, so a server that is just starting on the segment can't take it in
+ * between. A segment that can't be opened for any reason but not existing
+ * counts as served, so it is left alone.
+ */
+static bool reclaimSegment(const char *name)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0){
+        return errno == ENOENT;
+    }
+    if(flock(fd, LOCK_EX | LOCK_NB) != 0){
+        close(fd);
+        return false;
+    }
+    shm_unlink(name); //Left behind by a server that died
+    close(fd);
+    return true;
+}
+
+/**
+ * Sets `view` up to point at the cache in this process's mapping of the
+ * segment and returns it, or returns NULL if the segment has no cache.
+ */
+static SolutionCache *segmentCache(IpcSegment *seg, SolutionCache *view)
+{
+    if(seg->cacheBytes == 0 ||
+       !attachSolutionCache(view, seg + 1, seg->cacheBytes, false)){
+        return NULL;
+    }
+    return view;
+}
+
+/**
+ * Claims a FREE slot for the calling client by making it the owner and
+ * moving the slot to WRITING. Clients start at different places in the ring
+ * so they rarely contend on the same slot. If every slot is in use this
+ * yields and tries again, and returns NULL once IPC_TIMEOUT_MS have passed
+ * since `start` or the server has died.
+ */
+static IpcSlot *claimSlot(IpcSegment *seg, const struct timespec *start)
+{
+    uint32_t first = atomic_fetch_add(&seg->nextSlot, 1);
+    pid_t pid = getpid();
+    for(;;){
+        for(int i = 0; i < IPC_SLOTS; i++){
+            IpcSlot *slot = &seg->slots[(first + i) % IPC_SLOTS];
+            int32_t expected = 0;
+            if(atomic_compare_exchange_strong(&slot->owner, &expected, pid)){
+                atomic_store(&slot->abandoned, 0);
+                atomic_store(&slot->state, SLOT_WRITING);
+                return slot;
+            }
+        }
+        if(elapsedMs(start) >= IPC_TIMEOUT_MS ||
+           !processAlive(seg->serverPid)){
+            return NULL;
+        }
+        sched_yield();
+    }
+}
+
+/**
+ * Gives up on a slot whose answer has not come. With the server gone the
+ * slot is freed at once; otherwise it is marked abandoned and freed here if
+ * the answer has just arrived, or by finishSlot when it does.
+ */
+static void abandonSlot(IpcSegment *seg, IpcSlot *slot)
+{
+    atomic_store(&slot->waiting, 0);
+    atomic_store(&slot->abandoned, 1);
+    uint32_t done = SLOT_DONE;
+    if(!processAlive(seg->serverPid)){
+        atomic_store(&slot->state, SLOT_FREE);
+        releaseSlot(slot);
+    }
+    else if(atomic_compare_exchange_strong(&slot->state, &done, SLOT_FREE)){
+        releaseSlot(slot);
+    }
+}
+
+/**
+ * Clears the owner of a slot that has just been moved to FREE so other
+ * clients can claim it.
+ */
+static void releaseSlot(IpcSlot *slot)
+{
+    atomic_store(&slot->owner, 0);
+}
+
+/**
+ * Writes the answer to the puzzle in a slot into the slot, taking it from the
+ * cache when another client got it answered in the meantime and otherwise
+ * solving it and caching the answer. Malformed puzzles are not cached since
+ * rejecting them again is cheap. `cache` may be NULL.
+ */
+static void answerSlot(IpcSlot *slot, SolutionCache *cache)
+{
+    int status;
+    if(solutionLookup(cache, slot->puzzle, &status, slot->solution)){
+        slot->status = status;
+        return;
+    }
+    if(solveStringWith(slot->puzzle, slot->solution, ENGINE_AUTO, NULL)){
+        slot->status = IPC_SOLVED;
+    }
+    else if(countSolutions(slot->puzzle, 1, NULL) < 0){
+        slot->status = IPC_INVALID;
+    }
+    else{
+        slot->status = IPC_UNSOLVABLE;
+    }
+    if(slot->status != IPC_INVALID){
+        solutionInsert(cache, slot->puzzle, slot->status,
+                       slot->status == IPC_SOLVED ? slot->solution : NULL);
+    }
+}
+
+/**
+ * Marks an answered slot DONE, waking the client if it has gone to sleep, or
+ * frees it if the client has abandoned it.
+ */
+static void finishSlot(IpcSlot *slot)
+{
+    atomic_store(&slot->state, SLOT_DONE);
+    uint32_t done = SLOT_DONE;
+    if(atomic_load(&slot->abandoned) &&
+       atomic_compare_exchange_strong(&slot->state, &done, SLOT_FREE)){
+        releaseSlot(slot);
+    }
+    else if(atomic_load(&slot->waiting)){
+        futexWake(&slot->state);
+    }
+}
+
+/**
+ * Frees every slot whose owner has died, whatever state it was left in.
+ * Only the server calls this, between polls, so none of them is being
+ * answered.
+ */
+static void reapSlots(IpcSegment *seg)
+{
+    for(int i = 0; i < IPC_SLOTS; i++){
+        IpcSlot *slot = &seg->slots[i];
+        int32_t owner = atomic_load(&slot->owner);
+        if(owner != 0 && !processAlive(owner)){
+            atomic_store(&slot->state, SLOT_FREE);
+            atomic_compare_exchange_strong(&slot->owner, &owner, 0);
+        }
+    }
+}
+
+/**
+ * Returns true if a process with the given pid exists. A process that this
+ * one may not signal still counts.
+ */
+static bool processAlive(pid_t pid)
+{
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+/**
+ * Returns the milliseconds that have passed on the monotonic clock since
+ * `start`.
+ */
+static long elapsedMs(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000 +
+           (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+/**
+ * Sleeps until `word` is woken or `ms` milliseconds have passed, as long as
+ * it still holds `expected`. The futex is shared (not private) since the
+ * word lives in a segment mapped by several processes.
+ */
+static void futexWait(_Atomic uint32_t *word, uint32_t expected, long ms)
+{
+    struct timespec timeout = {ms / 1000, (ms % 1000) * 1000000};
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, expected, &timeout,
+            NULL, 0);
+}
+
+/**
+ * Wakes every process sleeping on `word`.
+ */
+static void futexWake(_Atomic uint32_t *word)
+{
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
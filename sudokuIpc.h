@@ -0,0 +1,153 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a shared-memory interface for solving puzzles from other
+ * processes on the same machine. The server creates a named segment in
+ * /dev/shm (see ipcCreate) which holds a ring of request/response slots.
+ * A client attaches to that segment, claims a free slot, writes its puzzle
+ * into it and waits for the server to write the solution back into the same
+ * slot. No sockets are used and nothing is serialized, the puzzle and
+ * solution are plain 81 char strings in the slot.
+ *
+ * Both sides spin for a short while before going to sleep on a futex so
+ * that when the server is busy a round trip never has to enter the kernel.
+ *
+ * The segment also holds a solutionCache right after the slots. Clients look
+ * their puzzle up there before submitting it, so puzzles that have already
+ * been answered never reach the server at all.
+ *
+ * Each slot moves through the following states:
+ * FREE -> WRITING (claimed by a client) -> REQUEST (ready for the server)
+ * -> DONE (solution written) -> FREE (client has read the solution)
+ *
+ * A slot also records the pid of the client holding it. The server frees
+ * the slots of clients that have died, and a client that gives up waiting
+ * marks its slot abandoned so the server frees it once answered. A client
+ * never waits more than IPC_TIMEOUT_MS and stops early if the server dies.
+ *
+ * This module is Linux only as it relies on futexes.
+ */
+#ifndef SUDOKU_IPC_H
+#define SUDOKU_IPC_H
+
+#include <signal.h>
+#include <stdatomic.h>
+#include "./solutionCache.h"
+
+#define IPC_NAME "/sudokuSolver" //Default name of the shared segment
+#define IPC_SLOTS 64             //Number of slots in the ring
+#define IPC_MAGIC 0x5355444B     //Marks a segment as initialized
+#define IPC_SPINS 20000          //Polls before either side goes to sleep
+#define IPC_CACHE_BYTES (16 << 20) //Default memory for the shared cache
+#define IPC_TIMEOUT_MS 10000     //Longest a client waits for an answer
+#define IPC_CHECK_MS 500         //Longest either side sleeps before checking
+                                 //whether the other has died
+#define IPC_REAP_POLLS 65536     //Polls between looks for dead clients
+
+typedef enum ipcStatus{
+    IPC_SOLVED = 0,   //The solution was written to the slot
+    IPC_UNSOLVABLE,   //The puzzle is legal but has no solution
+    IPC_INVALID,      //The puzzle is malformed or not legal
+    IPC_ERROR         //The request could not be submitted
+}IpcStatus;
+
+typedef enum ipcSlotState{
+    SLOT_FREE = 0,
+    SLOT_WRITING,
+    SLOT_REQUEST,
+    SLOT_DONE
+}IpcSlotState;
+
+typedef struct ipcSlot{
+    _Alignas(64) _Atomic uint32_t state; //One of IpcSlotState, futex word
+    _Atomic uint32_t waiting;  //Set while the client sleeps on `state`
+    _Atomic int32_t owner;     //pid of the client holding the slot, 0 if FREE
+    _Atomic uint32_t abandoned; //Set by a client that stopped waiting
+    uint32_t status;           //One of IpcStatus once the slot is DONE
+    char puzzle[NUMCELLS + 1];
+    char solution[NUMCELLS + 1];
+}IpcSlot;
+
+typedef struct ipcSegment{
+    uint32_t magic;
+    int32_t serverPid;   //Process that created the segment and serves it
+    int32_t lockFd;      //The server's descriptor holding the segment's flock
+    uint64_t cacheBytes; //Size of the cache that follows the segment
+    _Alignas(64) _Atomic uint32_t pending; //Bumped for every request
+    _Atomic uint32_t serverSleeping;       //Set while the server sleeps
+    _Alignas(64) _Atomic uint32_t nextSlot; //Where clients start looking
+    IpcSlot slots[IPC_SLOTS];
+}IpcSegment;
+
+/********* function prototypes *********/
+
+IpcSegment *ipcCreate(const char *name, size_t cacheBudget);
+IpcSegment *ipcAttach(const char *name);
+void ipcDetach(IpcSegment *seg);
+void ipcDestroy(IpcSegment *seg, const char *name);
+IpcStatus ipcSolve(IpcSegment *seg, const char *puzzle, char *solution);
+int ipcPoll(IpcSegment *seg);
+void ipcServe(IpcSegment *seg, volatile sig_atomic_t *running);
+
+/**
+ * Creates the shared segment with the given name and maps it into this
+ * process. All slots start out FREE and the cache, which uses at most
+ * `cacheBudget` bytes, starts out empty. A budget of 0 disables the cache.
+ *
+ * A segment of that name left behind by a server that has died is removed
+ * first, but one whose server is still running is never touched. Returns
+ * NULL in that case, if another server is starting on the same name or if
+ * the segment could not be created or mapped.
+ */
+IpcSegment *ipcCreate(const char *name, size_t cacheBudget);
+
+/**
+ * Maps an existing shared segment created by a server into this process.
+ * Returns NULL if there is no segment with the given name or if it has not
+ * been initialized by ipcCreate.
+ */
+IpcSegment *ipcAttach(const char *name);
+
+/**
+ * Unmaps the segment from this process. If `seg` is NULL this function does
+ * nothing.
+ */
+void ipcDetach(IpcSegment *seg);
+
+/**
+ * Unmaps the segment, removes its name so no new clients can attach and
+ * drops the server's lock on it. Only the server should call this.
+ */
+void ipcDestroy(IpcSegment *seg, const char *name);
+
+/**
+ * Answers `puzzle` (81 chars, '0' or '.' for empty cells) from the shared
+ * cache or, if it is not cached, submits it to the server and blocks until it
+ * has been answered. If the returned status is IPC_SOLVED the solution is
+ * copied into `solution` which must be able to hold 82 chars.
+ *
+ * Returns IPC_INVALID without contacting the server if the puzzle is not 81
+ * chars long and IPC_ERROR if `seg` or `solution` is NULL, or if no slot
+ * could be had or no answer came within IPC_TIMEOUT_MS or before the server
+ * died.
+ */
+IpcStatus ipcSolve(IpcSegment *seg, const char *puzzle, char *solution);
+
+/**
+ * Answers every request currently waiting in the segment and returns how
+ * many were answered. Requests for the same puzzle are only solved once and
+ * the answer is copied to all of them. Answers are added to the shared cache.
+ */
+int ipcPoll(IpcSegment *seg);
+
+/**
+ * Answers requests until `*running` becomes 0. When there are no requests
+ * the server spins for IPC_SPINS polls before sleeping until a client wakes
+ * it. A signal interrupts the sleep so a handler clearing `*running` is
+ * enough to stop the server. Before every sleep, and every IPC_REAP_POLLS
+ * polls while busy, the slots held by clients that have died are freed.
+ */
+void ipcServe(IpcSegment *seg, volatile sig_atomic_t *running);
+
+#endif
@@ -0,0 +1,289 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements the killer sudoku solver. See sudokuKiller.h for how the cages
+ * are propagated.
+ *
+ * The cage table is indexed by the number of empty cells, the sum they still
+ * have to make and the digits they may use, and holds the union of every set
+ * of digits fitting that. It is built once by going over the 511 non-empty
+ * sets of digits and adding each to the entry of its size and sum under
+ * every mask that contains it, which is 3^9 updates in all.
+ *
+ * The singles, the choice of cell and the search come from sudokuSolver,
+ * run over the units of one grid (gridUnits) with the cage pass handed to
+ * searchUnits as the pass to run on every node.
+ */
+#include <threads.h>
+#include "./sudokuKiller.h"
+
+typedef struct killerState{
+    uint8_t values[NUMCELLS];     //0 if the cell is empty
+    uint16_t allowed[NUMCELLS];   //Digits the cages still allow in each cell
+    uint16_t used[3 * BOARDSIZE]; //digits placed in each unit of gridUnits
+}KillerState;
+
+//Union of the sets of [size] digits from [allowed] adding up to [sum]
+static uint16_t cageTable[BOARDSIZE + 1][CAGE_MAX_SUM + 1][ALLDIGITS + 1];
+static once_flag cageOnce = ONCE_FLAG_INIT;
+
+/********* function prototypes *********/
+
+bool solveKiller(const KillerPuzzle *puzzle, uint8_t *solution,
+                 SolverStats *stats);
+long countKiller(const KillerPuzzle *puzzle, long limit, SolverStats *stats);
+bool checkKiller(const KillerPuzzle *puzzle);
+uint16_t cageDigits(int size, int sum, uint16_t allowed);
+static void initCageTable(void);
+static bool loadKiller(KillerState *state, const KillerPuzzle *puzzle);
+static long searchKiller(KillerState *state, const KillerPuzzle *puzzle,
+                         long limit, SolverStats *stats);
+static bool propagate(const UnitGraph *graph, const UnitView *view,
+                      int depth, const void *arg);
+static bool propagateCage(const UnitGraph *graph, const UnitView *view,
+                          const KillerCage *cage, bool *progress);
+
+/**
+ * Solves the killer puzzle made of the cages in `puzzle`. On success the
+ * solution is written to `solution` as 81 values and true is returned.
+ *
+ * This function will return false if either argument is NULL, the cages are
+ * not legal (see checkKiller) or the puzzle has no solution. If `stats` is
+ * not NULL the search statistics are written to it.
+ */
+bool solveKiller(const KillerPuzzle *puzzle, uint8_t *solution,
+                 SolverStats *stats)
+{
+    KillerState state;
+    SolverStats local;
+    if(solution == NULL || !loadKiller(&state, puzzle)){
+        return false;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    if(searchKiller(&state, puzzle, 1, stats) != 1){
+        return false;
+    }
+    memcpy(solution, state.values, NUMCELLS);
+    return true;
+}
+
+/**
+ * Counts the solutions of the killer puzzle, stopping as soon as `limit` of
+ * them have been found, so countKiller(puzzle, 2, NULL) == 1 is a uniqueness
+ * test.
+ *
+ * Returns -1 if the puzzle is NULL or its cages are not legal.
+ */
+long countKiller(const KillerPuzzle *puzzle, long limit, SolverStats *stats)
+{
+    KillerState state;
+    SolverStats local;
+    if(!loadKiller(&state, puzzle)){
+        return -1;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    return searchKiller(&state, puzzle, limit, stats);
+}
+
+/**
+ * Returns true if every cage has between 1 and 9 cells, all on the grid and
+ * none of them in another cage or twice in the same one, and a sum that some
+ * set of that many different digits adds up to.
+ */
+bool checkKiller(const KillerPuzzle *puzzle)
+{
+    if(puzzle == NULL || puzzle->numCages < 0 ||
+       puzzle->numCages > NUMCELLS){
+        return false;
+    }
+    bool caged[NUMCELLS] = {false};
+    for(int c = 0; c < puzzle->numCages; c++){
+        const KillerCage *cage = &puzzle->cages[c];
+        if(cage->size < 1 || cage->size > BOARDSIZE ||
+           cageDigits(cage->size, cage->sum, ALLDIGITS) == 0){
+            return false;
+        }
+        for(int k = 0; k < cage->size; k++){
+            if(cage->cells[k] >= NUMCELLS || caged[cage->cells[k]]){
+                return false;
+            }
+            caged[cage->cells[k]] = true;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the digits (bit d-1 for digit d) that are part of at least one set
+ * of `size` different digits taken from `allowed` adding up to `sum`, so 0
+ * if there is no such set. A size outside 1 to 9 or a sum outside 1 to
+ * CAGE_MAX_SUM gives 0 as well.
+ */
+uint16_t cageDigits(int size, int sum, uint16_t allowed)
+{
+    if(size < 1 || size > BOARDSIZE || sum < 1 || sum > CAGE_MAX_SUM){
+        return 0;
+    }
+    call_once(&cageOnce, initCageTable);
+    return cageTable[size][sum][allowed & ALLDIGITS];
+}
+
+/**
+ * Fills the cage table, adding every set of digits to the entries for its
+ * size and sum under all the masks that contain it.
+ */
+static void initCageTable(void)
+{
+    for(int set = 1; set <= ALLDIGITS; set++){
+        int size = __builtin_popcount(set);
+        int sum = 0;
+        for(int d = 0; d < BOARDSIZE; d++){
+            if(set & (1 << d)){
+                sum += d + 1;
+            }
+        }
+        //Steps through the supersets of `set` in increasing order
+        for(int mask = set; mask <= ALLDIGITS; mask = (mask + 1) | set){
+            cageTable[size][sum][mask] |= set;
+        }
+    }
+}
+
+/**
+ * Loads a killer puzzle into an empty state where every cell allows all the
+ * digits, leaving the cages to the first propagation pass. Returns false if
+ * the cages are not legal.
+ */
+static bool loadKiller(KillerState *state, const KillerPuzzle *puzzle)
+{
+    if(!checkKiller(puzzle)){
+        return false;
+    }
+    memset(state, 0, sizeof(KillerState));
+    for(int i = 0; i < NUMCELLS; i++){
+        state->allowed[i] = ALLDIGITS;
+    }
+    return true;
+}
+
+/**
+ * Searches for solutions of the given state with searchUnits, running the
+ * singles and the cages on every node. Returns the number of solutions
+ * found, never more than `limit`, and once `limit` is reached the state is
+ * left holding the last solution found (every cage of which was checked to
+ * add up by the pass).
+ */
+static long searchKiller(KillerState *state, const KillerPuzzle *puzzle,
+                         long limit, SolverStats *stats)
+{
+    UnitView view = {state->values, state->allowed, state->used};
+    return searchUnits(gridUnits(), &view, propagate, puzzle, limit, stats);
+}
+
+/**
+ * The pass searchKiller runs on every node: fills every naked and hidden
+ * single and narrows every cage of the puzzle in `arg` until nothing
+ * changes. Returns false as soon as the state shows it has no solution: an
+ * empty cell with no candidates, a unit with nowhere left for one of its
+ * missing digits, two digits that can only go in the same cell, or a cage
+ * that can no longer make its sum.
+ */
+static bool propagate(const UnitGraph *graph, const UnitView *view,
+                      int depth, const void *arg)
+{
+    const KillerPuzzle *puzzle = arg;
+    bool progress = true;
+    while(progress){
+        progress = false;
+        if(!singlesPass(graph, view, &progress)){
+            return false;
+        }
+        for(int c = 0; c < puzzle->numCages; c++){
+            if(!propagateCage(graph, view, &puzzle->cages[c], &progress)){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Narrows the empty cells of one cage to the digits the cage table says can
+ * still make its sum, and when the cage needs every one of those digits
+ * places any of them that has one place left in it. Sets `progress` if
+ * anything changed. Returns false if the cage repeats a digit or can no
+ * longer make its sum.
+ */
+static bool propagateCage(const UnitGraph *graph, const UnitView *view,
+                          const KillerCage *cage, bool *progress)
+{
+    uint16_t placed = 0; //Digits already in the cage
+    uint16_t open = 0;   //Candidates of its empty cells
+    int left = cage->sum;
+    int empty = 0;
+    for(int k = 0; k < cage->size; k++){
+        int cell = cage->cells[k];
+        if(view->values[cell] != 0){
+            uint16_t bit = 1 << (view->values[cell] - 1);
+            if(placed & bit){
+                return false;
+            }
+            placed |= bit;
+            left -= view->values[cell];
+        }
+        else{
+            open |= unitCandidates(graph, view, cell);
+            empty++;
+        }
+    }
+    if(empty == 0){
+        return left == 0;
+    }
+    uint16_t usable = cageDigits(empty, left, open & ~placed);
+    if(usable == 0){
+        return false;
+    }
+
+    uint16_t once = 0;  //Digits with at least one place in the cage
+    uint16_t twice = 0; //Digits with at least two places
+    for(int k = 0; k < cage->size; k++){
+        int cell = cage->cells[k];
+        if(view->values[cell] != 0){
+            continue;
+        }
+        if(unitCandidates(graph, view, cell) & ~usable){
+            view->allowed[cell] &= usable;
+            *progress = true;
+        }
+        uint16_t cands = unitCandidates(graph, view, cell);
+        twice |= once & cands;
+        once |= cands;
+    }
+    if(__builtin_popcount(usable) != empty){
+        return true;
+    }
+    uint16_t singles = once & ~twice;
+    for(int k = 0; k < cage->size && singles != 0; k++){
+        int cell = cage->cells[k];
+        if(view->values[cell] != 0){
+            continue;
+        }
+        uint16_t bit = unitCandidates(graph, view, cell) & singles;
+        if((bit & (bit - 1)) != 0){
+            return false;
+        }
+        if(bit != 0){
+            placeUnitDigit(graph, view, cell, __builtin_ctz(bit) + 1);
+            singles &= ~bit;
+            *progress = true;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a solver for killer sudoku: on top of the usual rows, columns
+ * and squares the grid is split into cages, each a set of cells whose digits
+ * have to add up to the cage's sum without repeating a digit. A cage of one
+ * cell is a given. Cells outside every cage are allowed and are only bound
+ * by their row, column and square.
+ *
+ * The state is the one sudokuSolver uses (the 81 values and a mask of the
+ * digits used in every row, column and square) plus a mask per cell of the
+ * digits the cages still allow there. Cages are propagated in the same loop
+ * as the naked and hidden singles of the units: for a cage with `size` empty
+ * cells, `sum` left to make and the union `allowed` of the candidates of
+ * those cells (minus the digits already placed in it), the digits that are
+ * part of some set of `size` different digits from `allowed` adding up to
+ * `sum` are a single lookup in a table built once for every (size, sum,
+ * allowed) triple, and every empty cell of the cage loses the digits outside
+ * that result. Enumerating the digit combinations of each cage on every pass
+ * is what makes killer solving slow, and with the table a pass over all the
+ * cages costs about as much as a pass over the units. When the cage needs
+ * every digit the table leaves, a digit with only one place left in the cage
+ * is placed there like a hidden single.
+ *
+ * The search runs the whole pass on every node, branching on the empty cell
+ * with the fewest candidates, like solveValuesPropagate.
+ */
+#ifndef SUDOKU_KILLER_H
+#define SUDOKU_KILLER_H
+
+#include "./sudokuSolver.h"
+
+#define CAGE_MAX_SUM 45 //1 + 2 + ... + 9, the sum of the largest cage
+
+typedef struct killerCage{
+    int sum;
+    int size;                  //Number of cells, 1 to BOARDSIZE
+    uint8_t cells[BOARDSIZE];  //Cells as row * 9 + column
+}KillerCage;
+
+typedef struct killerPuzzle{
+    int numCages;
+    KillerCage cages[NUMCELLS];
+}KillerPuzzle;
+
+/********* function prototypes *********/
+
+bool solveKiller(const KillerPuzzle *puzzle, uint8_t *solution,
+                 SolverStats *stats);
+long countKiller(const KillerPuzzle *puzzle, long limit, SolverStats *stats);
+bool checkKiller(const KillerPuzzle *puzzle);
+uint16_t cageDigits(int size, int sum, uint16_t allowed);
+
+/**
+ * Solves the killer puzzle made of the cages in `puzzle`. On success the
+ * solution is written to `solution` as 81 values and true is returned.
+ *
+ * This function will return false if either argument is NULL, the cages are
+ * not legal (see checkKiller) or the puzzle has no solution. If `stats` is
+ * not NULL the search statistics are written to it.
+ */
+bool solveKiller(const KillerPuzzle *puzzle, uint8_t *solution,
+                 SolverStats *stats);
+
+/**
+ * Counts the solutions of the killer puzzle, stopping as soon as `limit` of
+ * them have been found, so countKiller(puzzle, 2, NULL) == 1 is a uniqueness
+ * test.
+ *
+ * Returns -1 if the puzzle is NULL or its cages are not legal.
+ */
+long countKiller(const KillerPuzzle *puzzle, long limit, SolverStats *stats);
+
+/**
+ * Returns true if every cage has between 1 and 9 cells, all on the grid and
+ * none of them in another cage or twice in the same one, and a sum that some
+ * set of that many different digits adds up to.
+ */
+bool checkKiller(const KillerPuzzle *puzzle);
+
+/**
+ * Returns the digits (bit d-1 for digit d) that are part of at least one set
+ * of `size` different digits taken from `allowed` adding up to `sum`, so 0
+ * if there is no such set. A size outside 1 to 9 or a sum outside 1 to
+ * CAGE_MAX_SUM gives 0 as well.
+ */
+uint16_t cageDigits(int size, int sum, uint16_t allowed);
+
+#endif
@@ -0,0 +1,808 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements the minimum clue search. See sudokuMinClue.h for the method.
+ *
+ * Sets of cells are 81-bit masks, and the list of unavoidable sets is kept
+ * with the smallest first, which makes the greedy count of sets with no open
+ * cell in common (the pruning bound) come out higher. Every thread also
+ * keeps, for each cell, a bit vector of the sets holding it, and every node
+ * of the search a bit vector of the sets its clues do not hit yet, so placing
+ * a clue costs one pass over those words however many sets there are. A
+ * node only looks at the first SCAN_SETS sets it has not hit, which is where
+ * the small sets are. Sets a thread learns are added to its list and picked
+ * up by the nodes above it as the search comes back up.
+ *
+ * Uniqueness is checked with the solver's searchUnits, whose pass also
+ * turns away the grid itself and records every other solution it reaches,
+ * so the search looks for a solution other than the grid rather than
+ * counting up to two and the solution it finds is the new unavoidable set.
+ */
+#include <threads.h>
+#include <stdatomic.h>
+#include "./sudokuMinClue.h"
+
+#define RAW_SETS (16 * MINCLUE_MAX_SETS) //Sets found before keeping the
+                                         //ones not containing another
+#define WORKER_SETS (2 * MINCLUE_MAX_SETS) //Known and learned sets of a thread
+#define SET_WORDS (WORKER_SETS / 64)
+#define PICK_SETS 32      //Sets not hit a node picks its branch from
+#define SCAN_SETS 256     //Sets not hit a node looks at for its bound
+#define JOBS_PER_THREAD 8 //Branches each clue count is split into, at least
+#define MAX_JOB_DEPTH 4   //Most clues placed before a branch is a job
+#define MAX_JOBS 65536
+
+typedef struct cellSet{
+    uint64_t bits[2]; //Cells 0 - 63, then 64 - 80
+}CellSet;
+
+typedef struct setList{
+    CellSet *sets;
+    int count;
+    int capacity;
+    CellSet newest; //The last set added, kept even when the list is full
+}SetList;
+
+typedef struct hitJob{
+    CellSet chosen; //Clues placed
+    CellSet closed; //Cells no longer allowed to become clues
+    int size;       //Number of clues placed
+}HitJob;
+
+typedef struct otherSearch{
+    const uint8_t *grid; //The solution the others must differ from
+    SetList *found;      //Where the sets of the others go
+}OtherSearch;
+
+struct minClueSearch{
+    uint8_t grid[NUMCELLS];
+    int threads;
+    SetList known;
+    uint8_t best[NUMCELLS]; //Smallest unique puzzle found
+    int bestClues;
+    unsigned long nodes;
+    unsigned long checks;
+    int clues;              //Clue count being searched
+    HitJob *jobs;
+    int numJobs;
+    atomic_int nextJob;
+    atomic_bool found;
+};
+
+typedef struct hitWorker{
+    MinClueSearch *search;
+    SetList sets;                           //The known sets, then the ones
+                                            //it learned
+    int indexed;                            //Sets entered in cellSets
+    uint64_t cellSets[NUMCELLS][SET_WORDS]; //Sets holding each cell
+    unsigned long nodes;
+    unsigned long checks;
+}HitWorker;
+
+/********* function prototypes *********/
+
+MinClueSearch *initMinClue(const uint8_t *grid, int threads);
+int searchClues(MinClueSearch *search, int clues, uint8_t *puzzle);
+int smallestPuzzle(const MinClueSearch *search, uint8_t *puzzle);
+void getMinClueStats(const MinClueSearch *search, MinClueStats *stats);
+void deleteMinClue(MinClueSearch *search);
+static bool collectSets(MinClueSearch *search);
+static void greedyBound(MinClueSearch *search);
+static bool initWorker(HitWorker *worker, MinClueSearch *search);
+static bool makeJobs(HitWorker *worker, const uint64_t *unhit, int seen,
+                     CellSet chosen, CellSet closed, int size, int depth);
+static int searchJobs(void *arg);
+static void searchHits(HitWorker *worker, uint64_t *unhit, int seen,
+                       CellSet chosen, CellSet closed, int size);
+static void refresh(HitWorker *worker, uint64_t *unhit, int *seen,
+                    const CellSet *chosen);
+static int pickSet(const HitWorker *worker, const uint64_t *unhit, int seen,
+                   const CellSet *closed, int left, CellSet *branch,
+                   CellSet *rest);
+static bool tighten(const CellSet *opens, int scanned, CellSet *packed,
+                    int packs);
+static long countOthers(const uint8_t *grid, const CellSet *cells,
+                        SetList *found, long limit);
+static bool passOthers(const UnitGraph *graph, const UnitView *view,
+                       int depth, const void *arg);
+static void addSet(SetList *list, const CellSet *set);
+static int compareSize(const void *a, const void *b);
+static int setSize(const CellSet *set);
+static bool meets(const CellSet *a, const CellSet *b);
+static bool inSet(const CellSet *set, int cell);
+static void addCell(CellSet *set, int cell);
+static uint64_t nextRandom(uint64_t *state);
+
+/**
+ * Prepares a search of the given solution grid (81 values) over `threads`
+ * threads: collects its unavoidable sets and finds a first unique puzzle by
+ * removing clues in random orders while the puzzle stays unique, whose size
+ * bounds the answer from above.
+ *
+ * Returns NULL if `grid` is NULL or not a full legal grid, `threads` is out
+ * of range or the search could not be allocated. The search must be freed
+ * with deleteMinClue.
+ */
+MinClueSearch *initMinClue(const uint8_t *grid, int threads)
+{
+    if(grid == NULL || threads < 1 || threads > MINCLUE_MAX_THREADS ||
+       !checkValues(grid) || memchr(grid, 0, NUMCELLS) != NULL){
+        return NULL;
+    }
+    MinClueSearch *search = calloc(1, sizeof(MinClueSearch));
+    if(search == NULL){
+        return NULL;
+    }
+    memcpy(search->grid, grid, NUMCELLS);
+    search->threads = threads;
+    search->known.capacity = MINCLUE_MAX_SETS;
+    search->known.sets = malloc(MINCLUE_MAX_SETS * sizeof(CellSet));
+    search->jobs = malloc(MAX_JOBS * sizeof(HitJob));
+    if(search->known.sets == NULL || search->jobs == NULL ||
+       !collectSets(search)){
+        deleteMinClue(search);
+        return NULL;
+    }
+    greedyBound(search);
+    return search;
+}
+
+/**
+ * Searches every set of `clues` cells that hits all the known unavoidable
+ * sets. Returns 1 if one of them, or of fewer cells, is a unique puzzle,
+ * writing it to `puzzle` as 81 values (0 for an empty cell), 0 if none is
+ * (so every unique puzzle of the grid has more clues) and -1 if an argument
+ * is NULL or the threads could not be had.
+ */
+int searchClues(MinClueSearch *search, int clues, uint8_t *puzzle)
+{
+    if(search == NULL || puzzle == NULL){
+        return -1;
+    }
+    if(clues >= search->bestClues){
+        memcpy(puzzle, search->best, NUMCELLS);
+        return 1;
+    }
+    HitWorker *workers = malloc(search->threads * sizeof(HitWorker));
+    if(workers == NULL){
+        return -1;
+    }
+    int ready = 0;
+    while(ready < search->threads && initWorker(&workers[ready], search)){
+        ready++;
+    }
+
+    search->clues = clues;
+    CellSet none = {{0, 0}};
+    uint64_t all[SET_WORDS];
+    int seen = 0;
+    if(ready > 0){
+        refresh(&workers[0], all, &seen, &none);
+    }
+    for(int depth = 1; ready > 0 && depth <= MAX_JOB_DEPTH; depth++){
+        search->numJobs = 0;
+        if(!makeJobs(&workers[0], all, seen, none, none, 0, depth)){
+            search->numJobs = 0;
+            makeJobs(&workers[0], all, seen, none, none, 0, depth - 1);
+            break;
+        }
+        if(search->numJobs >= search->threads * JOBS_PER_THREAD){
+            break;
+        }
+    }
+    atomic_store(&search->nextJob, 0);
+    atomic_store(&search->found, false);
+
+    thrd_t ids[MINCLUE_MAX_THREADS];
+    int started = 0;
+    if(ready == 1){
+        searchJobs(&workers[0]);
+        started = 1;
+    }
+    else{
+        for(; started < ready; started++){
+            if(thrd_create(&ids[started], searchJobs, &workers[started]) !=
+               thrd_success){
+                break;
+            }
+        }
+        for(int t = 0; t < started; t++){
+            thrd_join(ids[t], NULL);
+        }
+    }
+
+    //Keeps what the threads learned for the next clue count
+    int before = search->known.count;
+    for(int t = 0; t < started; t++){
+        for(int s = before; s < workers[t].sets.count; s++){
+            bool seen = false;
+            for(int k = before; k < search->known.count && !seen; k++){
+                seen = memcmp(&search->known.sets[k], &workers[t].sets.sets[s],
+                              sizeof(CellSet)) == 0;
+            }
+            if(!seen && search->known.count < search->known.capacity){
+                search->known.sets[search->known.count++] =
+                    workers[t].sets.sets[s];
+            }
+        }
+        search->nodes += workers[t].nodes;
+        search->checks += workers[t].checks;
+    }
+    qsort(search->known.sets, search->known.count, sizeof(CellSet),
+          compareSize);
+    for(int t = 0; t < ready; t++){
+        free(workers[t].sets.sets);
+    }
+    free(workers);
+    //Any thread that did start still went through every job
+    if(started == 0){
+        return -1;
+    }
+    if(!atomic_load(&search->found)){
+        return 0;
+    }
+    memcpy(puzzle, search->best, NUMCELLS);
+    return 1;
+}
+
+/**
+ * Writes the smallest unique puzzle found so far, by the greedy removal or
+ * by searchClues, to `puzzle` and returns its number of clues.
+ */
+int smallestPuzzle(const MinClueSearch *search, uint8_t *puzzle)
+{
+    memcpy(puzzle, search->best, NUMCELLS);
+    return search->bestClues;
+}
+
+/**
+ * Writes the sets, bound and work so far of the search to `stats`.
+ */
+void getMinClueStats(const MinClueSearch *search, MinClueStats *stats)
+{
+    stats->sets = search->known.count;
+    stats->upperBound = search->bestClues;
+    stats->nodes = search->nodes;
+    stats->checks = search->checks;
+}
+
+/**
+ * Frees the given search.
+ */
+void deleteMinClue(MinClueSearch *search)
+{
+    if(search != NULL){
+        free(search->known.sets);
+        free(search->jobs);
+        free(search);
+    }
+}
+
+/**
+ * Fills the known list with the unavoidable sets found by blanking every
+ * set of 2 to MINCLUE_SET_DIGITS digits out of the grid, and then every
+ * band and stack, and taking each other way of filling them back in,
+ * keeping the smallest first and only those that do not contain another.
+ * The digit blanks give the sets of few digits, the band and stack blanks
+ * the larger ones of up to nine digits that stay within three boxes. Returns
+ * false if the sets could not be allocated.
+ */
+static bool collectSets(MinClueSearch *search)
+{
+    SetList raw = {malloc(RAW_SETS * sizeof(CellSet)), 0, RAW_SETS,
+                   {{0, 0}}};
+    if(raw.sets == NULL){
+        return false;
+    }
+    for(int digits = 1; digits <= ALLDIGITS; digits++){
+        int size = __builtin_popcount(digits);
+        if(size < 2 || size > MINCLUE_SET_DIGITS){
+            continue;
+        }
+        CellSet kept = {{0, 0}};
+        for(int i = 0; i < NUMCELLS; i++){
+            if(!(digits & (1 << (search->grid[i] - 1)))){
+                addCell(&kept, i);
+            }
+        }
+        if(raw.count < raw.capacity){
+            countOthers(search->grid, &kept, &raw, raw.capacity - raw.count);
+        }
+    }
+    for(int band = 0; band < 6; band++){ //Bands 0 - 2, then stacks 3 - 5
+        CellSet kept = {{0, 0}};
+        for(int i = 0; i < NUMCELLS; i++){
+            int line = band < 3 ? i / BOARDSIZE : i % BOARDSIZE;
+            if(line / 3 != band % 3){
+                addCell(&kept, i);
+            }
+        }
+        if(raw.count < raw.capacity){
+            countOthers(search->grid, &kept, &raw, raw.capacity - raw.count);
+        }
+    }
+
+    qsort(raw.sets, raw.count, sizeof(CellSet), compareSize);
+    for(int s = 0; s < raw.count &&
+        search->known.count < search->known.capacity; s++){
+        const CellSet *set = &raw.sets[s];
+        bool minimal = true;
+        for(int k = 0; k < search->known.count && minimal; k++){
+            const CellSet *small = &search->known.sets[k];
+            minimal = (small->bits[0] & ~set->bits[0]) != 0 ||
+                      (small->bits[1] & ~set->bits[1]) != 0;
+        }
+        if(minimal){
+            search->known.sets[search->known.count++] = *set;
+        }
+    }
+    free(raw.sets);
+    return true;
+}
+
+/**
+ * Finds the first upper bound: starting from the full grid, removes the
+ * clues one at a time in a random order, putting each back if the puzzle
+ * is no longer unique, and keeps the smallest of MINCLUE_GREEDY_TRIES such
+ * puzzles. The sets learned on the way are added to the known list.
+ */
+static void greedyBound(MinClueSearch *search)
+{
+    uint64_t random = 1;
+    search->bestClues = NUMCELLS + 1;
+    for(int t = 0; t < MINCLUE_GREEDY_TRIES; t++){
+        uint8_t order[NUMCELLS];
+        for(int i = 0; i < NUMCELLS; i++){
+            order[i] = i;
+        }
+        for(int i = NUMCELLS - 1; i > 0; i--){
+            int j = nextRandom(&random) % (i + 1);
+            uint8_t swap = order[i];
+            order[i] = order[j];
+            order[j] = swap;
+        }
+        CellSet clues = {{~(uint64_t)0, ((uint64_t)1 << (NUMCELLS - 64)) - 1}};
+        int numClues = NUMCELLS;
+        for(int k = 0; k < NUMCELLS; k++){
+            int cell = order[k];
+            clues.bits[cell / 64] &= ~((uint64_t)1 << (cell % 64));
+            if(countOthers(search->grid, &clues, &search->known, 1) == 0){
+                numClues--;
+            }
+            else{
+                addCell(&clues, cell);
+            }
+        }
+        if(numClues < search->bestClues){
+            search->bestClues = numClues;
+            for(int i = 0; i < NUMCELLS; i++){
+                search->best[i] = inSet(&clues, i) ? search->grid[i] : 0;
+            }
+        }
+    }
+    qsort(search->known.sets, search->known.count, sizeof(CellSet),
+          compareSize);
+}
+
+/**
+ * Gives the worker its own copy of the known sets, with room for the ones
+ * it learns, and enters them in its cell vectors. Returns false if the copy
+ * could not be allocated.
+ */
+static bool initWorker(HitWorker *worker, MinClueSearch *search)
+{
+    worker->search = search;
+    worker->nodes = worker->checks = 0;
+    worker->sets.capacity = WORKER_SETS;
+    worker->sets.count = search->known.count;
+    worker->sets.sets = malloc(WORKER_SETS * sizeof(CellSet));
+    worker->sets.newest = (CellSet){{0, 0}};
+    if(worker->sets.sets == NULL){
+        return false;
+    }
+    memcpy(worker->sets.sets, search->known.sets,
+           search->known.count * sizeof(CellSet));
+    memset(worker->cellSets, 0, sizeof(worker->cellSets));
+    worker->indexed = 0;
+    uint64_t unhit[SET_WORDS];
+    int seen = worker->sets.count; //Indexes every set without touching unhit
+    refresh(worker, unhit, &seen, &worker->sets.newest);
+    return true;
+}
+
+/**
+ * Expands the hitting set search `depth` levels below the given node,
+ * adding every branch still alive there (or that already hits every set) to
+ * the job list. `unhit` holds the first `seen` sets not hit by `chosen`.
+ * Returns false if the list would overflow.
+ */
+static bool makeJobs(HitWorker *worker, const uint64_t *unhit, int seen,
+                     CellSet chosen, CellSet closed, int size, int depth)
+{
+    MinClueSearch *search = worker->search;
+    CellSet branch;
+    CellSet rest;
+    int pick = pickSet(worker, unhit, seen, &closed, search->clues - size,
+                       &branch, &rest);
+    if(pick == -2){
+        return true;
+    }
+    if(pick == -1 || depth == 0){
+        if(search->numJobs == MAX_JOBS){
+            return false;
+        }
+        HitJob *job = &search->jobs[search->numJobs++];
+        job->chosen = chosen;
+        job->closed = closed;
+        job->size = size;
+        return true;
+    }
+    for(int cell = 0; cell < NUMCELLS; cell++){
+        if(!inSet(&branch, cell) || inSet(&closed, cell)){
+            continue;
+        }
+        uint64_t next[SET_WORDS];
+        for(int w = 0; w < (seen + 63) / 64; w++){
+            next[w] = unhit[w] & ~worker->cellSets[cell][w];
+        }
+        CellSet more = chosen;
+        addCell(&more, cell);
+        CellSet below = {{closed.bits[0] | ~rest.bits[0],
+                          closed.bits[1] | ~rest.bits[1]}};
+        if(!makeJobs(worker, next, seen, more, below, size + 1, depth - 1)){
+            return false;
+        }
+        addCell(&closed, cell);
+    }
+    return true;
+}
+
+/**
+ * Thread body: claims jobs one at a time until the list is empty or a
+ * unique puzzle has been found, and searches below each.
+ */
+static int searchJobs(void *arg)
+{
+    HitWorker *worker = arg;
+    MinClueSearch *search = worker->search;
+    int j;
+    while(!atomic_load(&search->found) &&
+          (j = atomic_fetch_add(&search->nextJob, 1)) < search->numJobs){
+        HitJob *job = &search->jobs[j];
+        uint64_t unhit[SET_WORDS];
+        int seen = 0;
+        refresh(worker, unhit, &seen, &job->chosen);
+        searchHits(worker, unhit, seen, job->chosen, job->closed, job->size);
+    }
+    return 0;
+}
+
+/**
+ * Searches the hitting sets below the node with the given clues placed and
+ * cells closed, where `unhit` holds the first `seen` sets of the worker's
+ * list not hit by the clues. Once every set is hit the clues are checked; a
+ * puzzle that is not unique hands back a new set to branch on. The first
+ * unique puzzle found by any thread is written to the search.
+ */
+static void searchHits(HitWorker *worker, uint64_t *unhit, int seen,
+                       CellSet chosen, CellSet closed, int size)
+{
+    MinClueSearch *search = worker->search;
+    if(atomic_load(&search->found)){
+        return;
+    }
+    worker->nodes++;
+    refresh(worker, unhit, &seen, &chosen);
+    CellSet branch;
+    CellSet rest;
+    int pick = pickSet(worker, unhit, seen, &closed, search->clues - size,
+                       &branch, &rest);
+    if(pick == -2){
+        return;
+    }
+    if(pick == -1){
+        worker->checks++;
+        if(countOthers(search->grid, &chosen, &worker->sets, 1) == 0){
+            if(!atomic_exchange(&search->found, true)){
+                for(int i = 0; i < NUMCELLS; i++){
+                    search->best[i] = inSet(&chosen, i) ? search->grid[i] : 0;
+                }
+                search->bestClues = size;
+            }
+            return;
+        }
+        if(size == search->clues){
+            return;
+        }
+        branch = worker->sets.newest;
+        refresh(worker, unhit, &seen, &chosen);
+    }
+
+    for(int cell = 0; cell < NUMCELLS; cell++){
+        if(!inSet(&branch, cell) || inSet(&closed, cell)){
+            continue;
+        }
+        uint64_t next[SET_WORDS];
+        for(int w = 0; w < (seen + 63) / 64; w++){
+            next[w] = unhit[w] & ~worker->cellSets[cell][w];
+        }
+        CellSet more = chosen;
+        addCell(&more, cell);
+        CellSet below = {{closed.bits[0] | ~rest.bits[0],
+                          closed.bits[1] | ~rest.bits[1]}};
+        searchHits(worker, next, seen, more, below, size + 1);
+        if(atomic_load(&search->found)){
+            return;
+        }
+        refresh(worker, unhit, &seen, &chosen);
+        addCell(&closed, cell);
+    }
+}
+
+/**
+ * Catches a node up with the sets its worker has learned: enters any new
+ * sets in the cell vectors, then sets the bit in `unhit` of every set from
+ * `seen` on that `chosen` does not hit and moves `seen` to the end of the
+ * list.
+ */
+static void refresh(HitWorker *worker, uint64_t *unhit, int *seen,
+                    const CellSet *chosen)
+{
+    for(; worker->indexed < worker->sets.count; worker->indexed++){
+        int s = worker->indexed;
+        for(int cell = 0; cell < NUMCELLS; cell++){
+            if(inSet(&worker->sets.sets[s], cell)){
+                worker->cellSets[cell][s / 64] |= (uint64_t)1 << (s % 64);
+            }
+        }
+    }
+    for(int s = *seen; s < worker->sets.count; s++){
+        uint64_t bit = (uint64_t)1 << (s % 64);
+        if(s % 64 == 0){
+            unhit[s / 64] = 0;
+        }
+        if(!meets(&worker->sets.sets[s], chosen)){
+            unhit[s / 64] |= bit;
+        }
+        else{
+            unhit[s / 64] &= ~bit;
+        }
+    }
+    *seen = worker->sets.count;
+}
+
+/**
+ * Picks what a node branches on from the sets it has not hit (the first
+ * SCAN_SETS of them): the open cells, those not closed, of the one with the
+ * fewest of them (of the first PICK_SETS), written to `branch`. Returns -1
+ * if every set is hit, -2 if the node can be pruned and 0 otherwise.
+ *
+ * The bound packs sets with no open cell in common, smallest first, each of
+ * which needs a clue of its own, and prunes once there are more than the
+ * `left` clues left. When there are exactly as many the clues are spoken
+ * for, one per packed set, which tighten uses to narrow down the cells each
+ * packed set can take its clue from; the node then branches on the packed
+ * set with the fewest such cells, and `rest` gets the cells of the others,
+ * the only ones the clues after this one can go in. Otherwise `rest` is
+ * every cell.
+ */
+static int pickSet(const HitWorker *worker, const uint64_t *unhit, int seen,
+                   const CellSet *closed, int left, CellSet *branch,
+                   CellSet *rest)
+{
+    CellSet opens[SCAN_SETS];
+    CellSet packed[NUMCELLS];
+    int bestSize = NUMCELLS + 1;
+    int disjoint = 0;
+    int scanned = 0;
+    CellSet used = {{0, 0}};
+    for(int w = 0; w < (seen + 63) / 64 && scanned < SCAN_SETS; w++){
+        uint64_t bits = unhit[w];
+        while(bits != 0 && scanned < SCAN_SETS){
+            const CellSet *set = &worker->sets.sets[w * 64 +
+                                                    __builtin_ctzll(bits)];
+            CellSet open = {{set->bits[0] & ~closed->bits[0],
+                             set->bits[1] & ~closed->bits[1]}};
+            int size = setSize(&open);
+            if(size == 0){
+                return -2;
+            }
+            if(scanned < PICK_SETS && size < bestSize){
+                *branch = open;
+                bestSize = size;
+            }
+            if(!meets(&open, &used)){
+                if(disjoint == left){
+                    return -2;
+                }
+                packed[disjoint++] = open;
+                used.bits[0] |= open.bits[0];
+                used.bits[1] |= open.bits[1];
+            }
+            opens[scanned++] = open;
+            bits &= bits - 1;
+        }
+    }
+    *rest = (CellSet){{~(uint64_t)0, ((uint64_t)1 << (NUMCELLS - 64)) - 1}};
+    if(scanned == 0){
+        return -1;
+    }
+    if(disjoint < left){
+        return 0;
+    }
+    if(!tighten(opens, scanned, packed, disjoint)){
+        return -2;
+    }
+    int pick = 0;
+    *rest = (CellSet){{0, 0}};
+    for(int p = 0; p < disjoint; p++){
+        if(setSize(&packed[p]) < setSize(&packed[pick])){
+            pick = p;
+        }
+    }
+    for(int p = 0; p < disjoint; p++){
+        if(p != pick){
+            rest->bits[0] |= packed[p].bits[0];
+            rest->bits[1] |= packed[p].bits[1];
+        }
+    }
+    *branch = packed[pick];
+    return 0;
+}
+
+/**
+ * Narrows down the `packs` packed sets, which have no cell in common and
+ * take the last `packs` clues between them, one each. No clue can go
+ * outside them then, so a set of the `scanned` in `opens` that meets only
+ * one packed set has its clue in that one, which can then only take a cell
+ * the two share. Repeats until nothing changes, and returns false if some
+ * scanned set is left meeting no packed set at all.
+ */
+static bool tighten(const CellSet *opens, int scanned, CellSet *packed,
+                    int packs)
+{
+    bool changed = true;
+    while(changed){
+        changed = false;
+        for(int s = 0; s < scanned; s++){
+            int only = -1;
+            int meetsCount = 0;
+            for(int p = 0; p < packs && meetsCount < 2; p++){
+                if(meets(&opens[s], &packed[p])){
+                    only = p;
+                    meetsCount++;
+                }
+            }
+            if(meetsCount == 0){
+                return false;
+            }
+            if(meetsCount > 1){
+                continue;
+            }
+            CellSet narrowed = {{packed[only].bits[0] & opens[s].bits[0],
+                                 packed[only].bits[1] & opens[s].bits[1]}};
+            if(memcmp(&narrowed, &packed[only], sizeof(CellSet)) != 0){
+                packed[only] = narrowed;
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Counts the solutions other than `grid` of the puzzle made of the grid's
+ * digits in the given cells, with searchUnits, and adds the cells where each
+ * one differs from the grid to `found` as an unavoidable set. Returns the
+ * number of other solutions found, never more than `limit`, which must be
+ * at least 1.
+ */
+static long countOthers(const uint8_t *grid, const CellSet *cells,
+                        SetList *found, long limit)
+{
+    uint8_t values[NUMCELLS] = {0};
+    uint16_t used[3 * BOARDSIZE] = {0};
+    UnitView view = {values, NULL, used};
+    for(int i = 0; i < NUMCELLS; i++){
+        if(inSet(cells, i)){
+            placeUnitDigit(gridUnits(), &view, i, grid[i]);
+        }
+    }
+    OtherSearch other = {grid, found};
+    SolverStats stats;
+    return searchUnits(gridUnits(), &view, passOthers, &other, limit, &stats);
+}
+
+/**
+ * The pass countOthers runs on every node: the singles pass, then, once
+ * the board is full, a check that it is not the grid itself (which ends
+ * the branch) and the set of cells where it differs from the grid, added to
+ * the search's list.
+ */
+static bool passOthers(const UnitGraph *graph, const UnitView *view,
+                       int depth, const void *arg)
+{
+    const OtherSearch *other = arg;
+    if(!propagateUnits(graph, view)){
+        return false;
+    }
+    if(memchr(view->values, 0, NUMCELLS) != NULL){
+        return true;
+    }
+    if(memcmp(view->values, other->grid, NUMCELLS) == 0){
+        return false;
+    }
+    CellSet set = {{0, 0}};
+    for(int i = 0; i < NUMCELLS; i++){
+        if(view->values[i] != other->grid[i]){
+            addCell(&set, i);
+        }
+    }
+    addSet(other->found, &set);
+    return true;
+}
+
+/**
+ * Adds the set to the end of the list if there is room, and always makes it
+ * the list's newest set.
+ */
+static void addSet(SetList *list, const CellSet *set)
+{
+    if(list->count < list->capacity){
+        list->sets[list->count++] = *set;
+    }
+    list->newest = *set;
+}
+
+/**
+ * qsort comparator putting smaller sets first.
+ */
+static int compareSize(const void *a, const void *b)
+{
+    return setSize(a) - setSize(b);
+}
+
+/**
+ * Returns the number of cells in the set.
+ */
+static int setSize(const CellSet *set)
+{
+    return __builtin_popcountll(set->bits[0]) +
+           __builtin_popcountll(set->bits[1]);
+}
+
+/**
+ * Returns true if the two sets have a cell in common.
+ */
+static bool meets(const CellSet *a, const CellSet *b)
+{
+    return (a->bits[0] & b->bits[0]) != 0 || (a->bits[1] & b->bits[1]) != 0;
+}
+
+/**
+ * Returns true if the cell is in the set.
+ */
+static bool inSet(const CellSet *set, int cell)
+{
+    return (set->bits[cell / 64] >> (cell % 64)) & 1;
+}
+
+/**
+ * Adds the given cell to the set.
+ */
+static void addCell(CellSet *set, int cell)
+{
+    set->bits[cell / 64] |= (uint64_t)1 << (cell % 64);
+}
+
+/**
+ * Returns the next number from a splitmix64 generator.
+ */
+static uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
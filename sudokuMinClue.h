@@ -0,0 +1,99 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements finding the fewest clues a unique puzzle for a given solution
+ * grid can have, the way the search that showed there is no 16 clue sudoku
+ * went about it.
+ *
+ * An unavoidable set of a grid is a set of cells that can be filled another
+ * way with the rest of the grid left as it is. A puzzle with no clue in one
+ * of them has two solutions, so the clues of every unique puzzle form a
+ * hitting set of the grid's unavoidable sets. The search collects many of
+ * them up front (the second solutions of the grid with every set of two,
+ * three or four digits blanked out, keeping those not containing another)
+ * and then, for a given number of clues k, enumerates the hitting sets of k
+ * cells by branch and bound:
+ *
+ *  - branch on the cells of the unhit set with the fewest cells still open,
+ *    and once a cell has been tried close it for the branches after it, so
+ *    no set of cells is reached twice,
+ *  - prune when a set has no open cells left, or when more unhit sets with
+ *    no open cell in common than there are clues left to place are found
+ *    (each needs a clue of its own).
+ *
+ * A set of cells hitting every known set is checked by searching for a
+ * solution other than the grid. If there is none the puzzle is unique and
+ * the search is over; otherwise the cells where that solution differs from
+ * the grid are a new unavoidable set, which is added to the list and
+ * branched on, so the list keeps improving as the search goes.
+ *
+ * The branches a few levels down are shared out over threads, each with its
+ * own copy of the list, which stop as soon as any finds a unique puzzle. The
+ * sets each thread learns are merged back after every clue count.
+ */
+#ifndef SUDOKU_MINCLUE_H
+#define SUDOKU_MINCLUE_H
+
+#include "./sudokuSolver.h"
+
+#define MINCLUE_MAX_THREADS 64
+#define MINCLUE_SET_DIGITS 4      //Most digits blanked when collecting sets
+#define MINCLUE_MAX_SETS 4096     //Unavoidable sets kept at most
+#define MINCLUE_GREEDY_TRIES 16   //Random clue removal orders for the bound
+
+typedef struct minClueSearch MinClueSearch;
+
+typedef struct minClueStats{
+    int sets;              //Unavoidable sets known
+    int upperBound;        //Clues of the smallest unique puzzle found yet
+    unsigned long nodes;   //Hitting set nodes searched
+    unsigned long checks;  //Hitting sets checked for uniqueness
+}MinClueStats;
+
+/********* function prototypes *********/
+
+MinClueSearch *initMinClue(const uint8_t *grid, int threads);
+int searchClues(MinClueSearch *search, int clues, uint8_t *puzzle);
+int smallestPuzzle(const MinClueSearch *search, uint8_t *puzzle);
+void getMinClueStats(const MinClueSearch *search, MinClueStats *stats);
+void deleteMinClue(MinClueSearch *search);
+
+/**
+ * Prepares a search of the given solution grid (81 values) over `threads`
+ * threads: collects its unavoidable sets and finds a first unique puzzle by
+ * removing clues in random orders while the puzzle stays unique, whose size
+ * bounds the answer from above.
+ *
+ * Returns NULL if `grid` is NULL or not a full legal grid, `threads` is out
+ * of range or the search could not be allocated. The search must be freed
+ * with deleteMinClue.
+ */
+MinClueSearch *initMinClue(const uint8_t *grid, int threads);
+
+/**
+ * Searches every set of `clues` cells that hits all the known unavoidable
+ * sets. Returns 1 if one of them, or of fewer cells, is a unique puzzle,
+ * writing it to `puzzle` as 81 values (0 for an empty cell), 0 if none is
+ * (so every unique puzzle of the grid has more clues) and -1 if an argument
+ * is NULL or no thread could be started.
+ */
+int searchClues(MinClueSearch *search, int clues, uint8_t *puzzle);
+
+/**
+ * Writes the smallest unique puzzle found so far, by the greedy removal or
+ * by searchClues, to `puzzle` and returns its number of clues.
+ */
+int smallestPuzzle(const MinClueSearch *search, uint8_t *puzzle);
+
+/**
+ * Writes the sets, bound and work so far of the search to `stats`.
+ */
+void getMinClueStats(const MinClueSearch *search, MinClueStats *stats);
+
+/**
+ * Frees the given search.
+ */
+void deleteMinClue(MinClueSearch *search);
+
+#endif
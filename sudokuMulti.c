@@ -0,0 +1,255 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements the overlapping grid solver. See sudokuMulti.h for the model.
+ *
+ * The cells covered by some grid are numbered in canvas order and only those
+ * numbers are used from then on. A MultiBoard holds everything that depends
+ * on the layout alone (the unit graph of the cells) and is built once per
+ * call, while a MultiState only holds what the search changes. The pass and
+ * the search are the ones of sudokuSolver run over that graph.
+ */
+#include "./sudokuMulti.h"
+
+typedef struct multiBoard{
+    UnitGraph graph;                                 //Units of the cells
+    int16_t cellAt[MULTI_MAX_SIDE * MULTI_MAX_SIDE]; //-1 for a gap
+    int16_t canvasOf[UNIT_MAX_CELLS];                //Inverse of cellAt
+}MultiBoard;
+
+typedef struct multiState{
+    uint8_t values[UNIT_MAX_CELLS]; //0 if the cell is empty
+    uint16_t used[UNIT_MAX_UNITS];  //digits placed in each unit
+}MultiState;
+
+/********* function prototypes *********/
+
+void samuraiLayout(MultiLayout *layout);
+bool checkLayout(const MultiLayout *layout);
+bool inLayout(const MultiLayout *layout, int row, int col);
+bool solveMulti(const MultiLayout *layout, const uint8_t *values,
+                uint8_t *solution, SolverStats *stats);
+long countMulti(const MultiLayout *layout, const uint8_t *values, long limit,
+                SolverStats *stats);
+static MultiBoard *buildBoard(const MultiLayout *layout);
+static void addGridUnit(MultiBoard *board, const int16_t *cells);
+static bool loadMulti(MultiState *state, const MultiBoard *board,
+                      const MultiLayout *layout, const uint8_t *values);
+
+/**
+ * Writes the Samurai layout to `layout`: a SAMURAI_SIDE by SAMURAI_SIDE
+ * canvas with a grid in each corner and one in the middle sharing a square
+ * with each of them.
+ */
+void samuraiLayout(MultiLayout *layout)
+{
+    static const int tops[] = {0, 0, 6, 12, 12};
+    static const int lefts[] = {0, 12, 6, 0, 12};
+    layout->numGrids = 5;
+    layout->rows = SAMURAI_SIDE;
+    layout->cols = SAMURAI_SIDE;
+    for(int g = 0; g < layout->numGrids; g++){
+        layout->top[g] = tops[g];
+        layout->left[g] = lefts[g];
+    }
+}
+
+/**
+ * Returns true if the layout has 1 to MULTI_MAX_GRIDS grids, a canvas of at
+ * most MULTI_MAX_SIDE cells a side, and every grid inside the canvas.
+ */
+bool checkLayout(const MultiLayout *layout)
+{
+    if(layout == NULL || layout->numGrids < 1 ||
+       layout->numGrids > MULTI_MAX_GRIDS || layout->rows < BOARDSIZE ||
+       layout->rows > MULTI_MAX_SIDE || layout->cols < BOARDSIZE ||
+       layout->cols > MULTI_MAX_SIDE){
+        return false;
+    }
+    for(int g = 0; g < layout->numGrids; g++){
+        if(layout->top[g] < 0 || layout->top[g] + BOARDSIZE > layout->rows ||
+           layout->left[g] < 0 ||
+           layout->left[g] + BOARDSIZE > layout->cols){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns true if the canvas cell at `row`, `col` is covered by some grid of
+ * the layout, false if it is a gap or off the canvas.
+ */
+bool inLayout(const MultiLayout *layout, int row, int col)
+{
+    for(int g = 0; g < layout->numGrids; g++){
+        if(row >= layout->top[g] && row < layout->top[g] + BOARDSIZE &&
+           col >= layout->left[g] && col < layout->left[g] + BOARDSIZE){
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Solves the puzzle whose clues are given as `rows` * `cols` canvas values
+ * row by row (0 for an empty cell or a gap). On success the solution is
+ * written to `solution` in the same form, with 0 in the gaps, and true is
+ * returned.
+ *
+ * This function will return false if either array is NULL, the layout is
+ * not legal, a gap holds a digit, the clues repeat a digit in any unit or
+ * the puzzle has no solution. If `stats` is not NULL the search statistics
+ * are written to it.
+ */
+bool solveMulti(const MultiLayout *layout, const uint8_t *values,
+                uint8_t *solution, SolverStats *stats)
+{
+    SolverStats local;
+    if(solution == NULL || !checkLayout(layout)){
+        return false;
+    }
+    MultiBoard *board = buildBoard(layout);
+    MultiState *state = malloc(sizeof(MultiState));
+    if(board == NULL || state == NULL){
+        free(board);
+        free(state);
+        return false;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    UnitView view = {state->values, NULL, state->used};
+    bool solved = loadMulti(state, board, layout, values) &&
+                  searchUnits(&board->graph, &view, NULL, NULL, 1, stats) == 1;
+    if(solved){
+        memset(solution, 0, layout->rows * layout->cols);
+        for(int cell = 0; cell < board->graph.numCells; cell++){
+            solution[board->canvasOf[cell]] = state->values[cell];
+        }
+    }
+    free(board);
+    free(state);
+    return solved;
+}
+
+/**
+ * Counts the solutions of the puzzle like countSolutions, stopping once
+ * `limit` have been found.
+ *
+ * Returns -1 if the layout or the clues are not legal (as for solveMulti).
+ */
+long countMulti(const MultiLayout *layout, const uint8_t *values, long limit,
+                SolverStats *stats)
+{
+    SolverStats local;
+    if(!checkLayout(layout)){
+        return -1;
+    }
+    MultiBoard *board = buildBoard(layout);
+    MultiState *state = malloc(sizeof(MultiState));
+    if(board == NULL || state == NULL){
+        free(board);
+        free(state);
+        return -1;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    UnitView view = {state->values, NULL, state->used};
+    long count = -1;
+    if(loadMulti(state, board, layout, values)){
+        count = searchUnits(&board->graph, &view, NULL, NULL, limit, stats);
+    }
+    free(board);
+    free(state);
+    return count;
+}
+
+/**
+ * Numbers the cells the grids of a legal layout cover and builds the unit
+ * lists over them. Returns NULL if the memory could not be allocated.
+ */
+static MultiBoard *buildBoard(const MultiLayout *layout)
+{
+    MultiBoard *board = malloc(sizeof(MultiBoard));
+    if(board == NULL){
+        return NULL;
+    }
+    int numCells = 0;
+    for(int row = 0; row < layout->rows; row++){
+        for(int col = 0; col < layout->cols; col++){
+            int at = row * layout->cols + col;
+            board->cellAt[at] = -1;
+            if(inLayout(layout, row, col)){
+                board->canvasOf[numCells] = at;
+                board->cellAt[at] = numCells++;
+            }
+        }
+    }
+    initUnitGraph(&board->graph, numCells);
+
+    for(int g = 0; g < layout->numGrids; g++){
+        for(int unit = 0; unit < 3 * BOARDSIZE; unit++){
+            int16_t cells[BOARDSIZE];
+            int n = unit % BOARDSIZE;
+            for(int k = 0; k < BOARDSIZE; k++){
+                int row = unit < BOARDSIZE ? n :
+                          unit < 2 * BOARDSIZE ? k : (n / 3) * 3 + k / 3;
+                int col = unit < BOARDSIZE ? k :
+                          unit < 2 * BOARDSIZE ? n : (n % 3) * 3 + k % 3;
+                row += layout->top[g];
+                col += layout->left[g];
+                cells[k] = board->cellAt[row * layout->cols + col];
+            }
+            addGridUnit(board, cells);
+        }
+    }
+    return board;
+}
+
+/**
+ * Adds a unit made of the given cells to the board unless another grid
+ * already added the same one (a shared square, or a row or column two grids
+ * have in common), which would only make every pass look at it twice.
+ */
+static void addGridUnit(MultiBoard *board, const int16_t *cells)
+{
+    UnitGraph *graph = &board->graph;
+    //Units of different grids list a shared region in the same order
+    for(int u = 0; u < graph->numUnits; u++){
+        if(memcmp(graph->units[u], cells, sizeof(graph->units[u])) == 0){
+            return;
+        }
+    }
+    addUnit(graph, cells, BOARDSIZE);
+}
+
+/**
+ * Loads the canvas values into an empty state. Returns false if `values` is
+ * NULL, holds anything above 9, has a digit in a gap or repeats a digit in
+ * any unit.
+ */
+static bool loadMulti(MultiState *state, const MultiBoard *board,
+                      const MultiLayout *layout, const uint8_t *values)
+{
+    if(values == NULL){
+        return false;
+    }
+    memset(state, 0, sizeof(MultiState));
+    UnitView view = {state->values, NULL, state->used};
+    for(int at = 0; at < layout->rows * layout->cols; at++){
+        if(values[at] == 0){
+            continue;
+        }
+        int cell = board->cellAt[at];
+        if(cell < 0 || values[at] > 9 ||
+           !placeUnitDigit(&board->graph, &view, cell, values[at])){
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,95 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a solver for puzzles made of several overlapping 9x9 grids,
+ * such as Samurai sudoku where four grids each share a corner square with a
+ * fifth one in the middle. The grids are laid out on one canvas of `rows` by
+ * `cols` cells, each grid at its own top left corner, and a canvas cell
+ * covered by more than one grid is a single cell bound by the rows, columns
+ * and squares of all of them. Canvas cells that no grid covers are gaps and
+ * always hold 0.
+ *
+ * Solving the grids one at a time and patching up the shared squares
+ * afterwards throws away exactly the constraints that make these puzzles
+ * hard, so the layout is turned into one list of units over the combined
+ * cells instead (the 27 units of every grid, with a unit shared by two grids
+ * such as an overlapping square kept once), along with the list of units
+ * each cell is in, as a UnitGraph of sudokuSolver. The state is the value
+ * of every cell plus a mask per unit of the digits placed in it, so the
+ * candidates of a cell are the digits missing from all of its units. Naked
+ * and hidden singles are propagated over those units by the solver's own
+ * pass, which carries whatever is placed in a shared square into every grid
+ * around it straight away, and one search branching on the cell with the
+ * fewest candidates covers the whole canvas.
+ */
+#ifndef SUDOKU_MULTI_H
+#define SUDOKU_MULTI_H
+
+#include "./sudokuSolver.h"
+
+#define MULTI_MAX_GRIDS UNIT_MAX_GRIDS
+#define MULTI_MAX_SIDE 36 //Largest number of rows or columns of the canvas
+#define SAMURAI_SIDE 21   //Rows and columns of the Samurai canvas
+
+typedef struct multiLayout{
+    int numGrids;
+    int rows;                   //Size of the canvas
+    int cols;
+    int top[MULTI_MAX_GRIDS];   //Canvas row of each grid's top left cell
+    int left[MULTI_MAX_GRIDS];  //Canvas column of each grid's top left cell
+}MultiLayout;
+
+/********* function prototypes *********/
+
+void samuraiLayout(MultiLayout *layout);
+bool checkLayout(const MultiLayout *layout);
+bool inLayout(const MultiLayout *layout, int row, int col);
+bool solveMulti(const MultiLayout *layout, const uint8_t *values,
+                uint8_t *solution, SolverStats *stats);
+long countMulti(const MultiLayout *layout, const uint8_t *values, long limit,
+                SolverStats *stats);
+
+/**
+ * Writes the Samurai layout to `layout`: a SAMURAI_SIDE by SAMURAI_SIDE
+ * canvas with a grid in each corner and one in the middle sharing a square
+ * with each of them.
+ */
+void samuraiLayout(MultiLayout *layout);
+
+/**
+ * Returns true if the layout has 1 to MULTI_MAX_GRIDS grids, a canvas of at
+ * most MULTI_MAX_SIDE cells a side, and every grid inside the canvas.
+ */
+bool checkLayout(const MultiLayout *layout);
+
+/**
+ * Returns true if the canvas cell at `row`, `col` is covered by some grid of
+ * the layout, false if it is a gap or off the canvas.
+ */
+bool inLayout(const MultiLayout *layout, int row, int col);
+
+/**
+ * Solves the puzzle whose clues are given as `rows` * `cols` canvas values
+ * row by row (0 for an empty cell or a gap). On success the solution is
+ * written to `solution` in the same form, with 0 in the gaps, and true is
+ * returned.
+ *
+ * This function will return false if either array is NULL, the layout is
+ * not legal, a gap holds a digit, the clues repeat a digit in any unit or
+ * the puzzle has no solution. If `stats` is not NULL the search statistics
+ * are written to it.
+ */
+bool solveMulti(const MultiLayout *layout, const uint8_t *values,
+                uint8_t *solution, SolverStats *stats);
+
+/**
+ * Counts the solutions of the puzzle like countSolutions, stopping once
+ * `limit` have been found.
+ *
+ * Returns -1 if the layout or the clues are not legal (as for solveMulti).
+ */
+long countMulti(const MultiLayout *layout, const uint8_t *values, long limit,
+                SolverStats *stats);
+
+#endif
@@ -0,0 +1,409 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements the pattern generator. See sudokuPattern.h for the method.
+ *
+ * A variant is kept as a map from each of its cells to the cell of the grid
+ * it came from, and unavoidable sets are kept as 81-bit sets of grid cells,
+ * so the filter maps the pattern through the variant once and then only has
+ * to AND it with each set. Grid g is always built from the same random
+ * numbers (drawn from the seed and g), whichever thread claims it.
+ */
+#include <threads.h>
+#include <stdatomic.h>
+#include "./sudokuPattern.h"
+
+typedef struct cellSet{
+    uint64_t bits[2]; //Cells 0 - 63, then 64 - 80
+}CellSet;
+
+typedef struct patternSearch{
+    const bool *clues;
+    unsigned long maxGrids;
+    uint64_t seed;
+    atomic_ulong nextGrid;
+    atomic_bool found;     //Set by the first thread to find a puzzle
+    uint8_t *puzzle;
+    uint8_t *solution;
+    PatternStats totals[PATTERN_MAX_THREADS];
+}PatternSearch;
+
+typedef struct patternWorker{
+    PatternSearch *search;
+    int id;
+}PatternWorker;
+
+/********* function prototypes *********/
+
+bool generatePattern(const bool *clues, uint8_t *puzzle, uint8_t *solution,
+                     unsigned long maxGrids, int threads, uint64_t seed,
+                     PatternStats *stats);
+static int searchGrids(void *arg);
+static void tryGrid(PatternSearch *search, const uint8_t *grid,
+                    uint64_t *random, PatternStats *stats);
+static bool fillGrid(const UnitView *view, uint64_t *random);
+static int findRectangles(const uint8_t *grid, CellSet *sets);
+static void randomVariant(uint8_t *map, uint64_t *random);
+static bool otherSolution(const uint8_t *puzzle, const uint8_t *variant,
+                          uint8_t *other);
+static void shuffle(uint8_t *items, int count, uint64_t *random);
+static void addCell(CellSet *set, int cell);
+static bool meets(const CellSet *a, const CellSet *b);
+static uint64_t nextRandom(uint64_t *state);
+
+/**
+ * Looks for a puzzle with a unique solution whose clues are exactly the
+ * cells set in `clues`, trying at most `maxGrids` random grids over
+ * `threads` threads. On success the puzzle (0 for an empty cell) is written
+ * to `puzzle`, its solution to `solution` and true is returned. `seed` picks
+ * the grids, though with more than one thread which of them wins the race
+ * (and so the puzzle returned) can change from run to run.
+ *
+ * This function will return false if an array is NULL, `threads` is out of
+ * range, the pattern has fewer than PATTERN_MIN_CLUES clues, no thread could
+ * be started or no puzzle was found in the grids tried. If `stats` is not
+ * NULL the search statistics are written to it.
+ */
+bool generatePattern(const bool *clues, uint8_t *puzzle, uint8_t *solution,
+                     unsigned long maxGrids, int threads, uint64_t seed,
+                     PatternStats *stats)
+{
+    PatternStats local;
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(PatternStats));
+    if(clues == NULL || puzzle == NULL || solution == NULL || threads < 1 ||
+       threads > PATTERN_MAX_THREADS){
+        return false;
+    }
+    int numClues = 0;
+    for(int i = 0; i < NUMCELLS; i++){
+        numClues += clues[i];
+    }
+    if(numClues < PATTERN_MIN_CLUES){
+        return false;
+    }
+
+    PatternSearch *search = calloc(1, sizeof(PatternSearch));
+    if(search == NULL){
+        return false;
+    }
+    search->clues = clues;
+    search->maxGrids = maxGrids;
+    search->seed = seed;
+    search->puzzle = puzzle;
+    search->solution = solution;
+    atomic_init(&search->nextGrid, 0);
+    atomic_init(&search->found, false);
+
+    PatternWorker workers[PATTERN_MAX_THREADS];
+    thrd_t ids[PATTERN_MAX_THREADS];
+    int started = 0;
+    if(threads == 1){
+        workers[0].search = search;
+        workers[0].id = 0;
+        searchGrids(&workers[0]);
+        started = 1;
+    }
+    else{
+        for(; started < threads; started++){
+            workers[started].search = search;
+            workers[started].id = started;
+            if(thrd_create(&ids[started], searchGrids, &workers[started]) !=
+               thrd_success){
+                break;
+            }
+        }
+        for(int t = 0; t < started; t++){
+            thrd_join(ids[t], NULL);
+        }
+    }
+
+    for(int t = 0; t < started; t++){
+        stats->grids += search->totals[t].grids;
+        stats->variants += search->totals[t].variants;
+        stats->pruned += search->totals[t].pruned;
+        stats->checks += search->totals[t].checks;
+    }
+    bool found = atomic_load(&search->found);
+    free(search);
+    return found;
+}
+
+/**
+ * Thread body: claims grids one at a time and tries each until a puzzle has
+ * been found or the grids run out.
+ */
+static int searchGrids(void *arg)
+{
+    PatternWorker *worker = arg;
+    PatternSearch *search = worker->search;
+    PatternStats *stats = &search->totals[worker->id];
+    unsigned long g;
+    while(!atomic_load(&search->found) &&
+          (g = atomic_fetch_add(&search->nextGrid, 1)) < search->maxGrids){
+        uint64_t random = g;
+        random = search->seed ^ nextRandom(&random);
+        uint8_t grid[NUMCELLS] = {0};
+        uint16_t used[3 * BOARDSIZE] = {0};
+        UnitView view = {grid, NULL, used};
+        fillGrid(&view, &random);
+        stats->grids++;
+        tryGrid(search, grid, &random, stats);
+    }
+    return 0;
+}
+
+/**
+ * Tries PATTERN_VARIANTS random variants of the grid under the pattern,
+ * stopping early if any thread finds a puzzle. The first unique one found is
+ * written out with its digits relabelled at random.
+ */
+static void tryGrid(PatternSearch *search, const uint8_t *grid,
+                    uint64_t *random, PatternStats *stats)
+{
+    CellSet *sets = malloc(PATTERN_MAX_SETS * sizeof(CellSet));
+    if(sets == NULL){
+        return;
+    }
+    int numSets = findRectangles(grid, sets);
+    for(int v = 0; v < PATTERN_VARIANTS && !atomic_load(&search->found);
+        v++){
+        uint8_t map[NUMCELLS];
+        randomVariant(map, random);
+        stats->variants++;
+        CellSet covered = {{0, 0}};
+        for(int i = 0; i < NUMCELLS; i++){
+            if(search->clues[i]){
+                addCell(&covered, map[i]);
+            }
+        }
+        int s = 0;
+        while(s < numSets && meets(&covered, &sets[s])){
+            s++;
+        }
+        if(s < numSets){
+            stats->pruned++;
+            continue;
+        }
+
+        uint8_t variant[NUMCELLS];
+        char text[NUMCELLS + 1];
+        for(int i = 0; i < NUMCELLS; i++){
+            variant[i] = grid[map[i]];
+            text[i] = search->clues[i] ? '0' + variant[i] : '0';
+        }
+        text[NUMCELLS] = '\0';
+        stats->checks++;
+        if(countSolutions(text, 2, NULL) == 1){
+            if(!atomic_exchange(&search->found, true)){
+                uint8_t digits[BOARDSIZE];
+                for(int d = 0; d < BOARDSIZE; d++){
+                    digits[d] = d + 1;
+                }
+                shuffle(digits, BOARDSIZE, random);
+                for(int i = 0; i < NUMCELLS; i++){
+                    search->solution[i] = digits[variant[i] - 1];
+                    search->puzzle[i] = search->clues[i] ?
+                                        search->solution[i] : 0;
+                }
+            }
+            break;
+        }
+
+        uint8_t puzzle[NUMCELLS];
+        uint8_t other[NUMCELLS];
+        for(int i = 0; i < NUMCELLS; i++){
+            puzzle[i] = text[i] - '0';
+        }
+        if(numSets < PATTERN_MAX_SETS &&
+           otherSolution(puzzle, variant, other)){
+            CellSet *set = &sets[numSets++];
+            set->bits[0] = set->bits[1] = 0;
+            for(int i = 0; i < NUMCELLS; i++){
+                if(other[i] != variant[i]){
+                    addCell(set, map[i]);
+                }
+            }
+        }
+    }
+    free(sets);
+}
+
+/**
+ * Fills the rest of a partly filled grid, given as a view over gridUnits,
+ * with random digits, branching on the empty cell with the fewest
+ * candidates (pickUnitCell) and trying its digits in a shuffled order.
+ * Returns false if the grid cannot be completed, leaving it as it was.
+ */
+static bool fillGrid(const UnitView *view, uint64_t *random)
+{
+    const UnitGraph *grid = gridUnits();
+    uint16_t bestCands;
+    int best = pickUnitCell(grid, view, 1, &bestCands);
+    if(best == -1){
+        return true;
+    }
+
+    uint8_t digits[BOARDSIZE];
+    int numDigits = 0;
+    for(int d = 0; d < BOARDSIZE; d++){
+        if(bestCands & (1 << d)){
+            digits[numDigits++] = d + 1;
+        }
+    }
+    shuffle(digits, numDigits, random);
+    for(int k = 0; k < numDigits; k++){
+        placeUnitDigit(grid, view, best, digits[k]);
+        if(fillGrid(view, random)){
+            return true;
+        }
+        removeUnitDigit(grid, view, best);
+    }
+    return false;
+}
+
+/**
+ * Writes the unavoidable rectangles of the grid to `sets` and returns how
+ * many there are: four cells at the corners of two rows and two columns
+ * holding two digits crosswise, with the rows in one band or the columns in
+ * one stack so the cells lie in just two squares and the digits can be
+ * swapped.
+ */
+static int findRectangles(const uint8_t *grid, CellSet *sets)
+{
+    int count = 0;
+    for(int r1 = 0; r1 < BOARDSIZE; r1++){
+        for(int r2 = r1 + 1; r2 < BOARDSIZE; r2++){
+            for(int c1 = 0; c1 < BOARDSIZE; c1++){
+                for(int c2 = c1 + 1; c2 < BOARDSIZE; c2++){
+                    int a = r1 * BOARDSIZE + c1;
+                    int b = r1 * BOARDSIZE + c2;
+                    int c = r2 * BOARDSIZE + c1;
+                    int d = r2 * BOARDSIZE + c2;
+                    if(grid[a] != grid[d] || grid[b] != grid[c] ||
+                       (r1 / 3 != r2 / 3 && c1 / 3 != c2 / 3) ||
+                       count == PATTERN_MAX_SETS){
+                        continue;
+                    }
+                    CellSet *set = &sets[count++];
+                    set->bits[0] = set->bits[1] = 0;
+                    addCell(set, a);
+                    addCell(set, b);
+                    addCell(set, c);
+                    addCell(set, d);
+                }
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * Draws a random variant of a grid: the bands, the stacks, the rows within
+ * each band and the columns within each stack are shuffled and the result
+ * is transposed half the time. Writes to map[i] the grid cell that ends up
+ * in cell i.
+ */
+static void randomVariant(uint8_t *map, uint64_t *random)
+{
+    uint8_t rows[BOARDSIZE];
+    uint8_t cols[BOARDSIZE];
+    uint8_t bands[3] = {0, 1, 2};
+    uint8_t stacks[3] = {0, 1, 2};
+    shuffle(bands, 3, random);
+    shuffle(stacks, 3, random);
+    for(int b = 0; b < 3; b++){
+        uint8_t inBand[3] = {0, 1, 2};
+        uint8_t inStack[3] = {0, 1, 2};
+        shuffle(inBand, 3, random);
+        shuffle(inStack, 3, random);
+        for(int k = 0; k < 3; k++){
+            rows[b * 3 + k] = bands[b] * 3 + inBand[k];
+            cols[b * 3 + k] = stacks[b] * 3 + inStack[k];
+        }
+    }
+    bool transpose = nextRandom(random) & 1;
+    for(int r = 0; r < BOARDSIZE; r++){
+        for(int c = 0; c < BOARDSIZE; c++){
+            map[r * BOARDSIZE + c] = transpose ?
+                                     cols[c] * BOARDSIZE + rows[r] :
+                                     rows[r] * BOARDSIZE + cols[c];
+        }
+    }
+}
+
+/**
+ * Finds a solution of the puzzle other than `variant`, which is known to be
+ * one of at least two, and writes it to `other`. The solver's first solution
+ * usually is the other one; if not, each empty cell in turn is barred from
+ * the digit it has in `variant` until the puzzle can still be solved.
+ * Returns false if no other solution was found.
+ */
+static bool otherSolution(const uint8_t *puzzle, const uint8_t *variant,
+                          uint8_t *other)
+{
+    if(!solveValues(puzzle, other, NULL)){
+        return false;
+    }
+    if(memcmp(other, variant, NUMCELLS) != 0){
+        return true;
+    }
+    uint16_t cands[NUMCELLS];
+    for(int i = 0; i < NUMCELLS; i++){
+        cands[i] = puzzle[i] != 0 ? 1 << (puzzle[i] - 1) : ALLDIGITS;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        if(puzzle[i] != 0){
+            continue;
+        }
+        cands[i] = ALLDIGITS & ~(1 << (variant[i] - 1));
+        if(solveCandidates(cands, other, NULL)){
+            return true;
+        }
+        cands[i] = ALLDIGITS;
+    }
+    return false;
+}
+
+/**
+ * Puts the `count` items in a random order (Fisher-Yates).
+ */
+static void shuffle(uint8_t *items, int count, uint64_t *random)
+{
+    for(int i = count - 1; i > 0; i--){
+        int j = nextRandom(random) % (i + 1);
+        uint8_t swap = items[i];
+        items[i] = items[j];
+        items[j] = swap;
+    }
+}
+
+/**
+ * Adds the given cell to the set.
+ */
+static void addCell(CellSet *set, int cell)
+{
+    set->bits[cell / 64] |= (uint64_t)1 << (cell % 64);
+}
+
+/**
+ * Returns true if the two sets have a cell in common.
+ */
+static bool meets(const CellSet *a, const CellSet *b)
+{
+    return (a->bits[0] & b->bits[0]) != 0 || (a->bits[1] & b->bits[1]) != 0;
+}
+
+/**
+ * Returns the next number from a splitmix64 generator.
+ */
+static uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,70 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements generating puzzles with a given clue pattern (a shape or a
+ * letter drawn in the clue cells), by finding a solution grid whose digits
+ * in the pattern's cells have no other completion.
+ *
+ * A random grid seldom works for a pattern as it is, but any grid stands for
+ * millions of others: permuting the bands, the stacks, the rows within each
+ * band and the columns within each stack, and transposing, all give valid
+ * grids, and each one puts different cells of the original under the
+ * pattern. So every random grid is tried under many random such variants,
+ * each a uniqueness check (countSolutions with a limit of 2) of the variant's
+ * digits in the pattern's cells.
+ *
+ * Most of those checks can be skipped. A set of cells of the grid that can
+ * be filled another way with the rest of the grid unchanged (an unavoidable
+ * set) has to hold a clue in every unique puzzle from that grid, so a
+ * variant whose pattern cells miss one of the grid's known unavoidable sets
+ * is thrown out with a few mask operations. Each grid starts with its
+ * unavoidable rectangles (two digits swapped between two rows and two
+ * columns covering just two squares), and every failed check adds the cells
+ * where the second solution differs from the grid as another one, so the
+ * filter gets sharper as a grid is worked through.
+ *
+ * The grids are shared out over threads that stop as soon as any of them
+ * finds a puzzle.
+ */
+#ifndef SUDOKU_PATTERN_H
+#define SUDOKU_PATTERN_H
+
+#include "./sudokuSolver.h"
+
+#define PATTERN_MAX_THREADS 64
+#define PATTERN_MIN_CLUES 17   //No unique puzzle has fewer clues
+#define PATTERN_VARIANTS 4096  //Variants of each grid tried
+#define PATTERN_MAX_SETS 1024  //Unavoidable sets kept per grid
+
+typedef struct patternStats{
+    unsigned long grids;    //Random grids generated
+    unsigned long variants; //Variants of them looked at
+    unsigned long pruned;   //Variants thrown out by an unavoidable set
+    unsigned long checks;   //Uniqueness checks run on the rest
+}PatternStats;
+
+/********* function prototypes *********/
+
+bool generatePattern(const bool *clues, uint8_t *puzzle, uint8_t *solution,
+                     unsigned long maxGrids, int threads, uint64_t seed,
+                     PatternStats *stats);
+
+/**
+ * Looks for a puzzle with a unique solution whose clues are exactly the
+ * cells set in `clues`, trying at most `maxGrids` random grids over
+ * `threads` threads. On success the puzzle (0 for an empty cell) is written
+ * to `puzzle`, its solution to `solution` and true is returned. `seed` picks
+ * the grids, though with more than one thread which of them wins the race
+ * (and so the puzzle returned) can change from run to run.
+ *
+ * This function will return false if an array is NULL, `threads` is out of
+ * range, the pattern has fewer than PATTERN_MIN_CLUES clues, no thread could
+ * be started or no puzzle was found in the grids tried. If `stats` is not
+ * NULL the search statistics are written to it.
+ */
+bool generatePattern(const bool *clues, uint8_t *puzzle, uint8_t *solution,
+                     unsigned long maxGrids, int threads, uint64_t seed,
+                     PatternStats *stats);
+
+#endif
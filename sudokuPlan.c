@@ -0,0 +1,341 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements the solver specialised to a clue pattern. See sudokuPlan.h for
+ * what a plan holds.
+ *
+ * Inside the solver an empty cell is known only by its index in the plan
+ * (its slot), and the state holds the value of each slot rather than of each
+ * cell, so the row, column and square of a cell are array lookups instead of
+ * divisions and nothing has to skip over the clues. The clues are only read
+ * when a puzzle is loaded, to fill the unit masks.
+ */
+#include "./sudokuPlan.h"
+
+#define ROWOF(i) ((i) / BOARDSIZE)
+#define COLOF(i) ((i) % BOARDSIZE)
+#define BOXOF(i) ((ROWOF(i) / 3) * 3 + COLOF(i) / 3)
+
+typedef struct planState{
+    uint8_t values[NUMCELLS];  //Value of each slot, 0 if still empty
+    uint16_t rows[BOARDSIZE];  //digits placed in each row
+    uint16_t cols[BOARDSIZE];  //digits placed in each column
+    uint16_t boxes[BOARDSIZE]; //digits placed in each square
+    uint8_t order[NUMCELLS];   //Slots left to the search, filled ones first
+    int numOpen;               //Number of slots in `order`
+}PlanState;
+
+//function prototypes
+bool buildPlan(const uint8_t *values, CluePlan *plan);
+bool planMatches(const CluePlan *plan, const uint8_t *values);
+bool solvePlanned(const CluePlan *plan, const uint8_t *values,
+                  uint8_t *solution, SolverStats *stats);
+static bool sharesUnit(int a, int b);
+static bool loadPlanned(PlanState *state, const CluePlan *plan,
+                        const uint8_t *values);
+static void placeDigit(PlanState *state, const CluePlan *plan, int slot,
+                       int digit);
+static void removeDigit(PlanState *state, const CluePlan *plan, int slot);
+static uint16_t candidates(const PlanState *state, const CluePlan *plan,
+                           int slot);
+static bool propagate(PlanState *state, const CluePlan *plan);
+static bool searchPlanned(PlanState *state, const CluePlan *plan, int depth,
+                          SolverStats *stats);
+
+/**
+ * Builds the plan for the clue mask of the given 81 cell values (every cell
+ * that is not 0 is a clue). Only which cells are clues matters, not their
+ * digits. Returns false if either argument is NULL.
+ */
+bool buildPlan(const uint8_t *values, CluePlan *plan)
+{
+    if(values == NULL || plan == NULL){
+        return false;
+    }
+    memset(plan, 0, sizeof(CluePlan));
+    //seen[i] counts the clues and planned cells sharing a unit with cell i
+    int seen[NUMCELLS] = {0};
+    bool taken[NUMCELLS];
+    for(int i = 0; i < NUMCELLS; i++){
+        plan->clue[i] = values[i] != 0;
+        taken[i] = plan->clue[i];
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        for(int j = 0; j < NUMCELLS; j++){
+            if(plan->clue[j] && sharesUnit(i, j)){
+                seen[i]++;
+            }
+        }
+    }
+
+    while(true){
+        int best = -1;
+        for(int i = 0; i < NUMCELLS; i++){
+            if(!taken[i] && (best == -1 || seen[i] > seen[best])){
+                best = i;
+            }
+        }
+        if(best == -1){
+            break;
+        }
+        taken[best] = true;
+        for(int j = 0; j < NUMCELLS; j++){
+            if(sharesUnit(best, j)){
+                seen[j]++;
+            }
+        }
+
+        int slot = plan->numEmpty++;
+        int units[3] = {ROWOF(best), BOARDSIZE + COLOF(best),
+                        2 * BOARDSIZE + BOXOF(best)};
+        plan->cells[slot] = best;
+        plan->rows[slot] = units[0];
+        plan->cols[slot] = COLOF(best);
+        plan->boxes[slot] = BOXOF(best);
+        for(int k = 0; k < 3; k++){
+            plan->units[units[k]][plan->unitSize[units[k]]++] = slot;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns true if the given 81 cell values have exactly the clue mask the
+ * plan was built for, so they can be solved with it.
+ */
+bool planMatches(const CluePlan *plan, const uint8_t *values)
+{
+    if(plan == NULL || values == NULL){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        if((values[i] != 0) != plan->clue[i]){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Solves the puzzle given as 81 cell values through the plan. On success the
+ * solution is written to `solution` and true is returned.
+ *
+ * This function will return false if an argument other than `stats` is NULL,
+ * the values do not have the plan's clue mask, the clues are not legal or the
+ * puzzle has no solution. If `stats` is not NULL the search statistics are
+ * written to it.
+ */
+bool solvePlanned(const CluePlan *plan, const uint8_t *values,
+                  uint8_t *solution, SolverStats *stats)
+{
+    PlanState state;
+    SolverStats local;
+    if(solution == NULL || !planMatches(plan, values) ||
+       !loadPlanned(&state, plan, values)){
+        return false;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    if(!propagate(&state, plan)){
+        return false;
+    }
+    state.numOpen = 0;
+    for(int slot = 0; slot < plan->numEmpty; slot++){
+        if(state.values[slot] == 0){
+            state.order[state.numOpen++] = slot;
+        }
+    }
+    if(!searchPlanned(&state, plan, 0, stats)){
+        return false;
+    }
+    memcpy(solution, values, NUMCELLS);
+    for(int slot = 0; slot < plan->numEmpty; slot++){
+        solution[plan->cells[slot]] = state.values[slot];
+    }
+    return true;
+}
+
+/**
+ * Returns true if the two different cells share a row, column or square.
+ */
+static bool sharesUnit(int a, int b)
+{
+    return a != b && (ROWOF(a) == ROWOF(b) || COLOF(a) == COLOF(b) ||
+                      BOXOF(a) == BOXOF(b));
+}
+
+/**
+ * Loads the clues into an empty state. Returns false if a clue is not a
+ * digit or repeats a digit of its row, column or square.
+ */
+static bool loadPlanned(PlanState *state, const CluePlan *plan,
+                        const uint8_t *values)
+{
+    memset(state, 0, sizeof(PlanState));
+    for(int i = 0; i < NUMCELLS; i++){
+        if(!plan->clue[i]){
+            continue;
+        }
+        if(values[i] > 9){
+            return false;
+        }
+        uint16_t bit = 1 << (values[i] - 1);
+        uint16_t *masks[3] = {&state->rows[ROWOF(i)], &state->cols[COLOF(i)],
+                              &state->boxes[BOXOF(i)]};
+        for(int k = 0; k < 3; k++){
+            if(*masks[k] & bit){
+                return false;
+            }
+            *masks[k] |= bit;
+        }
+    }
+    return true;
+}
+
+/**
+ * Places `digit` in the given empty slot and marks it as used in the slot's
+ * row, column, and square. The digit must be a candidate of the slot.
+ */
+static void placeDigit(PlanState *state, const CluePlan *plan, int slot,
+                       int digit)
+{
+    uint16_t bit = 1 << (digit - 1);
+    state->values[slot] = digit;
+    state->rows[plan->rows[slot]] |= bit;
+    state->cols[plan->cols[slot]] |= bit;
+    state->boxes[plan->boxes[slot]] |= bit;
+}
+
+/**
+ * Empties the given slot and clears its digit from the slot's row, column,
+ * and square masks.
+ */
+static void removeDigit(PlanState *state, const CluePlan *plan, int slot)
+{
+    uint16_t bit = 1 << (state->values[slot] - 1);
+    state->rows[plan->rows[slot]] &= ~bit;
+    state->cols[plan->cols[slot]] &= ~bit;
+    state->boxes[plan->boxes[slot]] &= ~bit;
+    state->values[slot] = 0;
+}
+
+/**
+ * Returns the digits missing from the row, column and square of the given
+ * empty slot.
+ */
+static uint16_t candidates(const PlanState *state, const CluePlan *plan,
+                           int slot)
+{
+    return ~(state->rows[plan->rows[slot]] | state->cols[plan->cols[slot]] |
+             state->boxes[plan->boxes[slot]]) & ALLDIGITS;
+}
+
+/**
+ * Fills every naked and hidden single until there are none left, going over
+ * only the empty cells of the plan. Returns false as soon as the state shows
+ * it has no solution, with the same checks as the pass in sudokuSolver.
+ */
+static bool propagate(PlanState *state, const CluePlan *plan)
+{
+    uint16_t *used[3] = {state->rows, state->cols, state->boxes};
+    bool progress = true;
+    while(progress){
+        progress = false;
+        for(int slot = 0; slot < plan->numEmpty; slot++){
+            if(state->values[slot] != 0){
+                continue;
+            }
+            uint16_t cands = candidates(state, plan, slot);
+            if(cands == 0){
+                return false;
+            }
+            if((cands & (cands - 1)) == 0){
+                placeDigit(state, plan, slot, __builtin_ctz(cands) + 1);
+                progress = true;
+            }
+        }
+
+        for(int unit = 0; unit < PLAN_UNITS; unit++){
+            const uint8_t *slots = plan->units[unit];
+            uint16_t once = 0;  //Digits with at least one place
+            uint16_t twice = 0; //Digits with at least two places
+            for(int k = 0; k < plan->unitSize[unit]; k++){
+                if(state->values[slots[k]] == 0){
+                    uint16_t cands = candidates(state, plan, slots[k]);
+                    twice |= once & cands;
+                    once |= cands;
+                }
+            }
+            if((once | used[unit / BOARDSIZE][unit % BOARDSIZE]) != ALLDIGITS){
+                return false;
+            }
+            uint16_t singles = once & ~twice;
+            for(int k = 0; k < plan->unitSize[unit] && singles != 0; k++){
+                if(state->values[slots[k]] != 0){
+                    continue;
+                }
+                uint16_t bit = candidates(state, plan, slots[k]) & singles;
+                if((bit & (bit - 1)) != 0){
+                    return false;
+                }
+                if(bit != 0){
+                    placeDigit(state, plan, slots[k], __builtin_ctz(bit) + 1);
+                    singles &= ~bit;
+                    progress = true;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Searches for a solution with the slots order[0] to order[depth - 1]
+ * already filled. The open slot with the fewest candidates is swapped to
+ * order[depth] and each of its candidates is tried in turn. Returns true
+ * (leaving the state holding the solution) as soon as one is found.
+ */
+static bool searchPlanned(PlanState *state, const CluePlan *plan, int depth,
+                          SolverStats *stats)
+{
+    if(depth == state->numOpen){
+        return true;
+    }
+    int best = depth;
+    uint16_t bestCands = 0;
+    int bestCount = BOARDSIZE + 1;
+    for(int k = depth; k < state->numOpen; k++){
+        uint16_t cands = candidates(state, plan, state->order[k]);
+        int count = __builtin_popcount(cands);
+        if(count < bestCount){
+            best = k;
+            bestCount = count;
+            bestCands = cands;
+            if(count <= 1){ //Can't do any better than a forced cell
+                break;
+            }
+        }
+    }
+    if(bestCount == 0){
+        return false;
+    }
+    uint8_t slot = state->order[best];
+    state->order[best] = state->order[depth];
+    state->order[depth] = slot;
+    stats->nodes++;
+
+    while(bestCands != 0){
+        int digit = __builtin_ctz(bestCands) + 1;
+        bestCands &= bestCands - 1;
+        stats->guesses++;
+        placeDigit(state, plan, slot, digit);
+        if(searchPlanned(state, plan, depth + 1, stats)){
+            return true;
+        }
+        removeDigit(state, plan, slot);
+    }
+    return false;
+}
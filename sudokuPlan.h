@@ -0,0 +1,78 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a solver specialised to one clue pattern, for batches where
+ * many puzzles share the same 81-bit mask of clue cells (as the generator
+ * produces them). Everything about the search that depends only on which
+ * cells are clues is worked out once into a CluePlan and reused for every
+ * puzzle with that mask:
+ *
+ *  - the empty cells, in a static order that starts with the cell seeing the
+ *    most clues and keeps taking the cell that sees the most clues and cells
+ *    already taken, so the cells that are usually most constrained come
+ *    first,
+ *  - the row, column and square of each of those cells, and
+ *  - for each row, column and square, which of the empty cells are in it.
+ *
+ * Solving a puzzle through the plan never looks at a clue cell again. The
+ * singles pass walks only the empty cells of each unit, and the search keeps
+ * the cells not yet filled at the tail of its own copy of the order, picking
+ * the one with the fewest candidates from that tail and swapping it to the
+ * front, so each node costs a scan of the cells still open and nothing else.
+ * Ties go to the cell nearest the front of the tail, which starts out in
+ * plan order but is not kept in it: each swap moves the cell that was at the
+ * front to where the picked one was.
+ */
+#ifndef SUDOKU_PLAN_H
+#define SUDOKU_PLAN_H
+
+#include "./sudokuSolver.h"
+
+#define PLAN_UNITS (3 * BOARDSIZE) //Rows, then columns, then squares
+
+typedef struct cluePlan{
+    bool clue[NUMCELLS];    //The mask the plan was built for
+    int numEmpty;
+    uint8_t cells[NUMCELLS]; //The empty cells in plan order
+    uint8_t rows[NUMCELLS];  //Row, column and square of each of them
+    uint8_t cols[NUMCELLS];
+    uint8_t boxes[NUMCELLS];
+    uint8_t unitSize[PLAN_UNITS];
+    uint8_t units[PLAN_UNITS][BOARDSIZE]; //Plan indexes of the empty cells
+                                          //of each unit
+}CluePlan;
+
+/********* function prototypes *********/
+
+bool buildPlan(const uint8_t *values, CluePlan *plan);
+bool planMatches(const CluePlan *plan, const uint8_t *values);
+bool solvePlanned(const CluePlan *plan, const uint8_t *values,
+                  uint8_t *solution, SolverStats *stats);
+
+/**
+ * Builds the plan for the clue mask of the given 81 cell values (every cell
+ * that is not 0 is a clue). Only which cells are clues matters, not their
+ * digits. Returns false if either argument is NULL.
+ */
+bool buildPlan(const uint8_t *values, CluePlan *plan);
+
+/**
+ * Returns true if the given 81 cell values have exactly the clue mask the
+ * plan was built for, so they can be solved with it.
+ */
+bool planMatches(const CluePlan *plan, const uint8_t *values);
+
+/**
+ * Solves the puzzle given as 81 cell values through the plan. On success the
+ * solution is written to `solution` and true is returned.
+ *
+ * This function will return false if an argument other than `stats` is NULL,
+ * the values do not have the plan's clue mask, the clues are not legal or the
+ * puzzle has no solution. If `stats` is not NULL the search statistics are
+ * written to it.
+ */
+bool solvePlanned(const CluePlan *plan, const uint8_t *values,
+                  uint8_t *solution, SolverStats *stats);
+
+#endif
@@ -0,0 +1,1125 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Rates puzzles on the Sudoku Explainer scale with a ladder of techniques
+ * that all work on candidate bitmasks. Units are numbered 0 - 8 for the rows,
+ * 9 - 17 for the columns and 18 - 26 for the squares, and within a unit the
+ * positions of a digit are kept as a 9 bit mask of unit indexes so that
+ * subsets and fish are found by OR-ing masks and counting bits.
+ *
+ * Every step tries the techniques from the easiest up and applies the first
+ * one that makes progress, exactly once, before starting over from the
+ * easiest again. This is what SE does, and it matters: applying a harder
+ * technique while an easier one was available could raise the rating.
+ *
+ * A direct technique works on a copy of the state: its eliminations are
+ * made there, and only if they leave a hidden single is that single placed
+ * in the real state, the eliminations themselves being dropped as SE drops
+ * them.
+ */
+#include <threads.h>
+#include "./sudokuRater.h"
+
+#define ROWOF(i) ((i) / BOARDSIZE)
+#define COLOF(i) ((i) % BOARDSIZE)
+#define BOXOF(i) ((ROWOF(i) / 3) * 3 + COLOF(i) / 3)
+#define NUMUNITS 27
+#define BOXUNIT 18 //Index of the first square in the unit numbering
+
+typedef struct gradeState{
+    uint8_t values[NUMCELLS];  //0 if the cell is empty
+    uint16_t cands[NUMCELLS];  //Candidates of each empty cell, 0 once filled
+    int empty;                 //Number of empty cells
+}GradeState;
+
+typedef struct rung{
+    const char *name;
+    int score;                        //SE rating times ten
+    bool (*apply)(GradeState *state); //Takes one step, false if it can't
+}Rung;
+
+static int unitCells[NUMUNITS][BOARDSIZE]; //The cells of each unit
+static once_flag unitsOnce = ONCE_FLAG_INIT;
+
+/********* function prototypes *********/
+
+bool rateString(const char *clues, Rating *rating);
+bool rateValues(const uint8_t *values, Rating *rating);
+const char *techniqueName(Technique tech);
+int techniqueScore(Technique tech);
+SinglesResult classifySingles(const uint8_t *values, Rating *rating);
+static void initUnits(void);
+static bool loadGrade(GradeState *state, const uint8_t *values);
+static void placeValue(GradeState *state, int cell, int digit);
+static bool eliminate(GradeState *state, int cell, uint16_t mask);
+static bool consistent(const GradeState *state);
+static bool sees(int a, int b);
+static Technique singlesRung(GradeState *state);
+static bool singlesSweep(GradeState *state, Technique upTo);
+static bool uniqueValues(const uint8_t *values);
+static uint16_t digitPlaces(const GradeState *state, int unit, uint16_t bit);
+static bool fullHouse(GradeState *state);
+static bool hiddenSingle(GradeState *state, int first, int last);
+static bool hiddenSingleBox(GradeState *state);
+static bool hiddenSingleLine(GradeState *state);
+static bool nakedSingle(GradeState *state);
+static bool commitStep(GradeState *state, const GradeState *trial,
+                       uint16_t digits, int only, bool direct);
+static bool pointingStep(GradeState *state, bool direct);
+static bool claimingStep(GradeState *state, bool direct);
+static bool directPointing(GradeState *state);
+static bool directClaiming(GradeState *state);
+static bool directHiddenPair(GradeState *state);
+static bool directHiddenTriple(GradeState *state);
+static bool pointing(GradeState *state);
+static bool claiming(GradeState *state);
+static bool nakedSubset(GradeState *state, int size);
+static bool hiddenSubset(GradeState *state, int size, bool direct);
+static bool fish(GradeState *state, int size);
+static bool nakedPair(GradeState *state);
+static bool xWing(GradeState *state);
+static bool hiddenPair(GradeState *state);
+static bool nakedTriple(GradeState *state);
+static bool swordfish(GradeState *state);
+static bool hiddenTriple(GradeState *state);
+static bool xyWing(GradeState *state);
+static bool xyzWing(GradeState *state);
+static bool uniqueRectangle(GradeState *state, int type);
+static bool roofsConjugate(const GradeState *state, int a, int b,
+                           uint16_t bit);
+static bool uniqueRectangle1(GradeState *state);
+static bool uniqueRectangle2(GradeState *state);
+static bool uniqueRectangle4(GradeState *state);
+static bool nakedQuad(GradeState *state);
+static bool jellyfish(GradeState *state);
+static bool hiddenQuad(GradeState *state);
+static bool bugPlusOne(GradeState *state);
+
+//Indexed by Technique
+static const Rung ladder[NUMTECHNIQUES] = {
+    {"none", 0, NULL},
+    {"full house", 10, fullHouse},
+    {"hidden single (square)", 12, hiddenSingleBox},
+    {"hidden single (line)", 15, hiddenSingleLine},
+    {"direct pointing", 17, directPointing},
+    {"direct claiming", 19, directClaiming},
+    {"direct hidden pair", 20, directHiddenPair},
+    {"naked single", 23, nakedSingle},
+    {"direct hidden triple", 25, directHiddenTriple},
+    {"pointing", 26, pointing},
+    {"claiming", 28, claiming},
+    {"naked pair", 30, nakedPair},
+    {"x-wing", 32, xWing},
+    {"hidden pair", 34, hiddenPair},
+    {"naked triple", 36, nakedTriple},
+    {"swordfish", 38, swordfish},
+    {"hidden triple", 40, hiddenTriple},
+    {"xy-wing", 42, xyWing},
+    {"xyz-wing", 44, xyzWing},
+    {"unique rectangle type 1", 45, uniqueRectangle1},
+    {"unique rectangle type 2", 46, uniqueRectangle2},
+    {"unique rectangle type 4", 46, uniqueRectangle4},
+    {"naked quad", 50, nakedQuad},
+    {"jellyfish", 52, jellyfish},
+    {"hidden quad", 54, hiddenQuad},
+    {"bug+1", 56, bugPlusOne}
+};
+
+/**
+ * Rates the puzzle given by the string `clues` (same format as solveString)
+ * and writes the result to `rating`.
+ *
+ * This function will return false if either argument is NULL, the clues are
+ * malformed or not legal, or if the steps taken show that the puzzle has no
+ * solution. Ratings assume the puzzle has a unique solution, as SE does.
+ */
+bool rateString(const char *clues, Rating *rating)
+{
+    uint8_t values[NUMCELLS];
+    if(clues == NULL){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        char c = clues[i];
+        if(c == '.'){
+            values[i] = 0;
+        }
+        else if(c >= '0' && c <= '9'){ //Also catches a string that ends early
+            values[i] = c - '0';
+        }
+        else{
+            return false;
+        }
+    }
+    return clues[NUMCELLS] == '\0' && rateValues(values, rating);
+}
+
+/**
+ * Rates the puzzle given as 81 cell values (0 for an empty cell) the same way
+ * as rateString.
+ */
+bool rateValues(const uint8_t *values, Rating *rating)
+{
+    GradeState state;
+    if(rating == NULL || !loadGrade(&state, values)){
+        return false;
+    }
+    memset(rating, 0, sizeof(Rating));
+
+    while(state.empty > 0){
+        if(!consistent(&state)){
+            return false;
+        }
+        Technique tech = TECH_FULL_HOUSE;
+        while(tech < NUMTECHNIQUES && !ladder[tech].apply(&state)){
+            tech++;
+        }
+        if(tech == NUMTECHNIQUES){
+            return true; //Stuck, solved stays false
+        }
+        rating->steps++;
+        if(ladder[tech].score > rating->score){
+            rating->score = ladder[tech].score;
+            rating->hardest = tech;
+        }
+    }
+    rating->solved = true;
+    return true;
+}
+
+/**
+ * Returns the name of the given technique, or "unknown" if it is out of
+ * range.
+ */
+const char *techniqueName(Technique tech)
+{
+    if(tech < TECH_NONE || tech >= NUMTECHNIQUES){
+        return "unknown";
+    }
+    return ladder[tech].name;
+}
+
+/**
+ * Returns the SE rating (times ten) of the given technique, or -1 if it is
+ * out of range.
+ */
+int techniqueScore(Technique tech)
+{
+    if(tech < TECH_NONE || tech >= NUMTECHNIQUES){
+        return -1;
+    }
+    return ladder[tech].score;
+}
+
+/**
+ * Checks whether the puzzle given as 81 cell values can be solved with full
+ * houses and hidden singles alone. If so its rating, which is the same one
+ * rateValues would give, is written to `rating` and SINGLES_SOLVED is
+ * returned. A puzzle solved this way always has exactly one solution.
+ *
+ * Returns SINGLES_STUCK if those are not enough but the puzzle has exactly
+ * one solution, in which case it still needs rateValues (and `rating` holds
+ * nothing useful), or SINGLES_INVALID if either argument is NULL, the values
+ * are not legal or the puzzle has no solution or more than one.
+ */
+SinglesResult classifySingles(const uint8_t *values, Rating *rating)
+{
+    GradeState state;
+    if(rating == NULL || !loadGrade(&state, values)){
+        return SINGLES_INVALID;
+    }
+    memset(rating, 0, sizeof(Rating));
+
+    int empty = state.empty;
+    Technique hardest = singlesRung(&state);
+    if(state.empty > 0){
+        //Only ladder grading is left, which assumes a unique solution
+        return uniqueValues(state.values) ? SINGLES_STUCK : SINGLES_INVALID;
+    }
+    if(hardest == TECH_NAKED_SINGLE){
+        return SINGLES_STUCK; //A direct technique may rate it lower
+    }
+    rating->solved = true;
+    rating->steps = empty;
+    rating->hardest = hardest;
+    rating->score = ladder[hardest].score;
+    return SINGLES_SOLVED;
+}
+
+/**
+ * Fills the table of the cells in each unit.
+ */
+static void initUnits(void)
+{
+    for(int i = 0; i < NUMCELLS; i++){
+        int box = BOXOF(i);
+        unitCells[ROWOF(i)][COLOF(i)] = i;
+        unitCells[BOARDSIZE + COLOF(i)][ROWOF(i)] = i;
+        unitCells[BOXUNIT + box][(ROWOF(i) % 3) * 3 + COLOF(i) % 3] = i;
+    }
+}
+
+/**
+ * Loads 81 cell values into a state where every empty cell starts with all
+ * the digits not used by its row, column and square. Returns false if
+ * `values` is NULL, holds anything above 9 or if any of the values conflict
+ * with each other.
+ */
+static bool loadGrade(GradeState *state, const uint8_t *values)
+{
+    if(values == NULL){
+        return false;
+    }
+    call_once(&unitsOnce, initUnits);
+    memset(state->values, 0, sizeof(state->values));
+    for(int i = 0; i < NUMCELLS; i++){
+        state->cands[i] = ALLDIGITS;
+    }
+    state->empty = NUMCELLS;
+    for(int i = 0; i < NUMCELLS; i++){
+        if(values[i] == 0){
+            continue;
+        }
+        if(values[i] > 9 || !(state->cands[i] & (1 << (values[i] - 1)))){
+            return false;
+        }
+        placeValue(state, i, values[i]);
+    }
+    return true;
+}
+
+/**
+ * Fills the given cell with `digit` and removes the digit from the
+ * candidates of every cell in the cell's row, column, and square.
+ */
+static void placeValue(GradeState *state, int cell, int digit)
+{
+    uint16_t bit = 1 << (digit - 1);
+    int units[3] = {ROWOF(cell), BOARDSIZE + COLOF(cell),
+                    BOXUNIT + BOXOF(cell)};
+    state->values[cell] = digit;
+    state->cands[cell] = 0;
+    state->empty--;
+    for(int u = 0; u < 3; u++){
+        for(int k = 0; k < BOARDSIZE; k++){
+            state->cands[unitCells[units[u]][k]] &= ~bit;
+        }
+    }
+}
+
+/**
+ * Removes the candidates in `mask` from the given cell. Returns true if any
+ * of them were still candidates.
+ */
+static bool eliminate(GradeState *state, int cell, uint16_t mask)
+{
+    if(!(state->cands[cell] & mask)){
+        return false;
+    }
+    state->cands[cell] &= ~mask;
+    return true;
+}
+
+/**
+ * Returns false if the state can no longer lead to a solution: an empty cell
+ * has no candidates left or a unit has nowhere left for one of its digits.
+ */
+static bool consistent(const GradeState *state)
+{
+    for(int unit = 0; unit < NUMUNITS; unit++){
+        uint16_t seen = 0;
+        for(int k = 0; k < BOARDSIZE; k++){
+            int cell = unitCells[unit][k];
+            if(state->values[cell] == 0 && state->cands[cell] == 0){
+                return false;
+            }
+            seen |= state->values[cell] != 0 ?
+                    1 << (state->values[cell] - 1) : state->cands[cell];
+        }
+        if(seen != ALLDIGITS){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns true if the two cells are different and share a unit.
+ */
+static bool sees(int a, int b)
+{
+    return a != b && (ROWOF(a) == ROWOF(b) || COLOF(a) == COLOF(b) ||
+                      BOXOF(a) == BOXOF(b));
+}
+
+/**
+ * Fills singles until none are left, allowing only the singles of the
+ * easiest rung that still makes progress, and returns the hardest rung that
+ * was needed (TECH_NONE if the board is already full). Singles never stop
+ * being available once they appear, so a later rung is only reached when
+ * the earlier ones are not enough on their own, and up to hidden singles in
+ * lines the result is the rung rateValues would end on. Naked singles come
+ * after the direct rungs, which the pass does not try.
+ */
+static Technique singlesRung(GradeState *state)
+{
+    Technique hardest = TECH_NONE;
+    Technique upTo = TECH_FULL_HOUSE;
+    while(state->empty > 0 && upTo <= TECH_NAKED_SINGLE){
+        if(singlesSweep(state, upTo)){
+            hardest = upTo;
+        }
+        else{
+            upTo = upTo == TECH_HIDDEN_SINGLE_LINE ? TECH_NAKED_SINGLE :
+                                                     upTo + 1;
+        }
+    }
+    return hardest;
+}
+
+/**
+ * Fills every single allowed by the rungs up to `upTo` (one of the four
+ * singles rungs) in one sweep of the units and cells, and returns true if
+ * any were filled. Each unit is checked for all of its hidden singles at
+ * once: `once` collects the digits seen in at least one cell and `twice`
+ * those seen in at least two.
+ */
+static bool singlesSweep(GradeState *state, Technique upTo)
+{
+    bool progress = false;
+    for(int unit = 0; unit < NUMUNITS; unit++){
+        const int *cells = unitCells[unit];
+        uint16_t once = 0;
+        uint16_t twice = 0;
+        int empty = 0;
+        for(int k = 0; k < BOARDSIZE; k++){
+            uint16_t cands = state->cands[cells[k]];
+            twice |= once & cands;
+            once |= cands;
+            empty += state->values[cells[k]] == 0;
+        }
+        Technique needed = unit >= BOXUNIT ? TECH_HIDDEN_SINGLE_BOX :
+                                             TECH_HIDDEN_SINGLE_LINE;
+        uint16_t singles = once & ~twice;
+        if(upTo < needed && empty != 1){
+            singles = 0; //Only a full house is allowed
+        }
+        for(int k = 0; k < BOARDSIZE && singles != 0; k++){
+            uint16_t bit = state->cands[cells[k]] & singles;
+            if(bit != 0 && (bit & (bit - 1)) == 0){
+                singles &= ~bit;
+                placeValue(state, cells[k], __builtin_ctz(bit) + 1);
+                progress = true;
+            }
+        }
+    }
+    if(upTo < TECH_NAKED_SINGLE){
+        return progress;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        uint16_t cands = state->cands[i];
+        if(cands != 0 && (cands & (cands - 1)) == 0){
+            placeValue(state, i, __builtin_ctz(cands) + 1);
+            progress = true;
+        }
+    }
+    return progress;
+}
+
+/**
+ * Returns true if the board given as 81 legal cell values has exactly one
+ * solution, searching straight from the values with the solver's
+ * searchUnits.
+ */
+static bool uniqueValues(const uint8_t *values)
+{
+    uint8_t grid[NUMCELLS] = {0};
+    uint16_t used[NUMUNITS] = {0};
+    UnitView view = {grid, NULL, used};
+    for(int i = 0; i < NUMCELLS; i++){
+        if(values[i] != 0){
+            placeUnitDigit(gridUnits(), &view, i, values[i]);
+        }
+    }
+    SolverStats stats;
+    return searchUnits(gridUnits(), &view, NULL, NULL, 2, &stats) == 1;
+}
+
+/**
+ * Returns the mask of the unit indexes in `unit` whose cell has `bit` as a
+ * candidate.
+ */
+static uint16_t digitPlaces(const GradeState *state, int unit, uint16_t bit)
+{
+    uint16_t places = 0;
+    for(int k = 0; k < BOARDSIZE; k++){
+        if(state->cands[unitCells[unit][k]] & bit){
+            places |= 1 << k;
+        }
+    }
+    return places;
+}
+
+/**
+ * Fills the last empty cell of a unit.
+ */
+static bool fullHouse(GradeState *state)
+{
+    for(int unit = 0; unit < NUMUNITS; unit++){
+        int last = -1;
+        int empty = 0;
+        for(int k = 0; k < BOARDSIZE; k++){
+            if(state->values[unitCells[unit][k]] == 0){
+                last = unitCells[unit][k];
+                empty++;
+            }
+        }
+        if(empty == 1 && __builtin_popcount(state->cands[last]) == 1){
+            placeValue(state, last, __builtin_ctz(state->cands[last]) + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Places a digit that has only one place left in one of the units from
+ * `first` to `last`.
+ */
+static bool hiddenSingle(GradeState *state, int first, int last)
+{
+    for(int unit = first; unit <= last; unit++){
+        for(int digit = 1; digit <= BOARDSIZE; digit++){
+            uint16_t places = digitPlaces(state, unit, 1 << (digit - 1));
+            if(__builtin_popcount(places) == 1){
+                placeValue(state, unitCells[unit][__builtin_ctz(places)],
+                           digit);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Places a digit that has only one place left in a square.
+ */
+static bool hiddenSingleBox(GradeState *state)
+{
+    return hiddenSingle(state, BOXUNIT, NUMUNITS - 1);
+}
+
+/**
+ * Places a digit that has only one place left in a row or column.
+ */
+static bool hiddenSingleLine(GradeState *state)
+{
+    return hiddenSingle(state, 0, BOXUNIT - 1);
+}
+
+/**
+ * Fills a cell that has only one candidate left.
+ */
+static bool nakedSingle(GradeState *state)
+{
+    for(int i = 0; i < NUMCELLS; i++){
+        if(__builtin_popcount(state->cands[i]) == 1){
+            placeValue(state, i, __builtin_ctz(state->cands[i]) + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Keeps the eliminations made in `trial`, a copy of `state` the step has
+ * changed. For a direct step they only count if they leave one of `digits`
+ * with a single place in some unit (in unit `only` unless it is -1), and
+ * then that single is placed in `state` instead. Returns true if `state`
+ * changed.
+ */
+static bool commitStep(GradeState *state, const GradeState *trial,
+                       uint16_t digits, int only, bool direct)
+{
+    if(!direct){
+        *state = *trial;
+        return true;
+    }
+    for(int unit = 0; unit < NUMUNITS; unit++){
+        if(only >= 0 && unit != only){
+            continue;
+        }
+        for(int digit = 1; digit <= BOARDSIZE; digit++){
+            uint16_t bit = 1 << (digit - 1);
+            if(!(digits & bit)){
+                continue;
+            }
+            uint16_t places = digitPlaces(trial, unit, bit);
+            if(__builtin_popcount(places) == 1){
+                placeValue(state, unitCells[unit][__builtin_ctz(places)],
+                           digit);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds a digit whose places in a square all lie on one row or column and
+ * removes it from the rest of that line.
+ */
+static bool pointingStep(GradeState *state, bool direct)
+{
+    for(int box = 0; box < BOARDSIZE; box++){
+        const int *cells = unitCells[BOXUNIT + box];
+        for(int digit = 1; digit <= BOARDSIZE; digit++){
+            uint16_t bit = 1 << (digit - 1);
+            uint16_t places = digitPlaces(state, BOXUNIT + box, bit);
+            if(places == 0){
+                continue;
+            }
+            int first = cells[__builtin_ctz(places)];
+            bool sameRow = true;
+            bool sameCol = true;
+            for(int k = 0; k < BOARDSIZE; k++){
+                if(places & (1 << k)){
+                    sameRow &= ROWOF(cells[k]) == ROWOF(first);
+                    sameCol &= COLOF(cells[k]) == COLOF(first);
+                }
+            }
+            if(!sameRow && !sameCol){
+                continue;
+            }
+            int line = sameRow ? ROWOF(first) : BOARDSIZE + COLOF(first);
+            GradeState trial = *state;
+            bool changed = false;
+            for(int k = 0; k < BOARDSIZE; k++){
+                int cell = unitCells[line][k];
+                if(BOXOF(cell) != box){
+                    changed |= eliminate(&trial, cell, bit);
+                }
+            }
+            if(changed && commitStep(state, &trial, bit, -1, direct)){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds a digit whose places in a row or column all lie in one square and
+ * removes it from the rest of that square.
+ */
+static bool claimingStep(GradeState *state, bool direct)
+{
+    for(int line = 0; line < BOXUNIT; line++){
+        const int *cells = unitCells[line];
+        for(int digit = 1; digit <= BOARDSIZE; digit++){
+            uint16_t bit = 1 << (digit - 1);
+            uint16_t places = digitPlaces(state, line, bit);
+            if(places == 0){
+                continue;
+            }
+            int box = BOXOF(cells[__builtin_ctz(places)]);
+            bool sameBox = true;
+            for(int k = 0; k < BOARDSIZE; k++){
+                if(places & (1 << k)){
+                    sameBox &= BOXOF(cells[k]) == box;
+                }
+            }
+            if(!sameBox){
+                continue;
+            }
+            GradeState trial = *state;
+            bool changed = false;
+            for(int k = 0; k < BOARDSIZE; k++){
+                int cell = unitCells[BOXUNIT + box][k];
+                bool onLine = line < BOARDSIZE ? ROWOF(cell) == line :
+                              COLOF(cell) == line - BOARDSIZE;
+                if(!onLine){
+                    changed |= eliminate(&trial, cell, bit);
+                }
+            }
+            if(changed && commitStep(state, &trial, bit, -1, direct)){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * The ladder's rungs for intersections and hidden sets, direct or not.
+ */
+static bool directPointing(GradeState *state)
+{
+    return pointingStep(state, true);
+}
+
+static bool directClaiming(GradeState *state)
+{
+    return claimingStep(state, true);
+}
+
+static bool directHiddenPair(GradeState *state)
+{
+    return hiddenSubset(state, 2, true);
+}
+
+static bool directHiddenTriple(GradeState *state)
+{
+    return hiddenSubset(state, 3, true);
+}
+
+static bool pointing(GradeState *state)
+{
+    return pointingStep(state, false);
+}
+
+static bool claiming(GradeState *state)
+{
+    return claimingStep(state, false);
+}
+
+/**
+ * Finds `size` empty cells of a unit that only have `size` candidates between
+ * them and removes those candidates from the rest of the unit.
+ */
+static bool nakedSubset(GradeState *state, int size)
+{
+    for(int unit = 0; unit < NUMUNITS; unit++){
+        const int *cells = unitCells[unit];
+        for(int subset = 0; subset <= ALLDIGITS; subset++){
+            if(__builtin_popcount(subset) != size){
+                continue;
+            }
+            uint16_t digits = 0;
+            bool allEmpty = true;
+            for(int k = 0; k < BOARDSIZE; k++){
+                if(subset & (1 << k)){
+                    digits |= state->cands[cells[k]];
+                    allEmpty &= state->values[cells[k]] == 0;
+                }
+            }
+            if(!allEmpty || __builtin_popcount(digits) != size){
+                continue;
+            }
+            bool changed = false;
+            for(int k = 0; k < BOARDSIZE; k++){
+                if(!(subset & (1 << k))){
+                    changed |= eliminate(state, cells[k], digits);
+                }
+            }
+            if(changed){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds `size` digits of a unit that only have `size` places between them
+ * and removes every other candidate from those places.
+ */
+static bool hiddenSubset(GradeState *state, int size, bool direct)
+{
+    for(int unit = 0; unit < NUMUNITS; unit++){
+        uint16_t places[BOARDSIZE];
+        for(int d = 0; d < BOARDSIZE; d++){
+            places[d] = digitPlaces(state, unit, 1 << d);
+        }
+        for(int subset = 0; subset <= ALLDIGITS; subset++){
+            if(__builtin_popcount(subset) != size){
+                continue;
+            }
+            uint16_t cover = 0;
+            bool allOpen = true;
+            for(int d = 0; d < BOARDSIZE; d++){
+                if(subset & (1 << d)){
+                    cover |= places[d];
+                    allOpen &= places[d] != 0;
+                }
+            }
+            if(!allOpen || __builtin_popcount(cover) != size){
+                continue;
+            }
+            GradeState trial = *state;
+            bool changed = false;
+            for(int k = 0; k < BOARDSIZE; k++){
+                if(cover & (1 << k)){
+                    changed |= eliminate(&trial, unitCells[unit][k],
+                                         ~subset & ALLDIGITS);
+                }
+            }
+            if(changed && commitStep(state, &trial, ~subset & ALLDIGITS,
+                                     unit, direct)){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds `size` rows (or columns) whose places for a digit all lie in `size`
+ * columns (or rows) and removes the digit from the rest of those columns
+ * (or rows). X-wings, swordfish and jellyfish are sizes 2, 3 and 4.
+ */
+static bool fish(GradeState *state, int size)
+{
+    for(int digit = 1; digit <= BOARDSIZE; digit++){
+        uint16_t bit = 1 << (digit - 1);
+        for(int base = 0; base < BOXUNIT; base += BOARDSIZE){
+            int cover = BOARDSIZE - base; //Columns for rows and vice versa
+            uint16_t places[BOARDSIZE];
+            for(int line = 0; line < BOARDSIZE; line++){
+                places[line] = digitPlaces(state, base + line, bit);
+            }
+            for(int subset = 0; subset <= ALLDIGITS; subset++){
+                if(__builtin_popcount(subset) != size){
+                    continue;
+                }
+                uint16_t covered = 0;
+                bool allOpen = true;
+                for(int line = 0; line < BOARDSIZE; line++){
+                    if(subset & (1 << line)){
+                        covered |= places[line];
+                        allOpen &= places[line] != 0;
+                    }
+                }
+                if(!allOpen || __builtin_popcount(covered) != size){
+                    continue;
+                }
+                bool changed = false;
+                for(int c = 0; c < BOARDSIZE; c++){
+                    if(!(covered & (1 << c))){
+                        continue;
+                    }
+                    for(int k = 0; k < BOARDSIZE; k++){
+                        if(!(subset & (1 << k))){
+                            changed |= eliminate(state,
+                                                 unitCells[cover + c][k], bit);
+                        }
+                    }
+                }
+                if(changed){
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * The ladder's rungs for subsets and fish of each size.
+ */
+static bool nakedPair(GradeState *state)
+{
+    return nakedSubset(state, 2);
+}
+
+static bool xWing(GradeState *state)
+{
+    return fish(state, 2);
+}
+
+static bool hiddenPair(GradeState *state)
+{
+    return hiddenSubset(state, 2, false);
+}
+
+static bool nakedTriple(GradeState *state)
+{
+    return nakedSubset(state, 3);
+}
+
+static bool swordfish(GradeState *state)
+{
+    return fish(state, 3);
+}
+
+static bool hiddenTriple(GradeState *state)
+{
+    return hiddenSubset(state, 3, false);
+}
+
+/**
+ * Finds a cell with candidates {x, y} that sees a cell with {x, z} and one
+ * with {y, z}. Whichever of x and y the first cell takes, one of the other
+ * two is z, so z is removed from every cell that sees both of them.
+ */
+static bool xyWing(GradeState *state)
+{
+    for(int pivot = 0; pivot < NUMCELLS; pivot++){
+        uint16_t xy = state->cands[pivot];
+        if(__builtin_popcount(xy) != 2){
+            continue;
+        }
+        for(int a = 0; a < NUMCELLS; a++){
+            uint16_t xz = state->cands[a];
+            if(!sees(pivot, a) || __builtin_popcount(xz) != 2 ||
+               __builtin_popcount(xz & xy) != 1){
+                continue;
+            }
+            uint16_t z = xz & ~xy;
+            uint16_t yz = (xy & ~xz) | z;
+            for(int b = 0; b < NUMCELLS; b++){
+                if(state->cands[b] != yz || !sees(pivot, b)){
+                    continue;
+                }
+                bool changed = false;
+                for(int i = 0; i < NUMCELLS; i++){
+                    if(i != pivot && sees(i, a) && sees(i, b)){
+                        changed |= eliminate(state, i, z);
+                    }
+                }
+                if(changed){
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Like an xy-wing but the middle cell also has z as a candidate, so z can
+ * only be removed from cells that see all three.
+ */
+static bool xyzWing(GradeState *state)
+{
+    for(int pivot = 0; pivot < NUMCELLS; pivot++){
+        uint16_t xyz = state->cands[pivot];
+        if(__builtin_popcount(xyz) != 3){
+            continue;
+        }
+        for(int a = 0; a < NUMCELLS; a++){
+            uint16_t xz = state->cands[a];
+            if(!sees(pivot, a) || __builtin_popcount(xz) != 2 ||
+               (xz & ~xyz) != 0){
+                continue;
+            }
+            for(int b = a + 1; b < NUMCELLS; b++){
+                uint16_t yz = state->cands[b];
+                if(!sees(pivot, b) || __builtin_popcount(yz) != 2 ||
+                   (yz & ~xyz) != 0 || yz == xz){
+                    continue;
+                }
+                uint16_t z = xz & yz;
+                bool changed = false;
+                for(int i = 0; i < NUMCELLS; i++){
+                    if(sees(i, pivot) && sees(i, a) && sees(i, b)){
+                        changed |= eliminate(state, i, z);
+                    }
+                }
+                if(changed){
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds a unique rectangle: four empty cells on two rows, two columns and
+ * two squares that all have the candidates x and y. Were the four left with
+ * only x and y they could swap them for a second solution, so one of them
+ * must take something else, which gives SE's deductions of
+ *  type 1: three corners are {x, y}, so x and y are removed from the fourth;
+ *  type 2: two corners on a line are {x, y} and the other two {x, y, z}, so
+ *          one of those is z and z is removed from every cell seeing both;
+ *  type 4: two corners on a line are {x, y} and the other two have x only
+ *          in each other in a unit they share, so one of them is x and the
+ *          other can not be y, which is removed from both.
+ */
+static bool uniqueRectangle(GradeState *state, int type)
+{
+    //The pairs of corners sharing a line: the two rows, then the columns
+    static const int floors[4][2] = {{0, 1}, {2, 3}, {0, 2}, {1, 3}};
+    for(int r1 = 0; r1 < BOARDSIZE; r1++){
+        for(int r2 = r1 + 1; r2 < BOARDSIZE; r2++){
+            for(int c1 = 0; c1 < BOARDSIZE; c1++){
+                for(int c2 = c1 + 1; c2 < BOARDSIZE; c2++){
+                    if((r1 / 3 == r2 / 3) == (c1 / 3 == c2 / 3)){
+                        continue; //One square or four
+                    }
+                    int corners[4] = {r1 * BOARDSIZE + c1,
+                                      r1 * BOARDSIZE + c2,
+                                      r2 * BOARDSIZE + c1,
+                                      r2 * BOARDSIZE + c2};
+                    uint16_t common = ALLDIGITS;
+                    for(int k = 0; k < 4; k++){
+                        common &= state->cands[corners[k]];
+                    }
+                    for(uint16_t x = common; x != 0; x &= x - 1){
+                        for(uint16_t y = x & (x - 1); y != 0; y &= y - 1){
+                            uint16_t xy = (x & -x) | (y & -y);
+                            if(type == 1){
+                                int odd = -1;
+                                int pairs = 0;
+                                for(int k = 0; k < 4; k++){
+                                    if(state->cands[corners[k]] == xy){
+                                        pairs++;
+                                    }
+                                    else{
+                                        odd = corners[k];
+                                    }
+                                }
+                                if(pairs == 3){
+                                    return eliminate(state, odd, xy);
+                                }
+                                continue;
+                            }
+                            for(int f = 0; f < 4; f++){
+                                int a = corners[floors[f][0]];
+                                int b = corners[floors[f][1]];
+                                int ra = corners[floors[f ^ 1][0]];
+                                int rb = corners[floors[f ^ 1][1]];
+                                if(state->cands[a] != xy ||
+                                   state->cands[b] != xy ||
+                                   state->cands[ra] == xy ||
+                                   state->cands[rb] == xy){
+                                    continue;
+                                }
+                                bool changed = false;
+                                uint16_t z = state->cands[ra] & ~xy;
+                                if(type == 2){
+                                    if(__builtin_popcount(z) != 1 ||
+                                       state->cands[rb] != (xy | z)){
+                                        continue;
+                                    }
+                                    for(int i = 0; i < NUMCELLS; i++){
+                                        if(sees(i, ra) && sees(i, rb)){
+                                            changed |= eliminate(state, i, z);
+                                        }
+                                    }
+                                }
+                                else if(roofsConjugate(state, ra, rb,
+                                                       x & -x)){
+                                    changed |= eliminate(state, ra, y & -y);
+                                    changed |= eliminate(state, rb, y & -y);
+                                }
+                                else if(roofsConjugate(state, ra, rb,
+                                                       y & -y)){
+                                    changed |= eliminate(state, ra, x & -x);
+                                    changed |= eliminate(state, rb, x & -x);
+                                }
+                                if(changed){
+                                    return true;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns true if some unit holding both cells `a` and `b` has no other
+ * place for `bit`.
+ */
+static bool roofsConjugate(const GradeState *state, int a, int b,
+                           uint16_t bit)
+{
+    int units[3] = {ROWOF(a), BOARDSIZE + COLOF(a), BOXUNIT + BOXOF(a)};
+    for(int u = 0; u < 3; u++){
+        bool holdsB = false;
+        int others = 0;
+        for(int k = 0; k < BOARDSIZE; k++){
+            int cell = unitCells[units[u]][k];
+            holdsB |= cell == b;
+            others += cell != a && cell != b && (state->cands[cell] & bit);
+        }
+        if(holdsB && others == 0){
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * The ladder's rungs for each type of unique rectangle.
+ */
+static bool uniqueRectangle1(GradeState *state)
+{
+    return uniqueRectangle(state, 1);
+}
+
+static bool uniqueRectangle2(GradeState *state)
+{
+    return uniqueRectangle(state, 2);
+}
+
+static bool uniqueRectangle4(GradeState *state)
+{
+    return uniqueRectangle(state, 4);
+}
+
+static bool nakedQuad(GradeState *state)
+{
+    return nakedSubset(state, 4);
+}
+
+static bool jellyfish(GradeState *state)
+{
+    return fish(state, 4);
+}
+
+static bool hiddenQuad(GradeState *state)
+{
+    return hiddenSubset(state, 4, false);
+}
+
+/**
+ * Finds a BUG+1: every empty cell has two candidates but one, which has
+ * three. Were one of its three removed so that every unit had each of its
+ * candidates in exactly two places, the grid would be a bivalue graveyard
+ * with two solutions, so the cell takes the digit whose removal does that.
+ */
+static bool bugPlusOne(GradeState *state)
+{
+    int odd = -1;
+    for(int i = 0; i < NUMCELLS; i++){
+        int count = __builtin_popcount(state->cands[i]);
+        if(count == 3 && odd < 0){
+            odd = i;
+        }
+        else if(count != 0 && count != 2){
+            return false;
+        }
+    }
+    if(odd < 0){
+        return false;
+    }
+    uint16_t cands = state->cands[odd];
+    for(int digit = 1; digit <= BOARDSIZE; digit++){
+        uint16_t bit = 1 << (digit - 1);
+        if(!(cands & bit)){
+            continue;
+        }
+        GradeState trial = *state;
+        trial.cands[odd] &= ~bit;
+        bool grave = true;
+        for(int unit = 0; unit < NUMUNITS && grave; unit++){
+            for(int d = 0; d < BOARDSIZE && grave; d++){
+                int places = __builtin_popcount(digitPlaces(&trial, unit,
+                                                            1 << d));
+                grave = places == 0 || places == 2;
+            }
+        }
+        if(grave){
+            placeValue(state, odd, digit);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,136 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Rates the difficulty of a puzzle on the Sudoku Explainer (SE) scale. Like
+ * SE the rater solves the puzzle the way a person would, one step at a time,
+ * always using the easiest technique that makes progress, and the rating is
+ * the SE rating of the hardest technique that was needed.
+ *
+ * The grid is kept as one candidate bitmask per cell (bit d-1 is set if digit
+ * d is still possible), so every technique is a handful of mask operations
+ * over the 27 units instead of the object graph the Java original walks.
+ *
+ * The ladder has SE's techniques up to 5.6 (see Technique below), with the
+ * direct variants (an intersection or hidden set that only counts when it
+ * leaves a hidden single, which is placed) in their place among the singles.
+ * Of the uniqueness techniques it has unique rectangles of types 1, 2 and 4
+ * and BUG+1, but not rectangle type 3, longer unique loops or the other BUG
+ * types. A puzzle the ladder gets stuck on needs one of those or one of SE's
+ * harder techniques (aligned exclusion, chains, nets...) from 6.2 up, so its
+ * rating is unknown: it is marked as unsolved and its score only covers the
+ * steps taken before the ladder got stuck.
+ *
+ * Most puzzles only need singles, and for those the step by step ladder is
+ * wasted work. classifySingles is a cheap pre-filter that fills singles in
+ * one pass over the puzzle. Singles never stop being available once they
+ * appear, so the order they are filled in does not matter and the rating of
+ * a puzzle that full houses and hidden singles solve is just the lowest rung
+ * whose singles are enough, which the pass finds by only moving on to a
+ * harder rung once the easier ones are used up. Only those puzzles are rated
+ * on the spot: once naked singles are needed, the direct techniques rated
+ * below them may be what SE uses, and only the ladder can tell. A puzzle the
+ * pass does not solve has the solutions of the state it left counted, so
+ * that only a puzzle with exactly one solution goes on to ladder grading.
+ */
+#ifndef SUDOKU_RATER_H
+#define SUDOKU_RATER_H
+
+#include "./sudokuSolver.h"
+
+//The techniques of the ladder from easiest to hardest
+typedef enum technique{
+    TECH_NONE = 0,
+    TECH_FULL_HOUSE,           //1.0
+    TECH_HIDDEN_SINGLE_BOX,    //1.2
+    TECH_HIDDEN_SINGLE_LINE,   //1.5
+    TECH_DIRECT_POINTING,      //1.7
+    TECH_DIRECT_CLAIMING,      //1.9
+    TECH_DIRECT_HIDDEN_PAIR,   //2.0
+    TECH_NAKED_SINGLE,         //2.3
+    TECH_DIRECT_HIDDEN_TRIPLE, //2.5
+    TECH_POINTING,             //2.6
+    TECH_CLAIMING,             //2.8
+    TECH_NAKED_PAIR,           //3.0
+    TECH_X_WING,               //3.2
+    TECH_HIDDEN_PAIR,          //3.4
+    TECH_NAKED_TRIPLE,         //3.6
+    TECH_SWORDFISH,            //3.8
+    TECH_HIDDEN_TRIPLE,        //4.0
+    TECH_XY_WING,              //4.2
+    TECH_XYZ_WING,             //4.4
+    TECH_UNIQUE_RECTANGLE_1,   //4.5
+    TECH_UNIQUE_RECTANGLE_2,   //4.6
+    TECH_UNIQUE_RECTANGLE_4,   //4.6
+    TECH_NAKED_QUAD,           //5.0
+    TECH_JELLYFISH,            //5.2
+    TECH_HIDDEN_QUAD,          //5.4
+    TECH_BUG_PLUS_ONE,         //5.6
+    NUMTECHNIQUES
+}Technique;
+
+typedef struct rating{
+    int score;         //SE rating times ten (2.3 is 23), 0 if nothing was
+                       //needed
+    Technique hardest; //The technique the score comes from
+    int steps;         //The number of steps taken
+    bool solved;       //False if the ladder got stuck, and then the score
+                       //is not the puzzle's rating
+}Rating;
+
+typedef enum singlesResult{
+    SINGLES_SOLVED = 0, //Rated by the pass, so the solution is unique
+    SINGLES_STUCK,      //Needs the ladder, the solution is unique
+    SINGLES_INVALID     //Malformed, not legal or without a unique solution
+}SinglesResult;
+
+/********* function prototypes *********/
+
+bool rateString(const char *clues, Rating *rating);
+bool rateValues(const uint8_t *values, Rating *rating);
+const char *techniqueName(Technique tech);
+int techniqueScore(Technique tech);
+SinglesResult classifySingles(const uint8_t *values, Rating *rating);
+
+/**
+ * Rates the puzzle given by the string `clues` (same format as solveString)
+ * and writes the result to `rating`.
+ *
+ * This function will return false if either argument is NULL, the clues are
+ * malformed or not legal, or if the steps taken show that the puzzle has no
+ * solution. Ratings assume the puzzle has a unique solution, as SE does.
+ */
+bool rateString(const char *clues, Rating *rating);
+
+/**
+ * Rates the puzzle given as 81 cell values (0 for an empty cell) the same way
+ * as rateString.
+ */
+bool rateValues(const uint8_t *values, Rating *rating);
+
+/**
+ * Returns the name of the given technique, or "unknown" if it is out of
+ * range.
+ */
+const char *techniqueName(Technique tech);
+
+/**
+ * Returns the SE rating (times ten) of the given technique, or -1 if it is
+ * out of range.
+ */
+int techniqueScore(Technique tech);
+
+/**
+ * Checks whether the puzzle given as 81 cell values can be solved with full
+ * houses and hidden singles alone. If so its rating, which is the same one
+ * rateValues would give, is written to `rating` and SINGLES_SOLVED is
+ * returned. A puzzle solved this way always has exactly one solution.
+ *
+ * Returns SINGLES_STUCK if those are not enough but the puzzle has exactly
+ * one solution, in which case it still needs rateValues (and `rating` holds
+ * nothing useful), or SINGLES_INVALID if either argument is NULL, the values
+ * are not legal or the puzzle has no solution or more than one.
+ */
+SinglesResult classifySingles(const uint8_t *values, Rating *rating);
+
+#endif
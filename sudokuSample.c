@@ -0,0 +1,351 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements uniform solution sampling. See sudokuSample.h for the method.
+ *
+ * Partial boards are handed to countSolutionsTT as clue strings and the cell
+ * each step branches on comes from pickUnitCell, so this module only needs
+ * the solver's public entry points. Each counting round fills a list of
+ * jobs, one partial board each along with the candidate it counts towards,
+ * and starts the threads on it; a thread claims the next job with an atomic
+ * counter and counts it with its own table.
+ */
+#include <threads.h>
+#include <stdatomic.h>
+#include "./sudokuSample.h"
+
+#define MAX_JOBS (SAMPLE_MAX_THREADS * SAMPLE_JOBS_PER_THREAD * BOARDSIZE)
+#define MAX_EXPANSIONS 3 //Most cells a step is expanded below its own
+
+typedef struct sampleJob{
+    uint8_t values[NUMCELLS];
+    int owner;  //Digit (0 - 8) of the step the count belongs to
+    long count;
+}SampleJob;
+
+typedef struct sampler{
+    int threads;
+    long limit;
+    TransTable *tables[SAMPLE_MAX_THREADS];
+    SolverStats totals[SAMPLE_MAX_THREADS]; //Counting done by each thread
+    SampleJob *jobs;
+    int numJobs;
+    atomic_int nextJob;
+    unsigned long counted; //Jobs counted over all rounds
+}Sampler;
+
+typedef struct sampleWorker{
+    Sampler *sampler;
+    int id;
+}SampleWorker;
+
+/********* function prototypes *********/
+
+long sampleSolutions(const uint8_t *values, int k, uint8_t *samples,
+                     long limit, int threads, size_t tableBytes,
+                     uint64_t seed, SampleStats *stats);
+static bool countStep(Sampler *sampler, const uint8_t *values, int cell,
+                      uint16_t cands, long *counts);
+static void expandJobs(Sampler *sampler);
+static bool runJobs(Sampler *sampler);
+static int countJobs(void *arg);
+static int pickCell(const uint8_t *values, uint16_t *cands);
+static long drawDigit(const long *counts, long total, uint64_t *random);
+static uint64_t nextRandom(uint64_t *state);
+static void freeSampler(Sampler *sampler);
+
+/**
+ * Draws `k` solutions of the board given as 81 cell values (0 for an empty
+ * cell) uniformly at random and independently of each other, writing them
+ * to `samples` as k runs of 81 values. Counting is shared out over `threads`
+ * threads, each with a transposition table of `tableBytes` bytes, and `seed`
+ * makes the draws repeatable.
+ *
+ * Returns the number of solutions of the board. If it has none, or `limit`
+ * or more (too many to count exactly, in which case `limit` is returned), no
+ * samples are drawn. Returns -1 if an array is NULL, `k` or `threads` is out
+ * of range, the values are not legal or the tables or threads could not be
+ * had. If `stats` is not NULL the counting statistics are written to it.
+ */
+long sampleSolutions(const uint8_t *values, int k, uint8_t *samples,
+                     long limit, int threads, size_t tableBytes,
+                     uint64_t seed, SampleStats *stats)
+{
+    SampleStats local;
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SampleStats));
+    if(values == NULL || samples == NULL || k < 0 || limit < 1 ||
+       threads < 1 || threads > SAMPLE_MAX_THREADS || !checkValues(values)){
+        return -1;
+    }
+    Sampler sampler;
+    memset(&sampler, 0, sizeof(Sampler));
+    sampler.threads = threads;
+    sampler.limit = limit;
+    sampler.jobs = malloc(MAX_JOBS * sizeof(SampleJob));
+    bool ready = sampler.jobs != NULL;
+    for(int t = 0; t < threads && ready; t++){
+        sampler.tables[t] = initTransTable(tableBytes);
+        ready = sampler.tables[t] != NULL;
+    }
+
+    //The first step is the same for every sample and its counts add up to
+    //the number of solutions, so it is only counted once
+    long total = -1;
+    long rootCounts[BOARDSIZE] = {0};
+    uint16_t rootCands;
+    int rootCell = pickCell(values, &rootCands);
+    if(ready && rootCell == -1){
+        total = 1; //The board is already full
+    }
+    else if(ready && countStep(&sampler, values, rootCell, rootCands,
+                               rootCounts)){
+        total = 0;
+        for(int d = 0; d < BOARDSIZE; d++){
+            total = rootCounts[d] >= limit - total ? limit :
+                    total + rootCounts[d];
+        }
+    }
+
+    uint64_t random = seed;
+    for(int s = 0; s < k && total > 0 && total < limit; s++){
+        uint8_t *sample = samples + s * NUMCELLS;
+        memcpy(sample, values, NUMCELLS);
+        long counts[BOARDSIZE];
+        long sum = total;
+        int cell = rootCell;
+        uint16_t cands = rootCands;
+        memcpy(counts, rootCounts, sizeof(counts));
+        while(cell != -1){
+            sample[cell] = drawDigit(counts, sum, &random) + 1;
+            cell = pickCell(sample, &cands);
+            if(cell == -1){
+                break;
+            }
+            if(!countStep(&sampler, sample, cell, cands, counts)){
+                total = -1;
+                break;
+            }
+            //Every count is below the one of the branch taken, so no cap
+            sum = 0;
+            for(int d = 0; d < BOARDSIZE; d++){
+                sum += counts[d];
+            }
+        }
+    }
+
+    stats->solutions = total;
+    stats->counts = sampler.counted;
+    for(int t = 0; t < threads; t++){
+        stats->nodes += sampler.totals[t].nodes;
+        stats->ttHits += sampler.totals[t].ttHits;
+    }
+    freeSampler(&sampler);
+    return total;
+}
+
+/**
+ * Counts the solutions below every candidate of `cell` on the given board,
+ * writing the count for digit d to counts[d - 1] (0 for the digits that are
+ * not candidates) with each count capped at the sampler's limit. Returns
+ * false if the threads could not be started.
+ */
+static bool countStep(Sampler *sampler, const uint8_t *values, int cell,
+                      uint16_t cands, long *counts)
+{
+    sampler->numJobs = 0;
+    for(int d = 0; d < BOARDSIZE; d++){
+        counts[d] = 0;
+        if(cands & (1 << d)){
+            SampleJob *job = &sampler->jobs[sampler->numJobs++];
+            memcpy(job->values, values, NUMCELLS);
+            job->values[cell] = d + 1;
+            job->owner = d;
+        }
+    }
+    if(sampler->threads > 1){
+        expandJobs(sampler);
+    }
+    if(!runJobs(sampler)){
+        return false;
+    }
+    long limit = sampler->limit;
+    for(int j = 0; j < sampler->numJobs; j++){
+        long *count = &counts[sampler->jobs[j].owner];
+        long add = sampler->jobs[j].count;
+        *count = add >= limit - *count ? limit : *count + add;
+    }
+    return true;
+}
+
+/**
+ * Splits the jobs into the boards below their cell with the fewest
+ * candidates until there are enough to keep every thread busy, the list
+ * would overflow or MAX_EXPANSIONS cells have been split. Full boards are
+ * kept as they are and boards with a cell left without candidates are
+ * dropped, since they count 1 and 0.
+ */
+static void expandJobs(Sampler *sampler)
+{
+    int wanted = sampler->threads * SAMPLE_JOBS_PER_THREAD;
+    for(int round = 0; round < MAX_EXPANSIONS &&
+        sampler->numJobs < wanted; round++){
+        if(sampler->numJobs * (BOARDSIZE + 1) > MAX_JOBS){
+            return;
+        }
+        //New jobs go after the old ones, which are then moved down over the
+        //ones that were split
+        int old = sampler->numJobs;
+        int kept = 0;
+        int end = old;
+        for(int j = 0; j < old; j++){
+            SampleJob *job = &sampler->jobs[j];
+            uint16_t cands;
+            int cell = pickCell(job->values, &cands);
+            if(cell == -1){
+                sampler->jobs[kept++] = *job;
+                continue;
+            }
+            for(int d = 0; d < BOARDSIZE; d++){
+                if(cands & (1 << d)){
+                    SampleJob *child = &sampler->jobs[end++];
+                    *child = *job;
+                    child->values[cell] = d + 1;
+                }
+            }
+        }
+        memmove(sampler->jobs + kept, sampler->jobs + old,
+                (end - old) * sizeof(SampleJob));
+        sampler->numJobs = kept + end - old;
+        if(end == old){ //Every job was a full board
+            return;
+        }
+    }
+}
+
+/**
+ * Counts every job in the list, on the sampler's threads if it has more
+ * than one. Returns false if a thread could not be started, in which case
+ * the counts are not all there.
+ */
+static bool runJobs(Sampler *sampler)
+{
+    SampleWorker workers[SAMPLE_MAX_THREADS];
+    thrd_t ids[SAMPLE_MAX_THREADS];
+    atomic_store(&sampler->nextJob, 0);
+    sampler->counted += sampler->numJobs;
+    if(sampler->threads == 1){
+        workers[0].sampler = sampler;
+        workers[0].id = 0;
+        countJobs(&workers[0]);
+        return true;
+    }
+    int started = 0;
+    for(; started < sampler->threads; started++){
+        workers[started].sampler = sampler;
+        workers[started].id = started;
+        if(thrd_create(&ids[started], countJobs, &workers[started]) !=
+           thrd_success){
+            break;
+        }
+    }
+    for(int t = 0; t < started; t++){
+        thrd_join(ids[t], NULL);
+    }
+    //Any thread that did start still emptied the list
+    return started > 0;
+}
+
+/**
+ * Thread body: claims jobs one at a time until the list is empty and counts
+ * each with the thread's own table.
+ */
+static int countJobs(void *arg)
+{
+    SampleWorker *worker = arg;
+    Sampler *sampler = worker->sampler;
+    SolverStats *total = &sampler->totals[worker->id];
+    int j;
+    while((j = atomic_fetch_add(&sampler->nextJob, 1)) < sampler->numJobs){
+        SampleJob *job = &sampler->jobs[j];
+        char clues[NUMCELLS + 1];
+        SolverStats stats;
+        for(int i = 0; i < NUMCELLS; i++){
+            clues[i] = '0' + job->values[i];
+        }
+        clues[NUMCELLS] = '\0';
+        job->count = countSolutionsTT(clues, sampler->limit,
+                                      sampler->tables[worker->id], &stats);
+        total->nodes += stats.nodes;
+        total->ttHits += stats.ttHits;
+    }
+    return 0;
+}
+
+/**
+ * Returns the empty cell with the fewest candidates on the board and writes
+ * those candidates to `cands`, or returns -1 if the board is full. The board
+ * is loaded into a view over the grid's units for pickUnitCell.
+ */
+static int pickCell(const uint8_t *values, uint16_t *cands)
+{
+    uint8_t grid[NUMCELLS] = {0};
+    uint16_t used[3 * BOARDSIZE] = {0};
+    UnitView view = {grid, NULL, used};
+    for(int i = 0; i < NUMCELLS; i++){
+        if(values[i] != 0){
+            placeUnitDigit(gridUnits(), &view, i, values[i]);
+        }
+    }
+    //A cell with no candidates is the fewest there can be
+    return pickUnitCell(gridUnits(), &view, 0, cands);
+}
+
+/**
+ * Returns a digit index (0 - 8) drawn with probability counts[d] / total,
+ * where `total` is the sum of the counts and more than 0.
+ */
+static long drawDigit(const long *counts, long total, uint64_t *random)
+{
+    //Draws from the largest multiple of total up are thrown away so every
+    //value below total is equally likely
+    uint64_t span = (uint64_t)total;
+    uint64_t ceiling = UINT64_MAX - UINT64_MAX % span;
+    uint64_t draw;
+    do{
+        draw = nextRandom(random);
+    }while(draw >= ceiling);
+    long pick = draw % span;
+    for(int d = 0; d < BOARDSIZE; d++){
+        if(pick < counts[d]){
+            return d;
+        }
+        pick -= counts[d];
+    }
+    return BOARDSIZE - 1; //Not reached when the counts add up to total
+}
+
+/**
+ * Returns the next number from a splitmix64 generator.
+ */
+static uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Frees the tables and job list of a sampler.
+ */
+static void freeSampler(Sampler *sampler)
+{
+    for(int t = 0; t < sampler->threads; t++){
+        deleteTransTable(sampler->tables[t]);
+    }
+    free(sampler->jobs);
+}
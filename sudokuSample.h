@@ -0,0 +1,67 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements drawing solutions of a board with many of them uniformly at
+ * random, for research on generators that start from under-constrained
+ * boards. Searching with the digits tried in random order does not do this:
+ * a solution at the end of a lone branch is found far more often than one of
+ * thousands under a sibling branch, so the draws lean heavily towards the
+ * sparse corners of the search tree.
+ *
+ * Instead every sample is built one cell at a time from the top: at each
+ * step the empty cell with the fewest candidates is picked, the solutions
+ * below every candidate digit are counted, and the digit is drawn with
+ * probability proportional to its count. The product of those probabilities
+ * along the way is 1 over the total, so every solution is exactly as likely.
+ * The counts come from countSolutionsTT, and every thread keeps its own
+ * transposition table across all the steps and samples of a call, so a
+ * subtree counted once (and the many subtrees equal to it up to digits moved
+ * within their units) is not counted again at the next step or sample.
+ *
+ * Counting near the top of a sparse board is where nearly all the time goes,
+ * so each step is counted in parallel: the candidate digits are expanded a
+ * few cells deeper into enough independent partial boards to keep every
+ * thread busy, the threads take boards off that list until it is empty and
+ * the counts are added back up per candidate.
+ */
+#ifndef SUDOKU_SAMPLE_H
+#define SUDOKU_SAMPLE_H
+
+#include "./sudokuSolver.h"
+
+#define SAMPLE_MAX_THREADS 64
+#define SAMPLE_JOBS_PER_THREAD 4 //Partial boards each step is split into
+                                 //per thread, at least
+
+typedef struct sampleStats{
+    long solutions;        //Solutions of the board, capped at the limit
+    unsigned long counts;  //Partial boards counted
+    unsigned long nodes;   //Search nodes all the counting took
+    unsigned long ttHits;  //Subtrees whose count came from a table
+}SampleStats;
+
+/********* function prototypes *********/
+
+long sampleSolutions(const uint8_t *values, int k, uint8_t *samples,
+                     long limit, int threads, size_t tableBytes,
+                     uint64_t seed, SampleStats *stats);
+
+/**
+ * Draws `k` solutions of the board given as 81 cell values (0 for an empty
+ * cell) uniformly at random and independently of each other, writing them
+ * to `samples` as k runs of 81 values. Counting is shared out over `threads`
+ * threads, each with a transposition table of `tableBytes` bytes, and `seed`
+ * makes the draws repeatable.
+ *
+ * Returns the number of solutions of the board. If it has none, or `limit`
+ * or more (too many to count exactly, in which case `limit` is returned), no
+ * samples are drawn. Returns -1 if an array is NULL, `k` or `threads` is out
+ * of range, the values are not legal or the tables or threads could not be
+ * had. If `stats` is not NULL the counting statistics are written to it.
+ */
+long sampleSolutions(const uint8_t *values, int k, uint8_t *samples,
+                     long limit, int threads, size_t tableBytes,
+                     uint64_t seed, SampleStats *stats);
+
+#endif
@@ -0,0 +1,1124 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements the CDCL sudoku solver. See sudokuSat.h for the encoding and the
+ * design of the SAT solver.
+ *
+ * A literal is 2 * variable for the variable being true and 2 * variable + 1
+ * for it being false, so negating one flips its low bit. All clauses live
+ * back to back in one array of literals; the first two literals of a clause
+ * are the ones it watches, and a clause that implied a literal always holds
+ * that literal first. A watch list holds pairs of a clause and a literal of
+ * it (its blocker): while the blocker is true the clause is satisfied and
+ * propagation skips it without reading its literals. Most clauses of the
+ * encoding exclude a pair, and those are watched in lists of their own with
+ * the other literal as the blocker, so they imply it or conflict without
+ * ever being read. Deleting learned clauses moves the ones left down over
+ * them, so a clause is only known by its index between two reductions.
+ */
+#include "./sudokuSat.h"
+
+#define LIT(var, negated) (2 * (var) + (negated))
+#define VAROF(lit) ((lit) >> 1)
+#define NEGATE(lit) ((lit) ^ 1)
+#define NO_REASON -1       //Reason of a decision or of no clause at all
+#define ACTIVITY_LIMIT 1e100 //Activities are scaled down past this
+
+typedef struct intVec{
+    int *data;
+    int len;
+    int cap;
+}IntVec;
+
+typedef struct learntRank{
+    int glue;
+    int clause;
+}LearntRank;
+
+typedef struct satSolver{
+    int numVars;
+    IntVec lits;        //The literals of every clause back to back
+    IntVec starts;      //Where each clause starts in `lits`
+    IntVec sizes;       //How many literals each clause has
+    IntVec glue;        //Glue of each clause, 0 for the clauses of the grid
+    int numLearnts;     //Learned clauses not deleted yet
+    int reduceLimit;    //Learned clauses that set off the next reduction
+    int *levelStamp;    //Scratch marks of decision levels for the glue
+    int stamp;          //Mark the next glue count leaves in `levelStamp`
+    IntVec *watches;    //Clauses watching each literal, with their blockers
+    IntVec *binWatches; //The same for the clauses of two literals
+    int8_t *assign;     //Value of each variable, -1 if it has none yet
+    int *level;         //Decision level each variable got its value at
+    int *reason;        //Clause that implied each variable, or NO_REASON
+    uint8_t *seen;      //Scratch marks for conflict analysis
+    double *activity;
+    double varInc;      //Amount the next bump adds to an activity
+    int *heap;          //Variables by activity, highest first
+    int *heapPos;       //Index of each variable in `heap`, -1 if absent
+    int heapLen;
+    int *trail;         //Literals made true, in order
+    int trailLen;
+    int qhead;          //Literals on the trail not yet propagated start here
+    IntVec trailLim;    //Trail length at the start of each decision level
+    IntVec learnt;      //Clause being learned
+    IntVec marked;      //Variables marked in `seen` while learning it
+    IntVec pending;     //Literals still to check when minimising it
+    bool outOfMemory;
+    SatStats *stats;
+}SatSolver;
+
+/********* function prototypes *********/
+
+bool satSolveGrid(int boxSize, const uint8_t *values, uint8_t *solution,
+                  SatStats *stats);
+bool solveValuesSat(const uint8_t *values, uint8_t *solution,
+                    SolverStats *stats);
+static bool encodeGrid(SatSolver *s, int boxSize, const uint8_t *values,
+                       int *varOf);
+static int unitCellOf(int boxSize, int unit, int index);
+static int numberSegments(int boxSize, const int *varOf, int *segOf,
+                          int numVars);
+static bool encodeSegments(SatSolver *s, int boxSize, const int *varOf,
+                           const int *segOf);
+static int segmentCell(int boxSize, int dir, int line, int box, int index);
+static bool addExactlyOne(SatSolver *s, const int *vars, int count,
+                          bool pairs, const int *cells, int side);
+static bool initSolver(SatSolver *s, int numVars, SatStats *stats);
+static void freeSolver(SatSolver *s);
+static void pushInt(SatSolver *s, IntVec *vec, int value);
+static int valueOf(const SatSolver *s, int lit);
+static bool addClause(SatSolver *s, const int *lits, int size);
+static void watchClause(SatSolver *s, int lit, int clause, int blocker);
+static void enqueue(SatSolver *s, int lit, int reason);
+static int propagate(SatSolver *s);
+static int analyze(SatSolver *s, int conflict);
+static bool redundant(SatSolver *s, int lit, uint32_t levels);
+static int clauseGlue(SatSolver *s, const int *lits, int size);
+static bool clauseLocked(const SatSolver *s, int clause);
+static void reduceLearnts(SatSolver *s);
+static int compareRanks(const void *a, const void *b);
+static void cancelUntil(SatSolver *s, int level);
+static bool search(SatSolver *s);
+static long luby(long index);
+static void bumpVar(SatSolver *s, int var);
+static void heapInsert(SatSolver *s, int var);
+static void heapUp(SatSolver *s, int index);
+static int heapPop(SatSolver *s);
+
+/**
+ * Solves a grid with boxes of `boxSize` by `boxSize` cells, so boxSize^2 rows
+ * of boxSize^2 cells given row by row in `values` (0 for an empty cell, the
+ * digits are 1 to boxSize^2). On success the solution is written to
+ * `solution` in the same form and true is returned.
+ *
+ * This function will return false if either array is NULL, the box size is
+ * out of range, the values are not legal, the puzzle has no solution or the
+ * formula could not be allocated. If `stats` is not NULL the statistics of
+ * the solve are written to it.
+ */
+bool satSolveGrid(int boxSize, const uint8_t *values, uint8_t *solution,
+                  SatStats *stats)
+{
+    SatStats local;
+    SatSolver s;
+    if(values == NULL || solution == NULL || boxSize < SAT_MIN_BOX ||
+       boxSize > SAT_MAX_BOX){
+        return false;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SatStats));
+    int side = boxSize * boxSize;
+    int cells = side * side;
+    int *varOf = malloc((size_t)cells * side * sizeof(int));
+    int *segOf = malloc((size_t)2 * side * boxSize * side * sizeof(int));
+    if(varOf == NULL || segOf == NULL){
+        free(varOf);
+        free(segOf);
+        return false;
+    }
+
+    //Number the candidates of the empty cells, the variables of the formula
+    uint64_t rows[SAT_MAX_BOX * SAT_MAX_BOX] = {0};
+    uint64_t cols[SAT_MAX_BOX * SAT_MAX_BOX] = {0};
+    uint64_t boxes[SAT_MAX_BOX * SAT_MAX_BOX] = {0};
+    for(int i = 0; i < cells; i++){
+        int row = i / side;
+        int col = i % side;
+        int box = (row / boxSize) * boxSize + col / boxSize;
+        if(values[i] > side){
+            free(varOf);
+            free(segOf);
+            return false;
+        }
+        if(values[i] != 0){
+            uint64_t bit = (uint64_t)1 << (values[i] - 1);
+            if((rows[row] | cols[col] | boxes[box]) & bit){
+                free(varOf);
+                free(segOf);
+                return false;
+            }
+            rows[row] |= bit;
+            cols[col] |= bit;
+            boxes[box] |= bit;
+        }
+    }
+    int numVars = 0;
+    for(int i = 0; i < cells; i++){
+        int row = i / side;
+        int col = i % side;
+        uint64_t used = rows[row] | cols[col] |
+                        boxes[(row / boxSize) * boxSize + col / boxSize];
+        for(int d = 0; d < side; d++){
+            bool open = values[i] == 0 && !(used & ((uint64_t)1 << d));
+            varOf[i * side + d] = open ? numVars++ : -1;
+        }
+    }
+    numVars = numberSegments(boxSize, varOf, segOf, numVars);
+
+    bool solved = false;
+    if(initSolver(&s, numVars, stats)){
+        stats->variables = numVars;
+        solved = encodeGrid(&s, boxSize, values, varOf) &&
+                 encodeSegments(&s, boxSize, varOf, segOf) && search(&s);
+    }
+    if(solved){
+        for(int i = 0; i < cells; i++){
+            solution[i] = values[i];
+            for(int d = 0; d < side && solution[i] == 0; d++){
+                int var = varOf[i * side + d];
+                if(var >= 0 && s.assign[var] == 1){
+                    solution[i] = d + 1;
+                }
+            }
+        }
+    }
+    freeSolver(&s);
+    free(varOf);
+    free(segOf);
+    return solved;
+}
+
+/**
+ * Solves the puzzle given as 81 cell values with the SAT solver, like
+ * solveValues. The statistics are mapped onto SolverStats with a decision
+ * counted as a node and a decision or conflict as a guess.
+ */
+bool solveValuesSat(const uint8_t *values, uint8_t *solution,
+                    SolverStats *stats)
+{
+    SatStats satStats = {0}; //Not written if the values are NULL
+    bool solved = satSolveGrid(3, values, solution, &satStats);
+    if(stats != NULL){
+        memset(stats, 0, sizeof(SolverStats));
+        stats->nodes = satStats.decisions;
+        stats->guesses = satStats.decisions + satStats.conflicts;
+    }
+    return solved;
+}
+
+/**
+ * Adds the clauses of the grid to the solver: every empty cell takes exactly
+ * one of its candidates and every unit has exactly one place for each digit
+ * it is missing. Returns false if the clues already leave a cell or a digit
+ * in some unit without a place, or the solver ran out of memory.
+ */
+static bool encodeGrid(SatSolver *s, int boxSize, const uint8_t *values,
+                       int *varOf)
+{
+    int side = boxSize * boxSize;
+    int vars[SAT_MAX_BOX * SAT_MAX_BOX];
+    int cells[SAT_MAX_BOX * SAT_MAX_BOX];
+    for(int i = 0; i < side * side; i++){
+        int count = 0;
+        for(int d = 0; d < side; d++){
+            if(varOf[i * side + d] >= 0){
+                vars[count++] = varOf[i * side + d];
+            }
+        }
+        if(values[i] == 0 && !addExactlyOne(s, vars, count, true, NULL, 0)){
+            return false;
+        }
+    }
+
+    //Units 0 to side - 1 are the rows, then the columns, then the boxes
+    for(int unit = 0; unit < 3 * side; unit++){
+        for(int d = 0; d < side; d++){
+            int count = 0;
+            bool placed = false;
+            for(int k = 0; k < side; k++){
+                int cell = unitCellOf(boxSize, unit, k);
+                placed |= values[cell] == d + 1;
+                if(varOf[cell * side + d] >= 0){
+                    cells[count] = cell;
+                    vars[count++] = varOf[cell * side + d];
+                }
+            }
+            //Pairs in a box that share a row or column are already excluded
+            if(!placed && !addExactlyOne(s, vars, count, unit < 2 * side,
+                                         unit < 2 * side ? NULL : cells,
+                                         side)){
+                return false;
+            }
+        }
+    }
+    return !s->outOfMemory;
+}
+
+/**
+ * Returns the index'th cell of the given unit in a grid with the given box
+ * size, with units numbered as in encodeGrid.
+ */
+static int unitCellOf(int boxSize, int unit, int index)
+{
+    int side = boxSize * boxSize;
+    if(unit < side){
+        return unit * side + index;
+    }
+    if(unit < 2 * side){
+        return index * side + unit - side;
+    }
+    int box = unit - 2 * side;
+    int row = (box / boxSize) * boxSize + index / boxSize;
+    int col = (box % boxSize) * boxSize + index % boxSize;
+    return row * side + col;
+}
+
+/**
+ * Numbers the segment variables after the `numVars` candidate variables and
+ * returns the new total. Segment (dir, line, box) of digit d is at index
+ * ((dir * side + line) * boxSize + box) * side + d of `segOf`, where dir is 0
+ * for a row and 1 for a column and box counts the boxes the line crosses;
+ * it is -1 if none of the segment's cells has the digit as a candidate.
+ */
+static int numberSegments(int boxSize, const int *varOf, int *segOf,
+                          int numVars)
+{
+    int side = boxSize * boxSize;
+    int seg = 0;
+    for(int dir = 0; dir < 2; dir++){
+        for(int line = 0; line < side; line++){
+            for(int box = 0; box < boxSize; box++){
+                for(int d = 0; d < side; d++, seg++){
+                    segOf[seg] = -1;
+                    for(int k = 0; k < boxSize && segOf[seg] < 0; k++){
+                        int cell = segmentCell(boxSize, dir, line, box, k);
+                        if(varOf[cell * side + d] >= 0){
+                            segOf[seg] = numVars++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return numVars;
+}
+
+/**
+ * Adds the clauses of the segments: a segment variable is true exactly when
+ * one of its cells takes the digit, each line has the digit in exactly one
+ * of its segments, and each box has it in exactly one of the segments of
+ * the rows (and of the columns) crossing it. Returns false if the formula
+ * became unsatisfiable or the solver ran out of memory.
+ */
+static bool encodeSegments(SatSolver *s, int boxSize, const int *varOf,
+                           const int *segOf)
+{
+    int side = boxSize * boxSize;
+    int clause[SAT_MAX_BOX + 1];
+    int vars[SAT_MAX_BOX];
+    for(int dir = 0; dir < 2; dir++){
+        for(int line = 0; line < side; line++){
+            for(int box = 0; box < boxSize; box++){
+                for(int d = 0; d < side; d++){
+                    int seg = segOf[((dir * side + line) * boxSize + box) *
+                                    side + d];
+                    if(seg < 0){
+                        continue;
+                    }
+                    int size = 0;
+                    clause[size++] = LIT(seg, 1);
+                    for(int k = 0; k < boxSize; k++){
+                        int cell = segmentCell(boxSize, dir, line, box, k);
+                        int var = varOf[cell * side + d];
+                        if(var < 0){
+                            continue;
+                        }
+                        int pair[2] = {LIT(var, 1), LIT(seg, 0)};
+                        clause[size++] = LIT(var, 0);
+                        if(!addClause(s, pair, 2)){
+                            return false;
+                        }
+                        s->stats->clauses++;
+                    }
+                    if(!addClause(s, clause, size)){
+                        return false;
+                    }
+                    s->stats->clauses++;
+                }
+            }
+        }
+    }
+
+    //A digit a line or box already has leaves it no segments there
+    for(int dir = 0; dir < 2; dir++){
+        for(int d = 0; d < side; d++){
+            for(int line = 0; line < side; line++){
+                int count = 0;
+                for(int box = 0; box < boxSize; box++){
+                    int seg = segOf[((dir * side + line) * boxSize + box) *
+                                    side + d];
+                    if(seg >= 0){
+                        vars[count++] = seg;
+                    }
+                }
+                if(count > 0 && !addExactlyOne(s, vars, count, true, NULL, 0)){
+                    return false;
+                }
+            }
+            for(int band = 0; band < boxSize; band++){
+                for(int box = 0; box < boxSize; box++){
+                    int count = 0;
+                    for(int k = 0; k < boxSize; k++){
+                        int line = band * boxSize + k;
+                        int seg = segOf[((dir * side + line) * boxSize + box) *
+                                        side + d];
+                        if(seg >= 0){
+                            vars[count++] = seg;
+                        }
+                    }
+                    if(count > 0 &&
+                       !addExactlyOne(s, vars, count, true, NULL, 0)){
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return !s->outOfMemory;
+}
+
+/**
+ * Returns the index'th cell of a segment, the `boxSize` cells where row
+ * (dir 0) or column (dir 1) `line` crosses the box'th box along it.
+ */
+static int segmentCell(int boxSize, int dir, int line, int box, int index)
+{
+    int side = boxSize * boxSize;
+    int pos = box * boxSize + index;
+    return dir == 0 ? line * side + pos : pos * side + line;
+}
+
+/**
+ * Adds the clauses making exactly one of the `count` variables true: one
+ * clause with all of them and one excluding each pair. If `pairs` is false
+ * the pairs whose `cells` share a row or column of a grid `side` cells wide
+ * are left out. Returns false if the formula became unsatisfiable.
+ */
+static bool addExactlyOne(SatSolver *s, const int *vars, int count,
+                          bool pairs, const int *cells, int side)
+{
+    int clause[SAT_MAX_BOX * SAT_MAX_BOX];
+    for(int k = 0; k < count; k++){
+        clause[k] = LIT(vars[k], 0);
+    }
+    if(!addClause(s, clause, count)){
+        return false;
+    }
+    s->stats->clauses++;
+    for(int a = 0; a < count; a++){
+        for(int b = a + 1; b < count; b++){
+            if(!pairs && (cells[a] / side == cells[b] / side ||
+                          cells[a] % side == cells[b] % side)){
+                continue;
+            }
+            int pair[2] = {LIT(vars[a], 1), LIT(vars[b], 1)};
+            if(!addClause(s, pair, 2)){
+                return false;
+            }
+            s->stats->clauses++;
+        }
+    }
+    return true;
+}
+
+/**
+ * Sets up a solver with no clauses for `numVars` variables. Returns false
+ * (with everything freed) if the memory could not be allocated.
+ */
+static bool initSolver(SatSolver *s, int numVars, SatStats *stats)
+{
+    memset(s, 0, sizeof(SatSolver));
+    s->numVars = numVars;
+    s->stats = stats;
+    s->varInc = 1;
+    s->reduceLimit = SAT_REDUCE_BASE;
+    size_t n = numVars > 0 ? numVars : 1;
+    s->watches = calloc(2 * n, sizeof(IntVec));
+    s->binWatches = calloc(2 * n, sizeof(IntVec));
+    s->assign = malloc(n);
+    s->level = malloc(n * sizeof(int));
+    s->reason = malloc(n * sizeof(int));
+    s->seen = calloc(n, 1);
+    s->activity = calloc(n, sizeof(double));
+    s->heap = malloc(n * sizeof(int));
+    s->heapPos = malloc(n * sizeof(int));
+    s->trail = malloc(n * sizeof(int));
+    s->levelStamp = calloc(n + 1, sizeof(int)); //Levels go up to numVars
+    if(s->watches == NULL || s->binWatches == NULL || s->assign == NULL ||
+       s->level == NULL || s->reason == NULL || s->seen == NULL ||
+       s->activity == NULL || s->heap == NULL || s->heapPos == NULL ||
+       s->trail == NULL || s->levelStamp == NULL){
+        freeSolver(s);
+        return false;
+    }
+    memset(s->assign, -1, n);
+    for(int v = 0; v < numVars; v++){
+        s->reason[v] = NO_REASON;
+        s->heapPos[v] = -1;
+        heapInsert(s, v);
+    }
+    return true;
+}
+
+/**
+ * Frees everything a solver holds. Safe on a solver initSolver gave up on.
+ */
+static void freeSolver(SatSolver *s)
+{
+    for(int l = 0; l < 2 * s->numVars; l++){
+        if(s->watches != NULL){
+            free(s->watches[l].data);
+        }
+        if(s->binWatches != NULL){
+            free(s->binWatches[l].data);
+        }
+    }
+    free(s->watches);
+    free(s->binWatches);
+    free(s->assign);
+    free(s->level);
+    free(s->reason);
+    free(s->seen);
+    free(s->activity);
+    free(s->heap);
+    free(s->heapPos);
+    free(s->trail);
+    free(s->levelStamp);
+    free(s->lits.data);
+    free(s->starts.data);
+    free(s->sizes.data);
+    free(s->glue.data);
+    free(s->trailLim.data);
+    free(s->learnt.data);
+    free(s->marked.data);
+    free(s->pending.data);
+    memset(s, 0, sizeof(SatSolver));
+}
+
+/**
+ * Appends a value to a vector, growing it as needed. If the memory runs out
+ * the value is dropped and the solver marked as out of memory.
+ */
+static void pushInt(SatSolver *s, IntVec *vec, int value)
+{
+    if(vec->len == vec->cap){
+        int cap = vec->cap > 0 ? 2 * vec->cap : 4;
+        int *bigger = realloc(vec->data, cap * sizeof(int));
+        if(bigger == NULL){
+            s->outOfMemory = true;
+            return;
+        }
+        vec->data = bigger;
+        vec->cap = cap;
+    }
+    vec->data[vec->len++] = value;
+}
+
+/**
+ * Returns 1 if the literal is true, 0 if it is false and -1 if its variable
+ * has no value yet.
+ */
+static int valueOf(const SatSolver *s, int lit)
+{
+    int value = s->assign[VAROF(lit)];
+    return value < 0 ? -1 : value ^ (lit & 1);
+}
+
+/**
+ * Adds a clause of `size` literals at decision level 0. A clause of one
+ * literal is not stored, the literal is simply made true. Returns false if
+ * the clause is empty or its single literal is already false.
+ */
+static bool addClause(SatSolver *s, const int *lits, int size)
+{
+    if(size == 0){
+        return false;
+    }
+    if(size == 1){
+        if(valueOf(s, lits[0]) == 0){
+            return false;
+        }
+        if(valueOf(s, lits[0]) < 0){
+            enqueue(s, lits[0], NO_REASON);
+        }
+        return true;
+    }
+    int clause = s->starts.len;
+    pushInt(s, &s->starts, s->lits.len);
+    pushInt(s, &s->sizes, size);
+    pushInt(s, &s->glue, 0);
+    for(int k = 0; k < size; k++){
+        pushInt(s, &s->lits, lits[k]);
+    }
+    watchClause(s, lits[0], clause, lits[1]);
+    watchClause(s, lits[1], clause, lits[0]);
+    return true;
+}
+
+/**
+ * Adds the clause to the watch list of the literal, with `blocker` as the
+ * literal checked before the clause is read.
+ */
+static void watchClause(SatSolver *s, int lit, int clause, int blocker)
+{
+    IntVec *list = s->sizes.data[clause] == 2 ? &s->binWatches[lit] :
+                                                &s->watches[lit];
+    pushInt(s, list, clause);
+    pushInt(s, list, blocker);
+}
+
+/**
+ * Makes the literal true at the current decision level, implied by the
+ * clause `reason` (NO_REASON for a decision).
+ */
+static void enqueue(SatSolver *s, int lit, int reason)
+{
+    int var = VAROF(lit);
+    s->assign[var] = !(lit & 1);
+    s->level[var] = s->trailLim.len;
+    s->reason[var] = reason;
+    s->trail[s->trailLen++] = lit;
+}
+
+/**
+ * Propagates every literal on the trail not yet propagated. Each clause
+ * watching a literal that became false either has a true blocker, finds
+ * another literal to watch that is not false, is already true through its
+ * other watch, implies its other watch, or is false. Returns the first false
+ * clause found, or NO_REASON if there was none.
+ */
+static int propagate(SatSolver *s)
+{
+    while(s->qhead < s->trailLen){
+        int falseLit = NEGATE(s->trail[s->qhead++]);
+        IntVec *pairs = &s->binWatches[falseLit];
+        s->stats->propagations++;
+        for(int w = 0; w < pairs->len; w += 2){
+            int other = pairs->data[w + 1];
+            int value = valueOf(s, other);
+            if(value == 1){
+                continue;
+            }
+            int clause = pairs->data[w];
+            if(value == 0){
+                return clause;
+            }
+            int *lits = s->lits.data + s->starts.data[clause];
+            lits[0] = other;
+            lits[1] = falseLit;
+            enqueue(s, other, clause);
+        }
+
+        IntVec *list = &s->watches[falseLit];
+        int kept = 0;
+        for(int w = 0; w < list->len; w += 2){
+            int clause = list->data[w];
+            int blocker = list->data[w + 1];
+            if(valueOf(s, blocker) == 1){
+                list->data[kept++] = clause;
+                list->data[kept++] = blocker;
+                continue;
+            }
+            int *lits = s->lits.data + s->starts.data[clause];
+            int size = s->sizes.data[clause];
+            if(lits[0] == falseLit){
+                lits[0] = lits[1];
+                lits[1] = falseLit;
+            }
+            int first = lits[0];
+            if(first != blocker && valueOf(s, first) == 1){
+                list->data[kept++] = clause;
+                list->data[kept++] = first;
+                continue;
+            }
+
+            int k = 2;
+            while(k < size && valueOf(s, lits[k]) == 0){
+                k++;
+            }
+            if(k < size){
+                lits[1] = lits[k];
+                lits[k] = falseLit;
+                watchClause(s, lits[1], clause, first);
+                continue;
+            }
+
+            list->data[kept++] = clause;
+            list->data[kept++] = first;
+            if(valueOf(s, first) == 0){
+                for(w += 2; w < list->len; w++){
+                    list->data[kept++] = list->data[w];
+                }
+                list->len = kept;
+                return clause;
+            }
+            enqueue(s, first, clause);
+        }
+        list->len = kept;
+    }
+    return NO_REASON;
+}
+
+/**
+ * Learns a clause from the false clause `conflict`: starting from it, the
+ * literals set at the current level are resolved away with the clauses that
+ * implied them (latest first) until one is left, the first unique implication
+ * point. The learned clause ends up in s->learnt with the negation of that
+ * literal first and a literal of the highest remaining level second. Returns
+ * the level to jump back to, where the clause implies its first literal.
+ * The glue of every learned clause resolved on is lowered if it has become
+ * smaller.
+ *
+ * The clause is then minimised: a literal is left out when the clauses that
+ * implied it lead back only to other literals of the clause (see redundant),
+ * which makes learned clauses on large grids markedly shorter.
+ */
+static int analyze(SatSolver *s, int conflict)
+{
+    int current = s->trailLim.len;
+    int pending = 0; //Literals of the current level still to resolve
+    int lit = -1;
+    int index = s->trailLen - 1;
+    s->learnt.len = 0;
+    pushInt(s, &s->learnt, -1); //Room for the asserting literal
+    do{
+        int *lits = s->lits.data + s->starts.data[conflict];
+        int size = s->sizes.data[conflict];
+        if(s->glue.data[conflict] > SAT_GLUE_KEEP){
+            int glue = clauseGlue(s, lits, size);
+            if(glue < s->glue.data[conflict]){
+                s->glue.data[conflict] = glue;
+            }
+        }
+        for(int k = lit < 0 ? 0 : 1; k < size; k++){
+            int var = VAROF(lits[k]);
+            if(!s->seen[var] && s->level[var] > 0){
+                bumpVar(s, var);
+                s->seen[var] = 1;
+                if(s->level[var] == current){
+                    pending++;
+                }
+                else{
+                    pushInt(s, &s->learnt, lits[k]);
+                }
+            }
+        }
+        while(!s->seen[VAROF(s->trail[index])]){
+            index--;
+        }
+        lit = s->trail[index--];
+        conflict = s->reason[VAROF(lit)];
+        s->seen[VAROF(lit)] = 0;
+        pending--;
+    }while(pending > 0);
+    s->learnt.data[0] = NEGATE(lit);
+
+    uint32_t levels = 0; //The levels of the clause, hashed down to 32 bits
+    s->marked.len = 0;
+    for(int k = 1; k < s->learnt.len; k++){
+        int var = VAROF(s->learnt.data[k]);
+        levels |= 1u << (s->level[var] & 31);
+        pushInt(s, &s->marked, var);
+    }
+    int size = 1;
+    for(int k = 1; k < s->learnt.len; k++){
+        int other = s->learnt.data[k];
+        if(s->reason[VAROF(other)] == NO_REASON ||
+           !redundant(s, other, levels)){
+            s->learnt.data[size++] = other;
+        }
+    }
+    s->learnt.len = size;
+    for(int k = 0; k < s->marked.len; k++){
+        s->seen[s->marked.data[k]] = 0;
+    }
+
+    int back = 0;
+    int highest = 1; //Where the literal of level `back` is
+    for(int k = 1; k < s->learnt.len; k++){
+        int var = VAROF(s->learnt.data[k]);
+        if(s->level[var] > back){
+            back = s->level[var];
+            highest = k;
+        }
+    }
+    if(s->learnt.len > 1){
+        int swap = s->learnt.data[1];
+        s->learnt.data[1] = s->learnt.data[highest];
+        s->learnt.data[highest] = swap;
+    }
+    return back;
+}
+
+/**
+ * Returns true if the false literal `lit` of the clause being learned
+ * follows from its other literals: every path back through the clauses that
+ * implied it ends at a literal already marked in `seen`. Literals found to
+ * follow are marked too so later checks stop at them. A path reaching a
+ * decision, or a level that is not among `levels` (so cannot be in the
+ * clause), gives up at once.
+ */
+static bool redundant(SatSolver *s, int lit, uint32_t levels)
+{
+    int top = s->marked.len;
+    s->pending.len = 0;
+    pushInt(s, &s->pending, lit);
+    while(s->pending.len > 0){
+        int next = s->pending.data[--s->pending.len];
+        int clause = s->reason[VAROF(next)];
+        const int *lits = s->lits.data + s->starts.data[clause];
+        int size = s->sizes.data[clause];
+        for(int k = 1; k < size; k++){
+            int var = VAROF(lits[k]);
+            if(s->seen[var] || s->level[var] == 0){
+                continue;
+            }
+            if(s->reason[var] == NO_REASON ||
+               !(levels & (1u << (s->level[var] & 31)))){
+                for(int m = top; m < s->marked.len; m++){
+                    s->seen[s->marked.data[m]] = 0;
+                }
+                s->marked.len = top;
+                return false;
+            }
+            s->seen[var] = 1;
+            pushInt(s, &s->marked, var);
+            pushInt(s, &s->pending, lits[k]);
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the glue of the clause: the number of different decision levels
+ * among its literals, all of which must have a value.
+ */
+static int clauseGlue(SatSolver *s, const int *lits, int size)
+{
+    int glue = 0;
+    s->stamp++;
+    for(int k = 0; k < size; k++){
+        int level = s->level[VAROF(lits[k])];
+        if(s->levelStamp[level] != s->stamp){
+            s->levelStamp[level] = s->stamp;
+            glue++;
+        }
+    }
+    return glue;
+}
+
+/**
+ * Returns true if the clause is the reason its first literal is true, so it
+ * cannot be deleted.
+ */
+static bool clauseLocked(const SatSolver *s, int clause)
+{
+    int first = s->lits.data[s->starts.data[clause]];
+    return s->reason[VAROF(first)] == clause && valueOf(s, first) == 1;
+}
+
+/**
+ * Deletes the half of the learned clauses with the most glue (the older ones
+ * first among equal glue), leaving those of glue SAT_GLUE_KEEP or less and
+ * the locked ones. The clauses left are moved down over the deleted ones,
+ * and the watch lists and reasons follow them to their new indexes. Marks
+ * the solver as out of memory if the scratch arrays could not be allocated.
+ */
+static void reduceLearnts(SatSolver *s)
+{
+    int numClauses = s->starts.len;
+    LearntRank *ranks = malloc(s->numLearnts * sizeof(LearntRank));
+    int *moved = malloc(numClauses * sizeof(int)); //New index of each clause
+    if(ranks == NULL || moved == NULL){
+        free(ranks);
+        free(moved);
+        s->outOfMemory = true;
+        return;
+    }
+    int count = 0;
+    for(int c = 0; c < numClauses; c++){
+        if(s->glue.data[c] > 0){
+            ranks[count].glue = s->glue.data[c];
+            ranks[count++].clause = c;
+        }
+    }
+    qsort(ranks, count, sizeof(LearntRank), compareRanks);
+    int deleted = 0;
+    for(int k = 0; k < count && deleted < count / 2 &&
+                   ranks[k].glue > SAT_GLUE_KEEP; k++){
+        if(!clauseLocked(s, ranks[k].clause)){
+            s->sizes.data[ranks[k].clause] = 0;
+            deleted++;
+        }
+    }
+
+    int kept = 0;
+    int end = 0; //Where the literals of the next clause kept go
+    for(int c = 0; c < numClauses; c++){
+        int size = s->sizes.data[c];
+        moved[c] = size > 0 ? kept : NO_REASON;
+        if(size == 0){
+            continue;
+        }
+        memmove(s->lits.data + end, s->lits.data + s->starts.data[c],
+                size * sizeof(int));
+        s->starts.data[kept] = end;
+        s->sizes.data[kept] = size;
+        s->glue.data[kept++] = s->glue.data[c];
+        end += size;
+    }
+    s->lits.len = end;
+    s->starts.len = kept;
+    s->sizes.len = kept;
+    s->glue.len = kept;
+
+    //Every clause is watched by its first two literals, which did not move
+    for(int l = 0; l < 2 * s->numVars; l++){
+        s->watches[l].len = 0;
+        s->binWatches[l].len = 0;
+    }
+    for(int c = 0; c < kept; c++){
+        const int *lits = s->lits.data + s->starts.data[c];
+        watchClause(s, lits[0], c, lits[1]);
+        watchClause(s, lits[1], c, lits[0]);
+    }
+    for(int k = 0; k < s->trailLen; k++){
+        int var = VAROF(s->trail[k]);
+        if(s->reason[var] != NO_REASON){
+            s->reason[var] = moved[s->reason[var]];
+        }
+    }
+    s->numLearnts -= deleted;
+    s->reduceLimit += SAT_REDUCE_STEP;
+    s->stats->reductions++;
+    s->stats->deleted += deleted;
+    free(ranks);
+    free(moved);
+}
+
+/**
+ * Orders learned clauses by glue, most first, and then by age, oldest first.
+ */
+static int compareRanks(const void *a, const void *b)
+{
+    const LearntRank *x = a;
+    const LearntRank *y = b;
+    if(x->glue != y->glue){
+        return y->glue - x->glue;
+    }
+    return x->clause - y->clause;
+}
+
+/**
+ * Takes back every value given above decision level `level`.
+ */
+static void cancelUntil(SatSolver *s, int level)
+{
+    if(s->trailLim.len <= level){
+        return;
+    }
+    int keep = s->trailLim.data[level];
+    for(int k = s->trailLen - 1; k >= keep; k--){
+        int var = VAROF(s->trail[k]);
+        s->assign[var] = -1;
+        s->reason[var] = NO_REASON;
+        if(s->heapPos[var] < 0){
+            heapInsert(s, var);
+        }
+    }
+    s->trailLen = keep;
+    s->qhead = keep;
+    s->trailLim.len = level;
+}
+
+/**
+ * Runs the CDCL loop: propagate, and on a conflict learn a clause and jump
+ * back, otherwise make the most active variable without a value true.
+ * Restarts (keeping what was learned) whenever the conflicts since the last
+ * restart reach SAT_RESTART_BASE times the next term of the Luby sequence,
+ * and cuts the learned clauses back whenever they reach the limit.
+ * Returns true if every variable got a value without a conflict.
+ */
+static bool search(SatSolver *s)
+{
+    long restartLimit = SAT_RESTART_BASE * luby(0);
+    long sinceRestart = 0;
+    for(;;){
+        int conflict = propagate(s);
+        if(s->outOfMemory){
+            return false;
+        }
+        if(conflict != NO_REASON){
+            s->stats->conflicts++;
+            if(s->trailLim.len == 0){
+                return false;
+            }
+            int back = analyze(s, conflict);
+            int size = s->learnt.len;
+            int glue = clauseGlue(s, s->learnt.data, size);
+            cancelUntil(s, back);
+            int clause = size > 1 ? s->starts.len : NO_REASON;
+            if(size > 1){
+                addClause(s, s->learnt.data, size);
+                if(s->outOfMemory){
+                    return false;
+                }
+                s->glue.data[clause] = glue;
+                s->numLearnts++;
+            }
+            enqueue(s, s->learnt.data[0], clause);
+            s->varInc /= SAT_VAR_DECAY;
+            if(s->numLearnts >= s->reduceLimit){
+                reduceLearnts(s);
+                if(s->outOfMemory){
+                    return false;
+                }
+            }
+
+            if(++sinceRestart >= restartLimit){
+                cancelUntil(s, 0);
+                s->stats->restarts++;
+                sinceRestart = 0;
+                restartLimit = SAT_RESTART_BASE * luby(s->stats->restarts);
+            }
+            continue;
+        }
+
+        int var = -1;
+        while(s->heapLen > 0 && var < 0){
+            var = heapPop(s);
+            if(s->assign[var] >= 0){
+                var = -1;
+            }
+        }
+        if(var < 0){
+            return true;
+        }
+        s->stats->decisions++;
+        pushInt(s, &s->trailLim, s->trailLen);
+        enqueue(s, LIT(var, 0), NO_REASON);
+    }
+}
+
+/**
+ * Returns term `index` (from 0) of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ...
+ */
+static long luby(long index)
+{
+    long size = 1;
+    int power = 0;
+    while(size < index + 1){
+        power++;
+        size = 2 * size + 1;
+    }
+    while(size - 1 != index){
+        size = (size - 1) / 2;
+        power--;
+        index %= size;
+    }
+    return 1L << power;
+}
+
+/**
+ * Raises the activity of a variable that took part in a conflict, scaling
+ * every activity down if they grow too large.
+ */
+static void bumpVar(SatSolver *s, int var)
+{
+    s->activity[var] += s->varInc;
+    if(s->activity[var] > ACTIVITY_LIMIT){
+        for(int v = 0; v < s->numVars; v++){
+            s->activity[v] /= ACTIVITY_LIMIT;
+        }
+        s->varInc /= ACTIVITY_LIMIT;
+    }
+    if(s->heapPos[var] >= 0){
+        heapUp(s, s->heapPos[var]);
+    }
+}
+
+/**
+ * Adds a variable to the activity heap.
+ */
+static void heapInsert(SatSolver *s, int var)
+{
+    s->heap[s->heapLen] = var;
+    s->heapPos[var] = s->heapLen;
+    heapUp(s, s->heapLen++);
+}
+
+/**
+ * Moves the variable at `index` of the heap up past less active ones.
+ */
+static void heapUp(SatSolver *s, int index)
+{
+    int var = s->heap[index];
+    while(index > 0){
+        int parent = (index - 1) / 2;
+        if(s->activity[s->heap[parent]] >= s->activity[var]){
+            break;
+        }
+        s->heap[index] = s->heap[parent];
+        s->heapPos[s->heap[index]] = index;
+        index = parent;
+    }
+    s->heap[index] = var;
+    s->heapPos[var] = index;
+}
+
+/**
+ * Removes and returns the most active variable in the heap, which must not
+ * be empty.
+ */
+static int heapPop(SatSolver *s)
+{
+    int top = s->heap[0];
+    int var = s->heap[--s->heapLen];
+    s->heapPos[top] = -1;
+    int index = 0;
+    if(s->heapLen == 0){
+        return top;
+    }
+    for(;;){
+        int child = 2 * index + 1;
+        if(child >= s->heapLen){
+            break;
+        }
+        if(child + 1 < s->heapLen &&
+           s->activity[s->heap[child + 1]] > s->activity[s->heap[child]]){
+            child++;
+        }
+        if(s->activity[s->heap[child]] <= s->activity[var]){
+            break;
+        }
+        s->heap[index] = s->heap[child];
+        s->heapPos[s->heap[index]] = index;
+        index = child;
+    }
+    s->heap[index] = var;
+    s->heapPos[var] = index;
+    return top;
+}
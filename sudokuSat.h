@@ -0,0 +1,100 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a sudoku solver that turns the puzzle into a boolean formula in
+ * conjunctive normal form and solves that with a built in conflict driven
+ * clause learning (CDCL) SAT solver. It works for any box size from
+ * SAT_MIN_BOX to SAT_MAX_BOX (4x4 up to 36x36 grids), not only 9x9.
+ *
+ * The encoding is the compact one: there is only a variable for each digit
+ * that is still a candidate of an empty cell once the clues are placed, and
+ * the clauses say that every empty cell takes exactly one of its candidates
+ * and every unit has exactly one cell for each digit it is missing. Cells and
+ * digits the clues settle never reach the formula at all. On top of that
+ * there is a variable for each segment (the boxSize cells where a row or
+ * column crosses a box) and each digit it can still hold, true when one of
+ * its cells takes the digit; every line and every box has each digit it is
+ * missing in exactly one of its segments. These clauses add nothing the
+ * others do not imply, but they let propagation see pointing and claiming
+ * (a digit of a box confined to one line, or of a line to one box) without
+ * a conflict having to teach it each time.
+ *
+ * The SAT solver is the usual design: two watched literals per clause for
+ * unit propagation, first UIP conflict analysis learning one clause per
+ * conflict, VSIDS to pick the next variable (a heap ordered by activity that
+ * is bumped for every variable in a conflict and decays over time), and
+ * restarts following the Luby sequence. Unlike chronological backtracking it
+ * can jump back over many guesses at once and never repeats a conflict it
+ * has learned from, which is what makes it hold up on large and very hard
+ * boards. A decision always makes its variable true: that places a digit,
+ * which the exactly-one clauses propagate across the cell and its units,
+ * where making it false would only strike out one candidate. The restarts
+ * come often, SAT_RESTART_BASE conflicts times the Luby term, since large
+ * grids near the hardest fill tend to get stuck on a bad early decision that
+ * only a restart takes back.
+ *
+ * Large grids near the hardest fill need tens of thousands of conflicts, and
+ * every learned clause kept makes propagation slower, so the learned clauses
+ * are cut back from time to time. Each one is rated by its glue (the number
+ * of decision levels among its literals when it was learned, lowered when a
+ * later conflict finds it smaller), since clauses tying together few
+ * decisions are the ones that keep propagating. Once SAT_REDUCE_BASE learned
+ * clauses have piled up the half with the most glue is deleted, except the
+ * ones of glue SAT_GLUE_KEEP or less and the ones still implying a literal,
+ * and every reduction lets SAT_REDUCE_STEP more pile up before the next.
+ */
+#ifndef SUDOKU_SAT_H
+#define SUDOKU_SAT_H
+
+#include "./sudokuSolver.h"
+
+#define SAT_MIN_BOX 2 //Smallest box size accepted (a 4x4 grid)
+#define SAT_MAX_BOX 6 //Largest box size accepted (a 36x36 grid)
+#define SAT_RESTART_BASE 32  //Conflicts per restart, times the Luby sequence
+#define SAT_VAR_DECAY 0.95   //Factor the activity of all variables decays by
+#define SAT_REDUCE_BASE 2000 //Learned clauses kept before the first reduction
+#define SAT_REDUCE_STEP 300  //More learned clauses kept after each reduction
+#define SAT_GLUE_KEEP 2      //Learned clauses of this glue or less are kept
+
+typedef struct satStats{
+    int variables;              //Variables in the encoding
+    int clauses;                //Clauses in the encoding, before learning
+    unsigned long decisions;    //Variables given a value by choice
+    unsigned long conflicts;    //Clauses found false, one learned for each
+    unsigned long propagations; //Literals propagated
+    unsigned long restarts;
+    unsigned long reductions;   //Times the learned clauses were cut back
+    unsigned long deleted;      //Learned clauses deleted by those
+}SatStats;
+
+/********* function prototypes *********/
+
+bool satSolveGrid(int boxSize, const uint8_t *values, uint8_t *solution,
+                  SatStats *stats);
+bool solveValuesSat(const uint8_t *values, uint8_t *solution,
+                    SolverStats *stats);
+
+/**
+ * Solves a grid with boxes of `boxSize` by `boxSize` cells, so boxSize^2 rows
+ * of boxSize^2 cells given row by row in `values` (0 for an empty cell, the
+ * digits are 1 to boxSize^2). On success the solution is written to
+ * `solution` in the same form and true is returned.
+ *
+ * This function will return false if either array is NULL, the box size is
+ * out of range, the values are not legal, the puzzle has no solution or the
+ * formula could not be allocated. If `stats` is not NULL the statistics of
+ * the solve are written to it.
+ */
+bool satSolveGrid(int boxSize, const uint8_t *values, uint8_t *solution,
+                  SatStats *stats);
+
+/**
+ * Solves the puzzle given as 81 cell values with the SAT solver, like
+ * solveValues. The statistics are mapped onto SolverStats with a decision
+ * counted as a node and a decision or conflict as a guess.
+ */
+bool solveValuesSat(const uint8_t *values, uint8_t *solution,
+                    SolverStats *stats);
+
+#endif
@@ -0,0 +1,970 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a backtracking sudoku solver on top of the sudokuBoard module.
+ * Internally the solver does not work on the 'Cell' grid directly. Instead a
+ * puzzle is loaded into a compact state made of the 81 cell values plus one
+ * bitmask per row, column and square recording which digits are already
+ * placed (bit d-1 is set if digit d is used). The candidates of an empty cell
+ * are then simply the digits missing from all three of its masks.
+ *
+ * The search always branches on the empty cell with the fewest candidates so
+ * cells that are forced (only one candidate) are filled without any guessing.
+ *
+ * The state also carries a Zobrist hash of the problem that is left to solve
+ * so the transposition table used when counting can be probed in O(1). The
+ * solutions below a state only depend on which cells are still empty and on
+ * which digits each row, column and square already has, not on where exactly
+ * those digits were placed. So rather than hashing the values themselves a
+ * placement XORs in one key for the cell becoming filled and one for the
+ * digit becoming used in each of its three units. Partial boards that differ
+ * only by digits swapped around within their units then share an entry,
+ * which is what gives the table hits within a single search (two different
+ * paths of the search never reach exactly the same values). The hash does
+ * not cover the digits eliminated from each cell, which is fine since only
+ * states loaded from values, where nothing is eliminated, are ever counted
+ * with a table.
+ *
+ * Before searching, every entry point runs a propagation pass that fills all
+ * naked and hidden singles and checks each unit still has a place for every
+ * digit it is missing. Clues that contradict each other without repeating a
+ * digit (say a row where two digits can only go in the same cell) would
+ * otherwise only be found at the bottom of a search that can take seconds,
+ * while the pass finds them in microseconds.
+ *
+ * The pass, the choice of cell and the search that runs the pass on every
+ * node work through a UnitGraph and know nothing else about the grid, so
+ * the other solvers reuse them on their own units. Neither keeps the hash,
+ * which is worked out again from the values once the pass has run on a
+ * state that is going to be counted.
+ */
+#include <threads.h>
+#include "./sudokuSolver.h"
+
+#define ROWOF(i) ((i) / BOARDSIZE)
+#define COLOF(i) ((i) % BOARDSIZE)
+#define BOXOF(i) ((ROWOF(i) / 3) * 3 + COLOF(i) / 3)
+#define UNITKEY(unit, digit) ((unit) * BOARDSIZE + (digit) - 1)
+
+typedef struct solverState{
+    uint8_t values[NUMCELLS];  //0 if the cell is empty
+    uint16_t allowed[NUMCELLS]; //Digits not eliminated from each cell
+    uint16_t used[3 * BOARDSIZE]; //digits placed in each row, column and
+                                  //square (the units of gridUnits)
+    uint64_t hash;             //Zobrist hash of the problem left to solve
+}SolverState;
+
+static uint64_t filledKeys[NUMCELLS];  //Keys of a cell becoming filled
+static uint64_t rowKeys[NUMCELLS];     //Keys of a digit used in a row,
+static uint64_t colKeys[NUMCELLS];     //column or square (see UNITKEY)
+static uint64_t boxKeys[NUMCELLS];
+static once_flag keysOnce = ONCE_FLAG_INIT;
+static UnitGraph grid;                 //Units of one 9x9 grid
+static once_flag gridOnce = ONCE_FLAG_INIT;
+
+/********* function prototypes *********/
+
+bool solveBoard(Cell **board, SolverStats *stats);
+bool solveString(const char *clues, char *solution, SolverStats *stats);
+bool solveValues(const uint8_t *values, uint8_t *solution, SolverStats *stats);
+bool solveValuesPropagate(const uint8_t *values, uint8_t *solution,
+                          SolverStats *stats);
+int propagateValues(const uint8_t *values, uint8_t *result);
+bool checkValues(const uint8_t *values);
+bool parseCandidates(const char *text, uint16_t *cands);
+bool solveCandidates(const uint16_t *cands, uint8_t *solution,
+                     SolverStats *stats);
+long countSolutions(const char *clues, long limit, SolverStats *stats);
+TransTable *initTransTable(size_t budget);
+long countSolutionsTT(const char *clues, long limit, TransTable *table,
+                      SolverStats *stats);
+void deleteTransTable(TransTable *table);
+const UnitGraph *gridUnits(void);
+void initUnitGraph(UnitGraph *graph, int numCells);
+int addUnit(UnitGraph *graph, const int16_t *cells, int size);
+uint16_t unitCandidates(const UnitGraph *graph, const UnitView *view,
+                        int cell);
+bool placeUnitDigit(const UnitGraph *graph, const UnitView *view, int cell,
+                    int digit);
+void removeUnitDigit(const UnitGraph *graph, const UnitView *view, int cell);
+bool singlesPass(const UnitGraph *graph, const UnitView *view,
+                 bool *progress);
+bool propagateUnits(const UnitGraph *graph, const UnitView *view);
+int pickUnitCell(const UnitGraph *graph, const UnitView *view, int enough,
+                 uint16_t *cands);
+long searchUnits(const UnitGraph *graph, const UnitView *view, UnitPass *pass,
+                 const void *arg, long limit, SolverStats *stats);
+static bool loadString(SolverState *state, const char *clues);
+static bool loadBoard(SolverState *state, Cell **board);
+static bool loadValues(SolverState *state, const uint8_t *values);
+static bool loadCandidates(SolverState *state, const uint16_t *cands);
+static void clearState(SolverState *state);
+static bool placeDigit(SolverState *state, int cell, int digit);
+static void removeDigit(SolverState *state, int cell);
+static UnitView stateView(SolverState *state);
+static bool propagate(SolverState *state);
+static void fillCell(const UnitGraph *graph, const UnitView *view, int cell,
+                     int digit);
+static long searchNode(const UnitGraph *graph, const UnitView *view,
+                       UnitPass *pass, const void *arg, int depth, long limit,
+                       SolverStats *stats);
+static void initGrid(void);
+static void initKeys(void);
+static uint64_t placementKey(int cell, int digit);
+static long searchState(SolverState *state, long limit, TransTable *table,
+                        SolverStats *stats);
+
+/**
+ * Solves the given board in place. Every cell that is not a clue is filled
+ * using setCellVal. Returns true if a solution was found.
+ *
+ * This function will return false (and leave the board untouched) if the
+ * board is NULL, if the values on the board are not legal or if the puzzle
+ * has no solution. If `stats` is not NULL the search statistics are written
+ * to it.
+ */
+bool solveBoard(Cell **board, SolverStats *stats)
+{
+    SolverState state;
+    SolverStats local;
+    if(!loadBoard(&state, board)){
+        return false;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    if(!propagate(&state) || searchState(&state, 1, NULL, stats) != 1){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        setCellVal(board, ROWOF(i), COLOF(i), state.values[i]);
+    }
+    return true;
+}
+
+/**
+ * Solves the puzzle given by the string `clues`. This string must be 81
+ * characters long where each character is a digit and '0' or '.' represents
+ * an empty cell. On success the solution is written to `solution` as 81
+ * digits followed by a null terminator (so `solution` must be able to hold
+ * 82 chars) and true is returned.
+ *
+ * This function will return false if either string is NULL, the clues are
+ * malformed or not legal, or if the puzzle has no solution. If `stats` is
+ * not NULL the search statistics are written to it.
+ */
+bool solveString(const char *clues, char *solution, SolverStats *stats)
+{
+    SolverState state;
+    SolverStats local;
+    if(solution == NULL || !loadString(&state, clues)){
+        return false;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    if(!propagate(&state) || searchState(&state, 1, NULL, stats) != 1){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        solution[i] = '0' + state.values[i];
+    }
+    solution[NUMCELLS] = '\0';
+    return true;
+}
+
+/**
+ * Solves the puzzle given as 81 cell values (0 for an empty cell), the form
+ * the batch parser produces. On success the solution is written to
+ * `solution` as 81 values and true is returned.
+ *
+ * This function will return false if either array is NULL, the values are
+ * not legal, or if the puzzle has no solution. If `stats` is not NULL the
+ * search statistics are written to it.
+ */
+bool solveValues(const uint8_t *values, uint8_t *solution, SolverStats *stats)
+{
+    SolverState state;
+    SolverStats local;
+    if(solution == NULL || !loadValues(&state, values)){
+        return false;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    if(!propagate(&state) || searchState(&state, 1, NULL, stats) != 1){
+        return false;
+    }
+    memcpy(solution, state.values, NUMCELLS);
+    return true;
+}
+
+/**
+ * Solves the puzzle given as 81 cell values like solveValues, but runs the
+ * singles propagation pass at every node of the search rather than only
+ * before it. Each node costs more, but the search usually needs far fewer
+ * nodes on sparse or hard puzzles.
+ */
+bool solveValuesPropagate(const uint8_t *values, uint8_t *solution,
+                          SolverStats *stats)
+{
+    SolverState state;
+    SolverStats local;
+    if(solution == NULL || !loadValues(&state, values)){
+        return false;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    UnitView view = stateView(&state);
+    if(searchUnits(gridUnits(), &view, NULL, NULL, 1, stats) != 1){
+        return false;
+    }
+    memcpy(solution, state.values, NUMCELLS);
+    return true;
+}
+
+/**
+ * Runs the singles propagation pass on the puzzle given as 81 cell values
+ * and writes the resulting values to `result`. Returns the number of cells
+ * the pass filled, or -1 if either array is NULL, the values are not legal
+ * or the pass showed that the puzzle has no solution.
+ */
+int propagateValues(const uint8_t *values, uint8_t *result)
+{
+    SolverState state;
+    if(result == NULL || !loadValues(&state, values)){
+        return -1;
+    }
+    int before = 0;
+    for(int i = 0; i < NUMCELLS; i++){
+        before += state.values[i] == 0;
+    }
+    if(!propagate(&state)){
+        return -1;
+    }
+    int filled = before;
+    for(int i = 0; i < NUMCELLS; i++){
+        filled -= state.values[i] == 0;
+    }
+    memcpy(result, state.values, NUMCELLS);
+    return filled;
+}
+
+/**
+ * Returns true if `values` holds 81 values between 0 and 9 with no digit
+ * repeated in any row, column or square. Used to tell a puzzle that is not
+ * legal apart from one with no solution once solving has failed.
+ */
+bool checkValues(const uint8_t *values)
+{
+    SolverState state;
+    return loadValues(&state, values);
+}
+
+/**
+ * Reads a board in the 729 char candidate format into `cands`, one mask per
+ * cell (bit d-1 set if d is a candidate). The format gives each of the 81
+ * cells, row by row, as 9 chars where the k-th is the digit k if it is still
+ * a candidate and '0' or '.' if it was eliminated, so a solved cell or a
+ * clue is a cell with one candidate. Returns false if `text` is NULL, is not
+ * 729 chars long or holds a digit in the wrong place or anything else.
+ */
+bool parseCandidates(const char *text, uint16_t *cands)
+{
+    if(text == NULL || cands == NULL){
+        return false;
+    }
+    for(int i = 0; i < NUMCELLS; i++){
+        cands[i] = 0;
+        for(int k = 0; k < BOARDSIZE; k++){
+            char c = text[i * BOARDSIZE + k];
+            if(c == '1' + k){
+                cands[i] |= 1 << k;
+            }
+            else if(c != '0' && c != '.'){ //Also catches a short string
+                return false;
+            }
+        }
+    }
+    return text[NUMCELLS * BOARDSIZE] == '\0';
+}
+
+/**
+ * Solves the board given as a candidate mask per cell, as parseCandidates
+ * reads them, without going back to the values: the eliminations in the
+ * masks are kept, so a mid-game state is solved from where the player got
+ * to. Cells with one candidate are placed as clues. On success the solution
+ * is written to `solution` as 81 values and true is returned.
+ *
+ * This function will return false if either array is NULL, a cell has no
+ * candidates, two single candidates clash or the board has no solution
+ * (which includes a solution having been eliminated). If `stats` is not NULL
+ * the search statistics are written to it.
+ */
+bool solveCandidates(const uint16_t *cands, uint8_t *solution,
+                     SolverStats *stats)
+{
+    SolverState state;
+    SolverStats local;
+    if(solution == NULL || !loadCandidates(&state, cands)){
+        return false;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    if(!propagate(&state) || searchState(&state, 1, NULL, stats) != 1){
+        return false;
+    }
+    memcpy(solution, state.values, NUMCELLS);
+    return true;
+}
+
+/**
+ * Counts the solutions of the puzzle given by the string `clues` (same format
+ * as solveString). The search stops as soon as `limit` solutions have been
+ * found so countSolutions(clues, 2, NULL) == 1 is a uniqueness test.
+ *
+ * Returns -1 if the clues are malformed or not legal.
+ */
+long countSolutions(const char *clues, long limit, SolverStats *stats)
+{
+    return countSolutionsTT(clues, limit, NULL, stats);
+}
+
+/**
+ * Allocates an empty transposition table using at most `budget` bytes.
+ * Returns NULL if the budget is smaller than one entry or the memory could
+ * not be allocated.
+ */
+TransTable *initTransTable(size_t budget)
+{
+    size_t numEntries = 1;
+    while(numEntries * 2 * sizeof(TTEntry) <= budget){
+        numEntries *= 2;
+    }
+    if(numEntries * sizeof(TTEntry) > budget){
+        return NULL;
+    }
+    TransTable *table = malloc(sizeof(TransTable));
+    if(table == NULL){
+        return NULL;
+    }
+    table->entries = calloc(numEntries, sizeof(TTEntry));
+    if(table->entries == NULL){
+        free(table);
+        return NULL;
+    }
+    table->mask = numEntries - 1;
+    return table;
+}
+
+/**
+ * Counts solutions like countSolutions but remembers the count below every
+ * partial board whose subtree was fully searched (and took at least
+ * TT_MIN_NODES nodes) in `table`, so a partial board leaving the same problem
+ * as one already counted is not searched again. The table may be reused
+ * across calls and puzzles since entries only depend on the partial board. If
+ * `table` is NULL this is the same as countSolutions.
+ *
+ * Returns -1 if the clues are malformed or not legal.
+ */
+long countSolutionsTT(const char *clues, long limit, TransTable *table,
+                      SolverStats *stats)
+{
+    SolverState state;
+    SolverStats local;
+    if(!loadString(&state, clues)){
+        return -1;
+    }
+    if(stats == NULL){
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(SolverStats));
+    if(!propagate(&state)){
+        return 0;
+    }
+    return searchState(&state, limit, table, stats);
+}
+
+/**
+ * Frees a transposition table. If the given table is NULL this function does
+ * nothing.
+ */
+void deleteTransTable(TransTable *table)
+{
+    if(table == NULL){
+        return;
+    }
+    free(table->entries);
+    free(table);
+}
+
+/**
+ * Returns the unit graph of one 9x9 grid: the 81 cells row by row, with
+ * units 0 - 8 the rows, 9 - 17 the columns and 18 - 26 the squares.
+ */
+const UnitGraph *gridUnits(void)
+{
+    call_once(&gridOnce, initGrid);
+    return &grid;
+}
+
+/**
+ * Empties the graph, leaving `numCells` cells (at most UNIT_MAX_CELLS) in no
+ * unit.
+ */
+void initUnitGraph(UnitGraph *graph, int numCells)
+{
+    graph->numCells = numCells;
+    graph->numUnits = 0;
+    memset(graph->numUnitsOf, 0, numCells);
+}
+
+/**
+ * Adds a unit made of the `size` given cells (at most BOARDSIZE, no cell
+ * twice) to the graph and returns its index, which is the next one in turn.
+ * Returns -1 (and changes nothing) if the graph already has UNIT_MAX_UNITS
+ * units or one of the cells is already in UNIT_MAX_UNITS_OF of them.
+ */
+int addUnit(UnitGraph *graph, const int16_t *cells, int size)
+{
+    if(graph->numUnits == UNIT_MAX_UNITS){
+        return -1;
+    }
+    for(int k = 0; k < size; k++){
+        if(graph->numUnitsOf[cells[k]] == UNIT_MAX_UNITS_OF){
+            return -1;
+        }
+    }
+    int unit = graph->numUnits++;
+    graph->unitSize[unit] = size;
+    memcpy(graph->units[unit], cells, size * sizeof(int16_t));
+    for(int k = 0; k < size; k++){
+        int cell = cells[k];
+        graph->unitsOf[cell][graph->numUnitsOf[cell]++] = unit;
+    }
+    return unit;
+}
+
+/**
+ * Returns the digits that can still go in the given empty cell: those the
+ * cell allows that are missing from all of its units.
+ */
+uint16_t unitCandidates(const UnitGraph *graph, const UnitView *view,
+                        int cell)
+{
+    const int16_t *units = graph->unitsOf[cell];
+    const uint16_t *unitUsed = view->used;
+    int numUnits = graph->numUnitsOf[cell];
+    uint16_t used = 0;
+    for(int u = 0; u < numUnits; u++){
+        used |= unitUsed[units[u]];
+    }
+    uint16_t allowed = view->allowed != NULL ? view->allowed[cell] : ALLDIGITS;
+    return ~used & allowed;
+}
+
+/**
+ * Places `digit` in the given empty cell and marks it as used in all of the
+ * cell's units. Returns false (and changes nothing) if the digit is not a
+ * candidate of the cell.
+ */
+bool placeUnitDigit(const UnitGraph *graph, const UnitView *view, int cell,
+                    int digit)
+{
+    if(!(unitCandidates(graph, view, cell) & (1 << (digit - 1)))){
+        return false;
+    }
+    fillCell(graph, view, cell, digit);
+    return true;
+}
+
+/**
+ * Empties the given cell and clears its digit from all of the cell's units.
+ */
+void removeUnitDigit(const UnitGraph *graph, const UnitView *view, int cell)
+{
+    uint16_t bit = 1 << (view->values[cell] - 1);
+    const int16_t *units = graph->unitsOf[cell];
+    int numUnits = graph->numUnitsOf[cell];
+    for(int u = 0; u < numUnits; u++){
+        view->used[units[u]] &= ~bit;
+    }
+    view->values[cell] = 0;
+}
+
+/**
+ * Runs one round of the singles pass: fills every naked single (an empty
+ * cell with one candidate), then every hidden single (a digit with one place
+ * left in a unit), setting `progress` if it placed anything. Returns false
+ * as soon as the state shows it has no solution: an empty cell with no
+ * candidates, a unit with nowhere left for one of its missing digits, or two
+ * digits that can only go in the same cell. Only forced digits are placed so
+ * the solutions of the state are unchanged.
+ */
+bool singlesPass(const UnitGraph *graph, const UnitView *view,
+                 bool *progress)
+{
+    const uint8_t *values = view->values;
+    for(int i = 0; i < graph->numCells; i++){
+        if(values[i] != 0){
+            continue;
+        }
+        uint16_t cands = unitCandidates(graph, view, i);
+        if(cands == 0){
+            return false;
+        }
+        if((cands & (cands - 1)) == 0){
+            fillCell(graph, view, i, __builtin_ctz(cands) + 1);
+            *progress = true;
+        }
+    }
+
+    for(int unit = 0; unit < graph->numUnits; unit++){
+        const int16_t *cells = graph->units[unit];
+        int size = graph->unitSize[unit];
+        uint16_t once = 0;  //Digits with at least one place
+        uint16_t twice = 0; //Digits with at least two places
+        for(int k = 0; k < size; k++){
+            if(values[cells[k]] == 0){
+                uint16_t cands = unitCandidates(graph, view, cells[k]);
+                twice |= once & cands;
+                once |= cands;
+            }
+        }
+        if((once | view->used[unit]) != ALLDIGITS){
+            return false;
+        }
+        uint16_t singles = once & ~twice;
+        for(int k = 0; k < size && singles != 0; k++){
+            if(values[cells[k]] != 0){
+                continue;
+            }
+            uint16_t bit = unitCandidates(graph, view, cells[k]) & singles;
+            if((bit & (bit - 1)) != 0){
+                return false;
+            }
+            if(bit != 0){
+                fillCell(graph, view, cells[k], __builtin_ctz(bit) + 1);
+                singles &= ~bit;
+                *progress = true;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Runs singlesPass until it places nothing more. Returns false as soon as a
+ * round shows the state has no solution.
+ */
+bool propagateUnits(const UnitGraph *graph, const UnitView *view)
+{
+    bool progress = true;
+    while(progress){
+        progress = false;
+        if(!singlesPass(graph, view, &progress)){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the first empty cell with the fewest candidates and writes those
+ * candidates to `cands`, or returns -1 if there are no empty cells left. The
+ * scan stops early at a cell with `enough` candidates or fewer.
+ */
+int pickUnitCell(const UnitGraph *graph, const UnitView *view, int enough,
+                 uint16_t *cands)
+{
+    int best = -1;
+    int bestCount = BOARDSIZE + 1;
+    *cands = 0;
+    for(int i = 0; i < graph->numCells; i++){
+        if(view->values[i] != 0){
+            continue;
+        }
+        uint16_t cellCands = unitCandidates(graph, view, i);
+        int count = __builtin_popcount(cellCands);
+        if(count < bestCount){
+            best = i;
+            bestCount = count;
+            *cands = cellCands;
+            if(count <= enough){
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * Searches for solutions of the state in `view`, running `pass` (or
+ * propagateUnits if it is NULL) on every node and then branching on the
+ * empty cell with the fewest candidates. The pass must fill every cell left
+ * with one candidate. Each guess is made on a copy of the state. Returns the
+ * number of solutions found, never more than `limit`, and once `limit` is
+ * reached the state is left holding the last solution found.
+ */
+long searchUnits(const UnitGraph *graph, const UnitView *view, UnitPass *pass,
+                 const void *arg, long limit, SolverStats *stats)
+{
+    return searchNode(graph, view, pass, arg, 0, limit, stats);
+}
+
+/**
+ * Searches one node of searchUnits, `depth` guesses below the state it was
+ * given.
+ */
+static long searchNode(const UnitGraph *graph, const UnitView *view,
+                       UnitPass *pass, const void *arg, int depth, long limit,
+                       SolverStats *stats)
+{
+    bool alive = pass != NULL ? pass(graph, view, depth, arg) :
+                 propagateUnits(graph, view);
+    if(!alive){
+        return 0;
+    }
+    uint16_t cands;
+    //No cell is left with one candidate, so the first with two will do
+    int best = pickUnitCell(graph, view, 2, &cands);
+    if(best == -1){
+        return 1;
+    }
+    stats->nodes++;
+
+    uint8_t values[UNIT_MAX_CELLS];
+    uint16_t allowed[UNIT_MAX_CELLS];
+    uint16_t used[UNIT_MAX_UNITS];
+    UnitView next = {values, view->allowed != NULL ? allowed : NULL, used};
+    size_t cellBytes = graph->numCells * sizeof(uint16_t);
+    size_t unitBytes = graph->numUnits * sizeof(uint16_t);
+    long found = 0;
+    while(cands != 0){
+        memcpy(next.values, view->values, graph->numCells);
+        if(next.allowed != NULL){
+            memcpy(next.allowed, view->allowed, cellBytes);
+        }
+        memcpy(next.used, view->used, unitBytes);
+        int digit = __builtin_ctz(cands) + 1;
+        cands &= cands - 1;
+        stats->guesses++;
+        fillCell(graph, &next, best, digit);
+        found += searchNode(graph, &next, pass, arg, depth + 1,
+                            limit - found, stats);
+        if(found >= limit){
+            memcpy(view->values, next.values, graph->numCells);
+            if(next.allowed != NULL){
+                memcpy(view->allowed, next.allowed, cellBytes);
+            }
+            memcpy(view->used, next.used, unitBytes);
+            return found;
+        }
+    }
+    return found;
+}
+
+/**
+ * Loads a clue string into an empty solver state. Returns false if `clues`
+ * is NULL, is not 81 chars long, contains anything other than digits and '.'
+ * or if two clues conflict with each other.
+ */
+static bool loadString(SolverState *state, const char *clues)
+{
+    if(clues == NULL){
+        return false;
+    }
+    clearState(state);
+    for(int i = 0; i < NUMCELLS; i++){
+        char c = clues[i];
+        if(c == '.' || c == '0'){
+            continue;
+        }
+        if(c < '1' || c > '9'){ //Also catches a string that ends too early
+            return false;
+        }
+        if(!placeDigit(state, i, c - '0')){
+            return false;
+        }
+    }
+    return clues[NUMCELLS] == '\0';
+}
+
+/**
+ * Loads the values on a board into an empty solver state. Returns false if
+ * the board is NULL or if any of its values conflict with each other.
+ */
+static bool loadBoard(SolverState *state, Cell **board)
+{
+    if(board == NULL){
+        return false;
+    }
+    clearState(state);
+    for(int i = 0; i < NUMCELLS; i++){
+        int val = getCell(ROWOF(i), COLOF(i), board)->value;
+        if(val == 0){
+            continue;
+        }
+        if(val < 0 || val > 9 || !placeDigit(state, i, val)){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Loads 81 cell values into an empty solver state. Returns false if `values`
+ * is NULL, holds anything above 9 or if any of the values conflict with each
+ * other.
+ */
+static bool loadValues(SolverState *state, const uint8_t *values)
+{
+    if(values == NULL){
+        return false;
+    }
+    clearState(state);
+    for(int i = 0; i < NUMCELLS; i++){
+        if(values[i] == 0){
+            continue;
+        }
+        if(values[i] > 9 || !placeDigit(state, i, values[i])){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Loads a candidate mask per cell into an empty solver state, placing the
+ * cells with one candidate and keeping the masks of the others as they are.
+ * Returns false if `cands` is NULL, a cell has no candidates or two of the
+ * placed digits conflict.
+ */
+static bool loadCandidates(SolverState *state, const uint16_t *cands)
+{
+    if(cands == NULL){
+        return false;
+    }
+    clearState(state);
+    for(int i = 0; i < NUMCELLS; i++){
+        uint16_t mask = cands[i] & ALLDIGITS;
+        if(mask == 0){
+            return false;
+        }
+        state->allowed[i] = mask;
+        if((mask & (mask - 1)) == 0 &&
+           !placeDigit(state, i, __builtin_ctz(mask) + 1)){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Empties the state, leaving every digit allowed in every cell.
+ */
+static void clearState(SolverState *state)
+{
+    call_once(&keysOnce, initKeys);
+    memset(state, 0, sizeof(SolverState));
+    for(int i = 0; i < NUMCELLS; i++){
+        state->allowed[i] = ALLDIGITS;
+    }
+}
+
+/**
+ * Places `digit` in the given empty cell and marks it as used in the cell's
+ * row, column, and square. Returns false (and changes nothing) if the digit
+ * is already used in any of them.
+ */
+static bool placeDigit(SolverState *state, int cell, int digit)
+{
+    uint16_t bit = 1 << (digit - 1);
+    uint16_t *row = &state->used[ROWOF(cell)];
+    uint16_t *col = &state->used[BOARDSIZE + COLOF(cell)];
+    uint16_t *box = &state->used[2 * BOARDSIZE + BOXOF(cell)];
+    if((*row | *col | *box) & bit){
+        return false;
+    }
+    state->values[cell] = digit;
+    state->hash ^= placementKey(cell, digit);
+    *row |= bit;
+    *col |= bit;
+    *box |= bit;
+    return true;
+}
+
+/**
+ * Empties the given cell and clears its digit from the cell's row, column, and
+ * square masks.
+ */
+static void removeDigit(SolverState *state, int cell)
+{
+    uint16_t bit = 1 << (state->values[cell] - 1);
+    state->hash ^= placementKey(cell, state->values[cell]);
+    state->used[ROWOF(cell)] &= ~bit;
+    state->used[BOARDSIZE + COLOF(cell)] &= ~bit;
+    state->used[2 * BOARDSIZE + BOXOF(cell)] &= ~bit;
+    state->values[cell] = 0;
+}
+
+/**
+ * Returns the view the unit functions work on of the given state.
+ */
+static UnitView stateView(SolverState *state)
+{
+    UnitView view = {state->values, state->allowed, state->used};
+    return view;
+}
+
+/**
+ * Runs the singles pass (propagateUnits) on the state and works the hash out
+ * again for the digits it placed. Returns false if the pass showed the state
+ * has no solution.
+ */
+static bool propagate(SolverState *state)
+{
+    UnitView view = stateView(state);
+    if(!propagateUnits(gridUnits(), &view)){
+        return false;
+    }
+    state->hash = 0;
+    for(int i = 0; i < NUMCELLS; i++){
+        if(state->values[i] != 0){
+            state->hash ^= placementKey(i, state->values[i]);
+        }
+    }
+    return true;
+}
+
+/**
+ * Places `digit` in the given empty cell and marks it as used in all of the
+ * cell's units, without checking it is a candidate (placeUnitDigit does).
+ */
+static void fillCell(const UnitGraph *graph, const UnitView *view, int cell,
+                     int digit)
+{
+    uint16_t bit = 1 << (digit - 1);
+    const int16_t *units = graph->unitsOf[cell];
+    int numUnits = graph->numUnitsOf[cell];
+    view->values[cell] = digit;
+    for(int u = 0; u < numUnits; u++){
+        view->used[units[u]] |= bit;
+    }
+}
+
+/**
+ * Fills the unit graph of one grid, with the rows, columns and squares as
+ * the units 0 - 8, 9 - 17 and 18 - 26.
+ */
+static void initGrid(void)
+{
+    initUnitGraph(&grid, NUMCELLS);
+    for(int unit = 0; unit < 3 * BOARDSIZE; unit++){
+        int16_t cells[BOARDSIZE];
+        int n = unit % BOARDSIZE;
+        for(int k = 0; k < BOARDSIZE; k++){
+            if(unit < BOARDSIZE){
+                cells[k] = n * BOARDSIZE + k;
+            }
+            else if(unit < 2 * BOARDSIZE){
+                cells[k] = k * BOARDSIZE + n;
+            }
+            else{
+                cells[k] = ((n / 3) * 3 + k / 3) * BOARDSIZE +
+                           (n % 3) * 3 + k % 3;
+            }
+        }
+        addUnit(&grid, cells, BOARDSIZE);
+    }
+}
+
+/**
+ * Fills the key tables used for the state's hash. The keys come from a fixed
+ * seed (splitmix64) so hashes, and with them a transposition table, are the
+ * same from run to run.
+ */
+static void initKeys(void)
+{
+    uint64_t *tables[] = {filledKeys, rowKeys, colKeys, boxKeys};
+    uint64_t x = 0x5344554B4F4B4559ULL;
+    for(int t = 0; t < 4; t++){
+        for(int i = 0; i < NUMCELLS; i++){
+            uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            tables[t][i] = z ^ (z >> 31);
+        }
+    }
+}
+
+/**
+ * Returns what the state's hash is XORed with when `digit` is placed in or
+ * removed from `cell`.
+ */
+static uint64_t placementKey(int cell, int digit)
+{
+    return filledKeys[cell] ^ rowKeys[UNITKEY(ROWOF(cell), digit)] ^
+           colKeys[UNITKEY(COLOF(cell), digit)] ^
+           boxKeys[UNITKEY(BOXOF(cell), digit)];
+}
+
+/**
+ * Searches for solutions of the given state, always branching on the empty
+ * cell with the fewest candidates. Returns the number of solutions found
+ * which is never more than `limit`. Once `limit` is reached the state is left
+ * holding the last solution found so that callers asking for a single
+ * solution can read it straight out of the state (this does not hold when
+ * the count came from `table`, so solving never passes a table).
+ *
+ * If `table` is not NULL it is checked for the count below this state before
+ * searching, and the count is stored in it afterwards if the whole subtree
+ * was searched. A count cut short by `limit` is never stored.
+ */
+static long searchState(SolverState *state, long limit, TransTable *table,
+                        SolverStats *stats)
+{
+    TTEntry *entry = NULL;
+    if(table != NULL && state->hash != 0){ //0 marks an unused entry
+        entry = &table->entries[state->hash & table->mask];
+        if(entry->hash == state->hash){
+            stats->ttHits++;
+            return entry->count < limit ? entry->count : limit;
+        }
+    }
+
+    uint16_t bestCands;
+    UnitView view = stateView(state);
+    int best = pickUnitCell(gridUnits(), &view, 1, &bestCands);
+    if(best == -1){ //No empty cells left so this is a solution
+        return 1;
+    }
+    stats->nodes++;
+    unsigned long startNodes = stats->nodes;
+
+    long found = 0;
+    while(bestCands != 0){
+        int digit = __builtin_ctz(bestCands) + 1;
+        bestCands &= bestCands - 1;
+        stats->guesses++;
+        placeDigit(state, best, digit);
+        found += searchState(state, limit - found, table, stats);
+        if(found >= limit){
+            return found;
+        }
+        removeDigit(state, best);
+    }
+    if(entry != NULL && stats->nodes - startNodes >= TT_MIN_NODES){
+        entry->hash = state->hash;
+        entry->count = found;
+    }
+    return found;
+}
@@ -0,0 +1,322 @@
+/**
+ * Author:  Sebastian Turner
+ * Date: 10/18/26
+ *
+ * Implements a backtracking sudoku solver on top of the sudokuBoard module.
+ * Internally the solver does not work on the 'Cell' grid directly. Instead a
+ * puzzle is loaded into a compact state made of the 81 cell values plus one
+ * bitmask per row, column and square recording which digits are already
+ * placed (bit d-1 is set if digit d is used). The candidates of an empty cell
+ * are then simply the digits missing from all three of its masks.
+ *
+ * The search always branches on the empty cell with the fewest candidates so
+ * cells that are forced (only one candidate) are filled without any guessing.
+ *
+ * Puzzles may be given either as a board from initSetBoard or as a string of
+ * length 81 where '0' or '.' represents an empty cell. A mid-game state with
+ * candidates already eliminated can also be given in the 729 char candidate
+ * format (see parseCandidates). Its masks are then kept in the state as the
+ * digits each cell still allows and the candidates of a cell are those
+ * allowed digits missing from its three masks, so the eliminations are not
+ * lost by going back to the values and worked out again.
+ *
+ * When counting solutions of sparse puzzles, different guesses often leave
+ * the same problem to solve: the same empty cells with the same digits
+ * missing from each row, column and square. countSolutionsTT can be given a
+ * transposition table that remembers the number of solutions below each
+ * partial board it has fully searched, keyed by a Zobrist hash of that
+ * remaining problem, so each one is counted once.
+ *
+ * The singles pass and the choice of the cell to branch on only need to know
+ * which cells make up each unit and which units each cell is in, so they are
+ * written once over a UnitGraph holding those two lists and shared by every
+ * solver built on this one: the 27 units of one grid here and in the killer
+ * solver, and the units of several overlapping grids in the multi-grid
+ * solver. The search state a solver keeps is handed to them as a UnitView of
+ * its cell values, the digits each cell still allows and the digits used in
+ * each unit, so each solver keeps its state as small as its own puzzles
+ * allow.
+ */
+#ifndef SUDOKU_SOLVER_H
+#define SUDOKU_SOLVER_H
+
+#include <stdint.h>
+#include "./sudokuBoard.h"
+
+#define NUMCELLS 81      //BOARDSIZE * BOARDSIZE
+#define ALLDIGITS 0x1FF  //bitmask with a bit set for each of the digits 1 - 9
+
+#define TT_MIN_NODES 8 //Smallest subtree (in nodes) worth remembering
+
+#define UNIT_MAX_GRIDS 8 //Most 9x9 grids a unit graph can cover
+#define UNIT_MAX_CELLS (UNIT_MAX_GRIDS * NUMCELLS)
+#define UNIT_MAX_UNITS (UNIT_MAX_GRIDS * 3 * BOARDSIZE)
+#define UNIT_MAX_UNITS_OF (UNIT_MAX_GRIDS * 3) //Most units one cell can be in
+
+typedef struct solverStats{
+    unsigned long nodes;   //The number of cells branched on during the search
+    unsigned long guesses; //The number of values tried in those cells
+    unsigned long ttHits;  //Subtrees whose count came from the table
+}SolverStats;
+
+typedef struct ttEntry{
+    uint64_t hash; //Hash of the remaining problem, 0 if unused
+    long count;    //Number of solutions below that board
+}TTEntry;
+
+typedef struct transTable{
+    TTEntry *entries;
+    size_t mask; //Number of entries - 1 (always a power of two)
+}TransTable;
+
+typedef struct unitGraph{
+    int numCells;
+    int numUnits;
+    uint8_t unitSize[UNIT_MAX_UNITS];                   //Cells in each unit
+    int16_t units[UNIT_MAX_UNITS][BOARDSIZE];           //Cells of each unit
+    uint8_t numUnitsOf[UNIT_MAX_CELLS];
+    int16_t unitsOf[UNIT_MAX_CELLS][UNIT_MAX_UNITS_OF]; //Units of each cell
+}UnitGraph;
+
+typedef struct unitView{
+    uint8_t *values;   //Value of each cell, 0 if it is empty
+    uint16_t *allowed; //Digits not eliminated from each cell, NULL if every
+                       //cell still allows every digit
+    uint16_t *used;    //Digits placed in each unit
+}UnitView;
+
+//A propagation pass run on every node of searchUnits, given the number of
+//guesses on the path to the node and the search's `arg`
+typedef bool UnitPass(const UnitGraph *graph, const UnitView *view,
+                      int depth, const void *arg);
+
+/********* function prototypes *********/
+
+bool solveBoard(Cell **board, SolverStats *stats);
+bool solveString(const char *clues, char *solution, SolverStats *stats);
+bool solveValues(const uint8_t *values, uint8_t *solution, SolverStats *stats);
+bool solveValuesPropagate(const uint8_t *values, uint8_t *solution,
+                          SolverStats *stats);
+int propagateValues(const uint8_t *values, uint8_t *result);
+bool checkValues(const uint8_t *values);
+bool parseCandidates(const char *text, uint16_t *cands);
+bool solveCandidates(const uint16_t *cands, uint8_t *solution,
+                     SolverStats *stats);
+long countSolutions(const char *clues, long limit, SolverStats *stats);
+TransTable *initTransTable(size_t budget);
+long countSolutionsTT(const char *clues, long limit, TransTable *table,
+                      SolverStats *stats);
+void deleteTransTable(TransTable *table);
+const UnitGraph *gridUnits(void);
+void initUnitGraph(UnitGraph *graph, int numCells);
+int addUnit(UnitGraph *graph, const int16_t *cells, int size);
+uint16_t unitCandidates(const UnitGraph *graph, const UnitView *view,
+                        int cell);
+bool placeUnitDigit(const UnitGraph *graph, const UnitView *view, int cell,
+                    int digit);
+void removeUnitDigit(const UnitGraph *graph, const UnitView *view, int cell);
+bool singlesPass(const UnitGraph *graph, const UnitView *view,
+                 bool *progress);
+bool propagateUnits(const UnitGraph *graph, const UnitView *view);
+int pickUnitCell(const UnitGraph *graph, const UnitView *view, int enough,
+                 uint16_t *cands);
+long searchUnits(const UnitGraph *graph, const UnitView *view, UnitPass *pass,
+                 const void *arg, long limit, SolverStats *stats);
+
+/**
+ * Solves the given board in place. Every cell that is not a clue is filled
+ * using setCellVal. Returns true if a solution was found.
+ *
+ * This function will return false (and leave the board untouched) if the
+ * board is NULL, if the values on the board are not legal or if the puzzle
+ * has no solution. If `stats` is not NULL the search statistics are written
+ * to it.
+ */
+bool solveBoard(Cell **board, SolverStats *stats);
+
+/**
+ * Solves the puzzle given by the string `clues`. This string must be 81
+ * characters long where each character is a digit and '0' or '.' represents
+ * an empty cell. On success the solution is written to `solution` as 81
+ * digits followed by a null terminator (so `solution` must be able to hold
+ * 82 chars) and true is returned.
+ *
+ * This function will return false if either string is NULL, the clues are
+ * malformed or not legal, or if the puzzle has no solution. If `stats` is
+ * not NULL the search statistics are written to it.
+ */
+bool solveString(const char *clues, char *solution, SolverStats *stats);
+
+/**
+ * Solves the puzzle given as 81 cell values (0 for an empty cell), the form
+ * the batch parser produces. On success the solution is written to
+ * `solution` as 81 values and true is returned.
+ *
+ * This function will return false if either array is NULL, the values are
+ * not legal, or if the puzzle has no solution. If `stats` is not NULL the
+ * search statistics are written to it.
+ */
+bool solveValues(const uint8_t *values, uint8_t *solution, SolverStats *stats);
+
+/**
+ * Solves the puzzle given as 81 cell values like solveValues, but runs the
+ * singles propagation pass at every node of the search rather than only
+ * before it. Each node costs more, but the search usually needs far fewer
+ * nodes on sparse or hard puzzles.
+ */
+bool solveValuesPropagate(const uint8_t *values, uint8_t *solution,
+                          SolverStats *stats);
+
+/**
+ * Runs the singles propagation pass on the puzzle given as 81 cell values
+ * and writes the resulting values to `result`. Returns the number of cells
+ * the pass filled, or -1 if either array is NULL, the values are not legal
+ * or the pass showed that the puzzle has no solution.
+ */
+int propagateValues(const uint8_t *values, uint8_t *result);
+
+/**
+ * Returns true if `values` holds 81 values between 0 and 9 with no digit
+ * repeated in any row, column or square. Used to tell a puzzle that is not
+ * legal apart from one with no solution once solving has failed.
+ */
+bool checkValues(const uint8_t *values);
+
+/**
+ * Reads a board in the 729 char candidate format into `cands`, one mask per
+ * cell (bit d-1 set if d is a candidate). The format gives each of the 81
+ * cells, row by row, as 9 chars where the k-th is the digit k if it is still
+ * a candidate and '0' or '.' if it was eliminated, so a solved cell or a
+ * clue is a cell with one candidate. Returns false if `text` is NULL, is not
+ * 729 chars long or holds a digit in the wrong place or anything else.
+ */
+bool parseCandidates(const char *text, uint16_t *cands);
+
+/**
+ * Solves the board given as a candidate mask per cell, as parseCandidates
+ * reads them, without going back to the values: the eliminations in the
+ * masks are kept, so a mid-game state is solved from where the player got
+ * to. Cells with one candidate are placed as clues. On success the solution
+ * is written to `solution` as 81 values and true is returned.
+ *
+ * This function will return false if either array is NULL, a cell has no
+ * candidates, two single candidates clash or the board has no solution
+ * (which includes a solution having been eliminated). If `stats` is not NULL
+ * the search statistics are written to it.
+ */
+bool solveCandidates(const uint16_t *cands, uint8_t *solution,
+                     SolverStats *stats);
+
+/**
+ * Counts the solutions of the puzzle given by the string `clues` (same format
+ * as solveString). The search stops as soon as `limit` solutions have been
+ * found so countSolutions(clues, 2, NULL) == 1 is a uniqueness test.
+ *
+ * Returns -1 if the clues are malformed or not legal.
+ */
+long countSolutions(const char *clues, long limit, SolverStats *stats);
+
+/**
+ * Allocates an empty transposition table using at most `budget` bytes.
+ * Returns NULL if the budget is smaller than one entry or the memory could
+ * not be allocated.
+ */
+TransTable *initTransTable(size_t budget);
+
+/**
+ * Counts solutions like countSolutions but remembers the count below every
+ * partial board whose subtree was fully searched (and took at least
+ * TT_MIN_NODES nodes) in `table`, so a partial board leaving the same problem
+ * as one already counted is not searched again. The table may be reused
+ * across calls and puzzles since entries only depend on the partial board. If
+ * `table` is NULL this is the same as countSolutions.
+ *
+ * Returns -1 if the clues are malformed or not legal.
+ */
+long countSolutionsTT(const char *clues, long limit, TransTable *table,
+                      SolverStats *stats);
+
+/**
+ * Frees a transposition table. If the given table is NULL this function does
+ * nothing.
+ */
+void deleteTransTable(TransTable *table);
+
+/**
+ * Returns the unit graph of one 9x9 grid: the 81 cells row by row, with
+ * units 0 - 8 the rows, 9 - 17 the columns and 18 - 26 the squares.
+ */
+const UnitGraph *gridUnits(void);
+
+/**
+ * Empties the graph, leaving `numCells` cells (at most UNIT_MAX_CELLS) in no
+ * unit.
+ */
+void initUnitGraph(UnitGraph *graph, int numCells);
+
+/**
+ * Adds a unit made of the `size` given cells (at most BOARDSIZE, no cell
+ * twice) to the graph and returns its index, which is the next one in turn.
+ * Returns -1 (and changes nothing) if the graph already has UNIT_MAX_UNITS
+ * units or one of the cells is already in UNIT_MAX_UNITS_OF of them.
+ */
+int addUnit(UnitGraph *graph, const int16_t *cells, int size);
+
+/**
+ * Returns the digits that can still go in the given empty cell: those the
+ * cell allows that are missing from all of its units.
+ */
+uint16_t unitCandidates(const UnitGraph *graph, const UnitView *view,
+                        int cell);
+
+/**
+ * Places `digit` in the given empty cell and marks it as used in all of the
+ * cell's units. Returns false (and changes nothing) if the digit is not a
+ * candidate of the cell.
+ */
+bool placeUnitDigit(const UnitGraph *graph, const UnitView *view, int cell,
+                    int digit);
+
+/**
+ * Empties the given cell and clears its digit from all of the cell's units.
+ */
+void removeUnitDigit(const UnitGraph *graph, const UnitView *view, int cell);
+
+/**
+ * Runs one round of the singles pass: fills every naked single (an empty
+ * cell with one candidate), then every hidden single (a digit with one place
+ * left in a unit), setting `progress` if it placed anything. Returns false
+ * as soon as the state shows it has no solution: an empty cell with no
+ * candidates, a unit with nowhere left for one of its missing digits, or two
+ * digits that can only go in the same cell. Only forced digits are placed so
+ * the solutions of the state are unchanged.
+ */
+bool singlesPass(const UnitGraph *graph, const UnitView *view,
+                 bool *progress);
+
+/**
+ * Runs singlesPass until it places nothing more. Returns false as soon as a
+ * round shows the state has no solution.
+ */
+bool propagateUnits(const UnitGraph *graph, const UnitView *view);
+
+/**
+ * Returns the first empty cell with the fewest candidates and writes those
+ * candidates to `cands`, or returns -1 if there are no empty cells left. The
+ * scan stops early at a cell with `enough` candidates or fewer.
+ */
+int pickUnitCell(const UnitGraph *graph, const UnitView *view, int enough,
+                 uint16_t *cands);
+
+/**
+ * Searches for solutions of the state in `view`, running `pass` (or
+ * propagateUnits if it is NULL) on every node and then branching on the
+ * empty cell with the fewest candidates. The pass must fill every cell left
+ * with one candidate. Each guess is made on a copy of the state. Returns the
+ * number of solutions found, never more than `limit`, and once `limit` is
+ * reached the state is left holding the last solution found.
+ */
+long searchUnits(const UnitGraph *graph, const UnitView *view, UnitPass *pass,
+                 const void *arg, long limit, SolverStats *stats);
+
+#endif
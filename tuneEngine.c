@@ -0,0 +1,196 @@
+/**
+ * Measures the engines on this machine and writes the routing thresholds
+ * that would have solved a file of puzzles fastest to a config file, which
+ * batchSolve and solveServer load at startup (see sudokuEngine.h).
+ *
+ * Every puzzle is run through the propagation pass once and then solved from
+ * the propagated values with both ENGINE_BACKTRACK and ENGINE_PROPAGATE,
+ * keeping the fastest of `repeats` runs of each. Since routing only decides
+ * which of the two times a puzzle costs, the time of ENGINE_AUTO under any
+ * tuning follows from these measurements without solving anything again.
+ * The puzzles are binned by clues, empty cells and density (in steps of
+ * DENSITY_STEPS) and the bins summed up so that the time saved by any tuning
+ * is two lookups, which makes it cheap to try every tuning on the grid
+ * rather than guess at a few. The propagation pass costs every tuning the
+ * same and is left out.
+ *
+ * Usage: ./tuneEngine [-r repeats] [config] < puzzles.txt
+ *
+ * The config defaults to ENGINE_CONFIG and repeats to DEFAULT_REPEATS.
+ * Malformed and unsolvable puzzles, and those the pass solves on its own, are
+ * skipped. Exit statuses are as follows
+ * 1 - Improper arguments
+ * 2 - The batch buffers could not be allocated or the puzzles read
+ * 3 - The config could not be written
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include "./batchIo.h"
+#include "./sudokuEngine.h"
+
+#define DEFAULT_REPEATS 3
+#define DENSITY_STEPS 4 //Density thresholds tried per candidate
+#define DENSITY_BINS (BOARDSIZE * DENSITY_STEPS + 1)
+
+//function prototypes
+static double timeEngine(const uint8_t *values, Engine engine, int repeats);
+static void sumBins(void);
+
+//saved[c][e][d] is the time saved by propagating every puzzle measured with
+//at most c clues, at least e empty cells and a density below d / DENSITY_STEPS
+static double saved[NUMCELLS + 1][NUMCELLS + 1][DENSITY_BINS + 1];
+
+int main(const int argc, const char *argv[])
+{
+    int repeats = DEFAULT_REPEATS;
+    int first = 1;
+    if(argc >= 3 && strcmp(argv[1], "-r") == 0){
+        char *end;
+        long value = strtol(argv[2], &end, 10);
+        if(*end != '\0' || value < 1 || value > 1000){
+            fprintf(stderr, "The repeats must be a number from 1 to 1000\n");
+            exit(1);
+        }
+        repeats = value;
+        first = 3;
+    }
+    if(argc > first + 1){
+        fprintf(stderr, "usage: %s [-r repeats] [config] < puzzles\n",
+                argv[0]);
+        exit(1);
+    }
+    const char *config = argc > first ? argv[first] : ENGINE_CONFIG;
+
+    BatchReader *reader = initBatchReader(stdin);
+    if(reader == NULL){
+        fprintf(stderr, "Unable to allocate the batch buffers\n");
+        exit(2);
+    }
+
+    double backtrack = 0; //Total time of each engine, in seconds
+    double propagate = 0;
+    double automatic = 0; //Under the default tuning
+    int measured = 0;
+    const uint8_t *boards;
+    const bool *malformed;
+    size_t count;
+    while((count = readBatch(reader, &boards, &malformed)) > 0){
+        for(size_t i = 0; i < count; i++){
+            PuzzleFeatures features;
+            uint8_t propagated[NUMCELLS];
+            if(malformed[i] ||
+               !puzzleFeatures(boards + i * NUMCELLS, &features, propagated) ||
+               features.empty == 0){
+                continue;
+            }
+            double back = timeEngine(propagated, ENGINE_BACKTRACK, repeats);
+            double prop = timeEngine(propagated, ENGINE_PROPAGATE, repeats);
+            if(back < 0 || prop < 0){
+                continue;
+            }
+            //Exact, since multiplying by a power of two does not round
+            int bin = features.density * DENSITY_STEPS;
+            saved[features.clues][features.empty][bin + 1] += back - prop;
+            backtrack += back;
+            propagate += prop;
+            automatic += chooseEngine(&features) == ENGINE_PROPAGATE ?
+                         prop : back;
+            measured++;
+        }
+    }
+    deleteBatchReader(reader);
+    if(ferror(stdin)){
+        fprintf(stderr, "Unable to read the puzzles\n");
+        exit(2);
+    }
+    sumBins();
+
+    //Start from routing nothing to ENGINE_PROPAGATE and take any tuning on
+    //the grid that saves more
+    EngineTuning best = {0, 0, 0, 0};
+    double bestSaved = 0;
+    for(int c = 0; c <= NUMCELLS; c++){
+        for(int e = 0; e <= NUMCELLS; e++){
+            for(int lo = 0; lo <= DENSITY_BINS; lo++){
+                for(int hi = lo; hi <= DENSITY_BINS; hi++){
+                    double gain = saved[c][e][hi] - saved[c][e][lo];
+                    if(gain > bestSaved){
+                        bestSaved = gain;
+                        best.maxClues = c;
+                        best.minEmpty = e;
+                        best.minDensity = (double)lo / DENSITY_STEPS;
+                        best.maxDensity = (double)hi / DENSITY_STEPS;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%d puzzles measured, %d runs each\n", measured, repeats);
+    printf("backtrack  %10.3f ms\n", backtrack * 1e3);
+    printf("propagate  %10.3f ms\n", propagate * 1e3);
+    printf("auto       %10.3f ms (built in tuning)\n", automatic * 1e3);
+    printf("auto       %10.3f ms (tuned)\n", (backtrack - bestSaved) * 1e3);
+    printf("maxClues %d minEmpty %d minDensity %g maxDensity %g\n",
+           best.maxClues, best.minEmpty, best.minDensity, best.maxDensity);
+    if(!setEngineTuning(&best) || !saveEngineTuning(config)){
+        exit(3);
+    }
+    return 0;
+}
+
+/**
+ * Returns the fastest of `repeats` solves of the puzzle with the given
+ * engine in seconds, or -1 if the engine finds no solution.
+ */
+static double timeEngine(const uint8_t *values, Engine engine, int repeats)
+{
+    uint8_t solution[NUMCELLS];
+    double fastest = -1;
+    for(int i = 0; i < repeats; i++){
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool solved = solveWith(values, solution, engine, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if(!solved){
+            return -1;
+        }
+        double time = (end.tv_sec - start.tv_sec) +
+                      (end.tv_nsec - start.tv_nsec) / 1e9;
+        if(fastest < 0 || time < fastest){
+            fastest = time;
+        }
+    }
+    return fastest;
+}
+
+/**
+ * Turns the per bin savings into the running sums described at `saved`. Bin
+ * d + 1 of each row holds the puzzles whose density rounds down to
+ * d / DENSITY_STEPS, so summing along the density leaves index d holding
+ * those below d / DENSITY_STEPS.
+ */
+static void sumBins(void)
+{
+    for(int c = 0; c <= NUMCELLS; c++){
+        for(int e = 0; e <= NUMCELLS; e++){
+            for(int d = 1; d <= DENSITY_BINS; d++){
+                saved[c][e][d] += saved[c][e][d - 1];
+            }
+        }
+    }
+    for(int c = 1; c <= NUMCELLS; c++){
+        for(int e = 0; e <= NUMCELLS; e++){
+            for(int d = 0; d <= DENSITY_BINS; d++){
+                saved[c][e][d] += saved[c - 1][e][d];
+            }
+        }
+    }
+    for(int c = 0; c <= NUMCELLS; c++){
+        for(int e = NUMCELLS - 1; e >= 0; e--){
+            for(int d = 0; d <= DENSITY_BINS; d++){
+                saved[c][e][d] += saved[c][e + 1][d];
+            }
+        }
+    }
+}